@@ -0,0 +1,79 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/arithmetic.hpp>
+#include <dynd/array.hpp>
+#include <dynd/functional.hpp>
+#include <dynd/kernels/arithmetic.hpp>
+#include <dynd/kernels/simd_arithmetic.hpp>
+
+using namespace std;
+using namespace dynd;
+
+// nd::add, which runs the contiguous loops of get_simd_binary
+template <typename T>
+static void BM_Func_Arithmetic_SIMDAdd(benchmark::State &state) {
+  nd::array a = nd::empty(state.range_x(), ndt::make_type<T>());
+  nd::array b = nd::empty(state.range_x(), ndt::make_type<T>());
+  nd::array c = nd::empty(state.range_x(), ndt::make_type<T>());
+  a.vals() = 3;
+  b.vals() = 5;
+
+  state.SetLabel(dynd::detail::get_simd_isa());
+  while (state.KeepRunning()) {
+    nd::add({a, b}, {{"dst", c}});
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK_TEMPLATE(BM_Func_Arithmetic_SIMDAdd, int32_t)->Range(64, 1 << 20);
+BENCHMARK_TEMPLATE(BM_Func_Arithmetic_SIMDAdd, int64_t)->Range(64, 1 << 20);
+BENCHMARK_TEMPLATE(BM_Func_Arithmetic_SIMDAdd, float)->Range(64, 1 << 20);
+BENCHMARK_TEMPLATE(BM_Func_Arithmetic_SIMDAdd, double)->Range(64, 1 << 20);
+
+// The same operation through the generic strided loop, one single() per element
+template <typename T>
+static void BM_Func_Arithmetic_StridedAdd(benchmark::State &state) {
+  nd::callable add = nd::functional::elwise(
+      nd::functional::apply<decltype(&dynd::detail::inline_add<T, T>::f), &dynd::detail::inline_add<T, T>::f>());
+
+  nd::array a = nd::empty(state.range_x(), ndt::make_type<T>());
+  nd::array b = nd::empty(state.range_x(), ndt::make_type<T>());
+  nd::array c = nd::empty(state.range_x(), ndt::make_type<T>());
+  a.vals() = 3;
+  b.vals() = 5;
+
+  while (state.KeepRunning()) {
+    add({a, b}, {{"dst", c}});
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK_TEMPLATE(BM_Func_Arithmetic_StridedAdd, int32_t)->Range(64, 1 << 20);
+BENCHMARK_TEMPLATE(BM_Func_Arithmetic_StridedAdd, int64_t)->Range(64, 1 << 20);
+BENCHMARK_TEMPLATE(BM_Func_Arithmetic_StridedAdd, float)->Range(64, 1 << 20);
+BENCHMARK_TEMPLATE(BM_Func_Arithmetic_StridedAdd, double)->Range(64, 1 << 20);
+
+// A broadcast scalar on the right, as in ``a * 2``
+template <typename T>
+static void BM_Func_Arithmetic_SIMDMultiplyScalar(benchmark::State &state) {
+  nd::array a = nd::empty(state.range_x(), ndt::make_type<T>());
+  nd::array c = nd::empty(state.range_x(), ndt::make_type<T>());
+  nd::array b = static_cast<T>(2);
+  a.vals() = 3;
+
+  state.SetLabel(dynd::detail::get_simd_isa());
+  while (state.KeepRunning()) {
+    nd::multiply({a, b}, {{"dst", c}});
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK_TEMPLATE(BM_Func_Arithmetic_SIMDMultiplyScalar, int32_t)->Range(64, 1 << 20);
+BENCHMARK_TEMPLATE(BM_Func_Arithmetic_SIMDMultiplyScalar, int64_t)->Range(64, 1 << 20);
+BENCHMARK_TEMPLATE(BM_Func_Arithmetic_SIMDMultiplyScalar, float)->Range(64, 1 << 20);
+BENCHMARK_TEMPLATE(BM_Func_Arithmetic_SIMDMultiplyScalar, double)->Range(64, 1 << 20);
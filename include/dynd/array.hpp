@@ -11,6 +11,7 @@
 
 #include <dynd/buffer.hpp>
 #include <dynd/irange.hpp>
+#include <dynd/memblock/memmap_mode.hpp>
 #include <dynd/types/bytes_type.hpp>
 #include <dynd/types/fixed_dim_type.hpp>
 #include <dynd/types/pointer_type.hpp>
@@ -740,7 +741,7 @@ namespace nd {
   }
 
   /**
-   * Memory-maps a file with dynd type 'bytes'.
+   * Memory-maps a file as a one-dimensional array of type uint8.
    *
    * \param filename  The name of the file to memory map.
    * \param begin  If provided, the start of where to memory map. Uses
@@ -752,6 +753,24 @@ namespace nd {
   DYND_API array memmap(const std::string &filename, intptr_t begin = 0,
                         intptr_t end = std::numeric_limits<intptr_t>::max(), uint32_t access = default_access_flags);
 
+  /**
+   * Memory-maps a file as an array of type ``tp``, which references the
+   * mapped memory directly. The data of the file, from ``offset`` on, must
+   * have the default layout of ``tp``.
+   *
+   * \param filename  The name of the file to memory map.
+   * \param tp  A type of plain data, like a fixed dimension of a struct. If
+   *            its outermost dimension is ``Fixed``, it takes as many elements
+   *            as fit in the rest of the file.
+   * \param offset  The position of the data within the file, which must be
+   *                aligned for ``tp``.
+   * \param mode  Whether the array is read-only, writes to the file, or
+   *              writes to private copies of its pages.
+   * \param advice  How the elements will be accessed.
+   */
+  DYND_API array memmap(const std::string &filename, const ndt::type &tp, intptr_t offset = 0,
+                        memmap_mode_t mode = memmap_readonly, memmap_advice_t advice = memmap_advice_normal);
+
   /**
    * Creates a ctuple nd::array with the given field names and
    * pointers to the provided field values.
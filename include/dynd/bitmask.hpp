@@ -0,0 +1,181 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <vector>
+
+#include <dynd/array.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * A packed vector of booleans, with bit ``i % 64`` of word ``i / 64`` for
+   * element ``i``. The bits of the last word past the last element are always
+   * clear, so that whole words can be combined and counted directly.
+   *
+   * This takes an eighth of the memory of "N * bool", so masks produced by
+   * comparisons and combined by the logical operators move an eighth of the
+   * data, and counting them is a popcount per 64 elements.
+   */
+  class DYND_API bitmask {
+  protected:
+    std::vector<uint64_t> m_words;
+    size_t m_size;
+
+    // Clears the bits of the last word past the last element
+    void clear_padding() {
+      if (m_size % 64 != 0) {
+        m_words.back() &= (static_cast<uint64_t>(1) << (m_size % 64)) - 1;
+      }
+    }
+
+  public:
+    bitmask() : m_size(0) {}
+
+    /**
+     * Creates a mask of ``size`` elements, all set or all clear.
+     */
+    explicit bitmask(size_t size, bool value = false)
+        : m_words((size + 63) / 64, value ? ~static_cast<uint64_t>(0) : 0), m_size(size) {
+      clear_padding();
+    }
+
+    size_t size() const { return m_size; }
+
+    size_t word_count() const { return m_words.size(); }
+
+    const uint64_t *words() const { return m_words.data(); }
+
+    uint64_t *words() { return m_words.data(); }
+
+    bool test(size_t i) const { return ((m_words[i / 64] >> (i % 64)) & 1) != 0; }
+
+    void set(size_t i) { m_words[i / 64] |= static_cast<uint64_t>(1) << (i % 64); }
+
+    void reset(size_t i) { m_words[i / 64] &= ~(static_cast<uint64_t>(1) << (i % 64)); }
+
+    /**
+     * The number of set elements.
+     */
+    size_t count() const;
+
+    bool all() const { return count() == m_size; }
+
+    bool any() const;
+
+    bool none() const { return !any(); }
+
+    bitmask &operator&=(const bitmask &rhs);
+    bitmask &operator|=(const bitmask &rhs);
+    bitmask &operator^=(const bitmask &rhs);
+
+    bitmask operator&(const bitmask &rhs) const { return bitmask(*this) &= rhs; }
+    bitmask operator|(const bitmask &rhs) const { return bitmask(*this) |= rhs; }
+    bitmask operator^(const bitmask &rhs) const { return bitmask(*this) ^= rhs; }
+    bitmask operator~() const;
+
+    /**
+     * Calls ``f(begin, end)`` for each maximal run [begin, end) of set
+     * elements, in order.
+     */
+    template <typename F>
+    void for_each_set_run(F &&f) const {
+      size_t run_begin = 0;
+      bool in_run = false;
+      for (size_t w = 0; w < m_words.size(); ++w) {
+        uint64_t word = m_words[w];
+        size_t base = w * 64;
+        if (word == (in_run ? ~static_cast<uint64_t>(0) : 0)) {
+          // Nothing changes in this word
+          continue;
+        }
+
+        // Visit the bits where a run starts or ends
+        uint64_t edges = word ^ (word << 1 | (in_run ? 1 : 0));
+        while (edges != 0) {
+          size_t i = base + count_trailing_zeros(edges);
+          if (in_run) {
+            f(run_begin, i);
+          } else {
+            run_begin = i;
+          }
+          in_run = !in_run;
+          edges &= edges - 1;
+        }
+      }
+
+      if (in_run) {
+        f(run_begin, m_size);
+      }
+    }
+
+    static int count_trailing_zeros(uint64_t x) {
+#ifdef __GNUC__
+      return __builtin_ctzll(x);
+#else
+      int n = 0;
+      for (; (x & 1) == 0; x >>= 1) {
+        ++n;
+      }
+      return n;
+#endif
+    }
+
+    static int popcount(uint64_t x) {
+#ifdef __GNUC__
+      return __builtin_popcountll(x);
+#else
+      x = x - ((x >> 1) & 0x5555555555555555ULL);
+      x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+      x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+      return static_cast<int>((x * 0x0101010101010101ULL) >> 56);
+#endif
+    }
+
+    /**
+     * Packs ``count`` bytes, at most 64, into the bits of a word, with bit
+     * ``i`` set when byte ``i`` is nonzero.
+     */
+    static uint64_t pack_bytes(const char *bytes, size_t count) {
+      uint64_t word = 0;
+      for (size_t i = 0; i < count; ++i) {
+        word |= static_cast<uint64_t>(bytes[i] != 0) << i;
+      }
+      return word;
+    }
+  };
+
+  /**
+   * Packs the one-dimensional boolean array ``a`` into a mask.
+   */
+  DYND_API bitmask make_bitmask(const array &a);
+
+  /**
+   * Unpacks the mask into an array of type "N * bool".
+   */
+  DYND_API array unpack_bitmask(const bitmask &mask);
+
+  /**
+   * Compares the elements of the one-dimensional array ``a`` with those of
+   * ``b``, which is either an array of the same size or a scalar, producing
+   * the mask of where the comparison is true. Both are promoted to a common
+   * type as in ``nd::less``, which must be a builtin integer or real type. A
+   * scalar that the elements of ``a`` can hold exactly is cast to their type
+   * instead, so the elements are compared without being widened.
+   * The comparison goes a vector at a time, with SSE2 or AVX2 where the CPU
+   * supports it, and packs the results into the mask directly.
+   */
+  DYND_API bitmask compare(comparison_type_t comptype, const array &a, const array &b);
+
+  /**
+   * Returns the elements of the one-dimensional array ``a`` whose bits are
+   * set in ``mask``, copying each run of them in one go.
+   */
+  DYND_API array masked_take(const array &a, const bitmask &mask);
+
+} // namespace dynd::nd
+} // namespace dynd
@@ -92,6 +92,7 @@ namespace nd {
       for (const callable &f : callables) {
         get()->overload(f);
       }
+      resolve_cache::invalidate_all();
     }
 
     /*
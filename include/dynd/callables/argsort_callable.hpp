@@ -0,0 +1,72 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/callables/sort_callable.hpp>
+#include <dynd/exceptions.hpp>
+#include <dynd/kernels/argsort_kernel.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * Returns the int64 indices that stably sort an array along ``axis``,
+   * which counts from the end when negative and defaults to the last one.
+   */
+  class argsort_callable : public base_callable {
+    template <typename LessType>
+    static void resolve_argsort(call_graph &cg, size_t ndim, size_t axis) {
+      cg.emplace_back([ndim, axis](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                                   const char *dst_arrmeta, size_t DYND_UNUSED(nsrc),
+                                   const char *const *src_arrmeta) {
+        std::vector<intptr_t> shape(ndim), dst_stride(ndim), src0_stride(ndim);
+        for (size_t i = 0; i < ndim; ++i) {
+          const size_stride_t &dst_ss = reinterpret_cast<const size_stride_t *>(dst_arrmeta)[i];
+          const size_stride_t &src0_ss = reinterpret_cast<const size_stride_t *>(src_arrmeta[0])[i];
+          shape[i] = src0_ss.dim_size;
+          dst_stride[i] = dst_ss.stride;
+          src0_stride[i] = src0_ss.stride;
+        }
+
+        kb.emplace_back<argsort_kernel<LessType>>(kernreq, axis, shape, dst_stride, src0_stride);
+        if (LessType::nchild != 0) {
+          kb(kernel_request_single, nullptr, nullptr, 2, nullptr);
+        }
+      });
+    }
+
+  public:
+    argsort_callable()
+        : base_callable(ndt::type("(Fixed**N * Scalar, axis: ?int32) -> Fixed**N * int64")) {}
+
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &DYND_UNUSED(dst_tp), size_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+                      size_t DYND_UNUSED(nkwd), const array *kwds, const std::map<std::string, ndt::type> &tp_vars) {
+      intptr_t ndim = src_tp[0].get_ndim();
+      intptr_t axis = kwds[0].is_na() ? -1 : kwds[0].as<int32_t>();
+      if (axis < -ndim || axis >= ndim) {
+        throw axis_out_of_bounds(axis, ndim);
+      }
+      if (axis < 0) {
+        axis += ndim;
+      }
+
+      ndt::type src0_element_tp = src_tp[0].get_dtype();
+      if (!dynd::detail::with_primitive_type(src0_element_tp.get_id(), [&](auto value) {
+            resolve_argsort<dynd::detail::typed_less<decltype(value)>>(cg, ndim, axis);
+          })) {
+        resolve_argsort<dynd::detail::kernel_less>(cg, ndim, axis);
+
+        const ndt::type child_src_tp[2] = {src0_element_tp, src0_element_tp};
+        less->resolve(this, nullptr, cg, ndt::make_type<bool1>(), 2, child_src_tp, 0, nullptr, tp_vars);
+      }
+
+      return src_tp[0].with_replaced_dtype(ndt::make_type<int64_t>());
+    }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
@@ -8,6 +8,8 @@
 #include <dynd/callables/base_callable.hpp>
 #include <dynd/functional.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/categorical_encode_kernel.hpp>
+#include <dynd/types/categorical_kind_type.hpp>
 #include <dynd/types/fixed_bytes_kind_type.hpp>
 #include <dynd/types/fixed_string_kind_type.hpp>
 #include <dynd/types/float_kind_type.hpp>
@@ -81,38 +83,39 @@ namespace nd {
                       size_t DYND_UNUSED(nkwd), const array *kwds,
                       const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
       assign_error_mode error_mode = kwds[0].is_na() ? assign_error_default : kwds[0].as<assign_error_mode>();
+      ndt::type src0_tp = src_tp[0];
       switch (error_mode) {
       case assign_error_default:
       case assign_error_nocheck:
         cg.emplace_back([=](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
                             const char *DYND_UNUSED(dst_arrmeta), size_t DYND_UNUSED(nsrc),
                             const char *const *src_arrmeta) {
-          kb.emplace_back<detail::assignment_kernel<bool1, string, assign_error_nocheck>>(kernreq, src_tp[0],
-                                                                                          src_arrmeta[0]);
+          kb.emplace_back<detail::assignment_kernel<bool1, string, assign_error_nocheck>>(kernreq, src0_tp,
+                                                                                        src_arrmeta[0]);
         });
         break;
       case assign_error_overflow:
         cg.emplace_back([=](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
                             const char *DYND_UNUSED(dst_arrmeta), size_t DYND_UNUSED(nsrc),
                             const char *const *src_arrmeta) {
-          kb.emplace_back<detail::assignment_kernel<bool1, string, assign_error_overflow>>(kernreq, src_tp[0],
-                                                                                           src_arrmeta[0]);
+          kb.emplace_back<detail::assignment_kernel<bool1, string, assign_error_overflow>>(kernreq, src0_tp,
+                                                                                         src_arrmeta[0]);
         });
         break;
       case assign_error_fractional:
         cg.emplace_back([=](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
                             const char *DYND_UNUSED(dst_arrmeta), size_t DYND_UNUSED(nsrc),
                             const char *const *src_arrmeta) {
-          kb.emplace_back<detail::assignment_kernel<bool1, string, assign_error_fractional>>(kernreq, src_tp[0],
-                                                                                             src_arrmeta[0]);
+          kb.emplace_back<detail::assignment_kernel<bool1, string, assign_error_fractional>>(kernreq, src0_tp,
+                                                                                           src_arrmeta[0]);
         });
         break;
       case assign_error_inexact:
         cg.emplace_back([=](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
                             const char *DYND_UNUSED(dst_arrmeta), size_t DYND_UNUSED(nsrc),
                             const char *const *src_arrmeta) {
-          kb.emplace_back<detail::assignment_kernel<bool1, string, assign_error_inexact>>(kernreq, src_tp[0],
-                                                                                          src_arrmeta[0]);
+          kb.emplace_back<detail::assignment_kernel<bool1, string, assign_error_inexact>>(kernreq, src0_tp,
+                                                                                        src_arrmeta[0]);
         });
         break;
       default:
@@ -261,9 +264,7 @@ namespace nd {
           kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data), const char *DYND_UNUSED(dst_arrmeta),
           size_t DYND_UNUSED(nsrc), const char *const *DYND_UNUSED(src_arrmeta)) {
         kb.emplace_back<detail::assignment_kernel<ndt::fixed_string_type, string, assign_error_nocheck>>(
-            kernreq, get_next_unicode_codepoint_function(src0_encoding, error_mode),
-            get_append_unicode_codepoint_function(dst_encoding, error_mode), dst_data_size,
-            error_mode != assign_error_nocheck);
+            kernreq, dst_encoding, src0_encoding, error_mode, dst_data_size);
       });
 
       return dst_tp;
@@ -284,16 +285,15 @@ namespace nd {
                       const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
       assign_error_mode error_mode = kwds[0].is_na() ? assign_error_default : kwds[0].as<assign_error_mode>();
 
+      ndt::type src0_tp = src_tp[0];
       cg.emplace_back([=](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
                           const char *DYND_UNUSED(dst_arrmeta), size_t DYND_UNUSED(nsrc),
                           const char *const *DYND_UNUSED(src_arrmeta)) {
-        const ndt::fixed_string_type *src_fs = src_tp[0].extended<ndt::fixed_string_type>();
+        const ndt::fixed_string_type *src_fs = src0_tp.extended<ndt::fixed_string_type>();
         kb.emplace_back<
             detail::assignment_kernel<ndt::fixed_string_type, ndt::fixed_string_type, assign_error_nocheck>>(
-            kernreq, get_next_unicode_codepoint_function(src_fs->get_encoding(), error_mode),
-            get_append_unicode_codepoint_function(dst_tp.extended<ndt::fixed_string_type>()->get_encoding(),
-                                                  error_mode),
-            dst_tp.get_data_size(), src_fs->get_data_size(), error_mode != assign_error_nocheck);
+            kernreq, dst_tp.extended<ndt::fixed_string_type>()->get_encoding(), src_fs->get_encoding(), error_mode,
+            dst_tp.get_data_size(), src_fs->get_data_size());
       });
 
       return dst_tp;
@@ -312,11 +312,12 @@ namespace nd {
                       const ndt::type &dst_tp, size_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
                       size_t DYND_UNUSED(nkwd), const array *DYND_UNUSED(kwds),
                       const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
+      ndt::type src0_tp = src_tp[0];
       cg.emplace_back([=](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
                           const char *dst_arrmeta, size_t DYND_UNUSED(nsrc),
                           const char *const *DYND_UNUSED(src_arrmeta)) {
         kb.emplace_back<detail::assignment_kernel<string, int8_t, assign_error_nocheck>>(
-            kernreq, dst_tp, src_tp[0].get_id(), dst_arrmeta);
+            kernreq, dst_tp, src0_tp.get_id(), dst_arrmeta);
       });
 
       return dst_tp;
@@ -343,9 +344,7 @@ namespace nd {
           kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data), const char *DYND_UNUSED(dst_arrmeta),
           size_t DYND_UNUSED(nsrc), const char *const *DYND_UNUSED(src_arrmeta)) {
         kb.emplace_back<detail::assignment_kernel<string, ndt::fixed_string_type, assign_error_nocheck>>(
-            kernreq, dst_encoding, src0_encoding, src0_data_size,
-            get_next_unicode_codepoint_function(src0_encoding, error_mode),
-            get_append_unicode_codepoint_function(dst_encoding, error_mode));
+            kernreq, dst_encoding, src0_encoding, src0_data_size, error_mode);
       });
 
       return dst_tp;
@@ -396,9 +395,7 @@ namespace nd {
           kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data), const char *DYND_UNUSED(dst_arrmeta),
           size_t DYND_UNUSED(nsrc), const char *const *DYND_UNUSED(src_arrmeta)) {
         kb.emplace_back<detail::assignment_kernel<string, ndt::fixed_string_type, assign_error_nocheck>>(
-            kernreq, dst_encoding, src0_encoding, src0_data_size,
-            get_next_unicode_codepoint_function(src0_encoding, error_mode),
-            get_append_unicode_codepoint_function(dst_encoding, error_mode));
+            kernreq, dst_encoding, src0_encoding, src0_data_size, error_mode);
       });
 
       return dst_tp;
@@ -419,11 +416,12 @@ namespace nd {
                       const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
       assign_error_mode error_mode = kwds[0].is_na() ? assign_error_default : kwds[0].as<assign_error_mode>();
 
+      ndt::type src0_tp = src_tp[0];
       cg.emplace_back([=](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
                           const char *DYND_UNUSED(dst_arrmeta), size_t DYND_UNUSED(nsrc),
                           const char *const *src_arrmeta) {
-        kb.emplace_back<detail::assignment_kernel<float, string, assign_error_nocheck>>(kernreq, src_tp[0],
-                                                                                        src_arrmeta[0], error_mode);
+        kb.emplace_back<detail::assignment_kernel<float, string, assign_error_nocheck>>(kernreq, src0_tp,
+                                                                                      src_arrmeta[0], error_mode);
       });
 
       return dst_tp;
@@ -473,15 +471,56 @@ namespace nd {
           kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data), const char *DYND_UNUSED(dst_arrmeta),
           size_t DYND_UNUSED(nsrc), const char *const *DYND_UNUSED(src_arrmeta)) {
         kb.emplace_back<detail::assignment_kernel<ndt::fixed_string_type, string, assign_error_nocheck>>(
-            kernreq, get_next_unicode_codepoint_function(src0_encoding, error_mode),
-            get_append_unicode_codepoint_function(dst_encoding, error_mode), dst_data_size,
-            error_mode != assign_error_nocheck);
+            kernreq, dst_encoding, src0_encoding, error_mode, dst_data_size);
+      });
+
+      return dst_tp;
+    }
+  };
+
+  /**
+   * Assigns elements of a categorical's category type to it, one strided
+   * run at a time through the hash index of the categories.
+   */
+  class categorical_encode_callable : public base_callable {
+  public:
+    categorical_encode_callable(const ndt::type &src0_tp)
+        : base_callable(ndt::make_type<ndt::callable_type>(
+              ndt::make_type<ndt::categorical_kind_type>(), {src0_tp},
+              {{ndt::make_type<ndt::option_type>(ndt::make_type<assign_error_mode>()), "error_mode"}})) {}
+
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &dst_tp, size_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+                      size_t DYND_UNUSED(nkwd), const array *DYND_UNUSED(kwds),
+                      const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
+      if (src_tp[0] != dst_tp.extended<ndt::categorical_type>()->get_category_type()) {
+        std::stringstream ss;
+        ss << "cannot assign " << src_tp[0] << " to " << dst_tp << ", whose categories are of another type";
+        throw type_error(ss.str());
+      }
+
+      cg.emplace_back([dst_tp](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                               const char *DYND_UNUSED(dst_arrmeta), size_t DYND_UNUSED(nsrc),
+                               const char *const *DYND_UNUSED(src_arrmeta)) {
+        kb.emplace_back<categorical_encode_kernel>(kernreq, dst_tp);
       });
 
       return dst_tp;
     }
   };
 
+  template <>
+  class assign_callable<ndt::categorical_type, string> : public categorical_encode_callable {
+  public:
+    assign_callable() : categorical_encode_callable(ndt::make_type<string>()) {}
+  };
+
+  template <>
+  class assign_callable<ndt::categorical_type, ndt::fixed_string_type> : public categorical_encode_callable {
+  public:
+    assign_callable() : categorical_encode_callable(ndt::make_type<ndt::fixed_string_kind_type>()) {}
+  };
+
   template <>
   class assign_callable<ndt::pointer_type, ndt::pointer_type> : public base_callable {
   public:
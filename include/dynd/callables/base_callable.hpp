@@ -11,6 +11,7 @@
 
 #include <dynd/array.hpp>
 #include <dynd/callables/call_graph.hpp>
+#include <dynd/callables/resolve_cache.hpp>
 #include <dynd/kernels/kernel_prefix.hpp>
 #include <dynd/types/callable_type.hpp>
 #include <dynd/types/substitute_typevars.hpp>
@@ -53,6 +54,7 @@ namespace nd {
   protected:
     std::atomic_long m_use_count;
     ndt::type m_tp;
+    resolve_cache m_resolve_cache;
 
   public:
     base_callable(const ndt::type &tp) : m_use_count(0), m_tp(tp) {}
@@ -90,6 +92,22 @@ namespace nd {
 
     bool is_kwd_variadic() const { return m_tp.extended<ndt::callable_type>()->is_kwd_variadic(); }
 
+    /**
+     * The cache of call graphs used by ``call``. Its hit and miss counts
+     * report how often a call skipped resolution.
+     */
+    resolve_cache &get_resolve_cache() { return m_resolve_cache; }
+
+    const resolve_cache &get_resolve_cache() const { return m_resolve_cache; }
+
+    /**
+     * Resolves the callable for the given types and keywords, reusing a
+     * previously resolved call graph when the same signature was seen before.
+     * ``kwds`` holds the keyword values in the order of the callable type.
+     */
+    std::shared_ptr<call_graph> resolve_cached(ndt::type &dst_tp, size_t nsrc, const ndt::type *src_tp, size_t nkwd,
+                                               const array *kwds, const std::map<std::string, ndt::type> &tp_vars);
+
     /**
      * Function prototype for instantiating a kernel from an
      * callable. To use this function, the
@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 
 #include <dynd/callables/base_callable.hpp>
@@ -32,8 +33,30 @@ namespace nd {
         intptr_t res_alignment;
         size_t ndim;
         bool res_ignore;
+        // Whether the outermost dimension may be split across threads, and
+        // the number of scalar elements in one of its elements
+        bool parallel;
+        size_t inner_size;
+        // The number of dimensions, starting with this one, that are fixed
+        // with one size in the result and in every argument that has them,
+        // and the number of leading dimensions each argument is missing
+        size_t ncoalesce;
+        std::array<size_t, N> arg_lead;
       };
 
+      /**
+       * The number of elements in the leading fixed dimensions of a type.
+       */
+      static size_t get_fixed_size(ndt::type tp) {
+        size_t size = 1;
+        while (tp.get_id() == fixed_dim_id) {
+          size *= tp.extended<ndt::fixed_dim_type>()->get_fixed_dim_size();
+          tp = tp.extended<ndt::fixed_dim_type>()->get_element_type();
+        }
+
+        return size;
+      }
+
     public:
       base_elwise_callable() : base_callable(ndt::type()) {}
 
@@ -103,6 +126,62 @@ namespace nd {
           }
         }
 
+        // Kernels that allocate into the memory blocks of the result, like
+        // string arenas, cannot run concurrently. The arguments are only read.
+        data.parallel = true;
+        data.inner_size = 1;
+        for (size_t i = 0; i < N; ++i) {
+          if (!data.arg_broadcast[i]) {
+            data.inner_size = std::max(data.inner_size, get_fixed_size(arg_element_tp[i]));
+          }
+        }
+        const ndt::type &known_res_tp = res_tp.is_symbolic() ? child_ret_tp : res_tp;
+        data.parallel &= known_res_tp.is_symbolic() || (known_res_tp.get_flags() & type_flag_blockref) == 0;
+
+        // Dimensions that are fixed everywhere can be looped over in any order
+        // and merged with their neighbours once the strides are known
+        data.ncoalesce = 0;
+        for (size_t i = 0; i < N; ++i) {
+          data.arg_lead[i] = max_ndim - (arg_tp[i].get_ndim() - child_arg_tp[i].get_ndim());
+        }
+        if (!res_ignore && !reinterpret_cast<codata_type *>(codata)->state) {
+          ndt::type dim_res_tp = res_tp;
+          std::array<ndt::type, N> dim_arg_tp;
+          std::copy(arg_tp, arg_tp + N, dim_arg_tp.begin());
+          for (size_t j = 0; j < static_cast<size_t>(max_ndim); ++j) {
+            intptr_t size = -1;
+            bool fixed = true;
+            for (size_t i = 0; i < N && fixed; ++i) {
+              if (j >= data.arg_lead[i]) {
+                ndt::type &dim_tp = dim_arg_tp[i];
+                if (dim_tp.get_id() != fixed_dim_id ||
+                    (size != -1 && dim_tp.extended<ndt::fixed_dim_type>()->get_fixed_dim_size() != size)) {
+                  fixed = false;
+                } else {
+                  size = dim_tp.extended<ndt::fixed_dim_type>()->get_fixed_dim_size();
+                  dim_tp = dim_tp.extended<ndt::fixed_dim_type>()->get_element_type();
+                }
+              }
+            }
+            if (fixed && !dim_res_tp.is_variadic()) {
+              if (dim_res_tp.get_id() != fixed_dim_id ||
+                  (size != -1 && dim_res_tp.extended<ndt::fixed_dim_type>()->get_fixed_dim_size() != size)) {
+                fixed = false;
+              } else {
+                size = dim_res_tp.extended<ndt::fixed_dim_type>()->get_fixed_dim_size();
+                dim_res_tp = dim_res_tp.extended<ndt::fixed_dim_type>()->get_element_type();
+              }
+            }
+
+            // Dimensions of size one are broadcast without advancing the
+            // arrmeta, so they end the run
+            if (!fixed || size <= 1) {
+              break;
+            }
+            ++data.ncoalesce;
+          }
+        }
+
         subresolve(cg, reinterpret_cast<char *>(&data));
 
         if (--reinterpret_cast<codata_type *>(codata)->ndim > 0) {
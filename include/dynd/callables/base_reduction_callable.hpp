@@ -5,9 +5,12 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <memory>
 
 #include <dynd/callables/base_callable.hpp>
+#include <dynd/callables/call_graph.hpp>
 #include <dynd/kernels/reduction_kernel.hpp>
 #include <dynd/types/fixed_dim_type.hpp>
 #include <dynd/types/var_dim_type.hpp>
@@ -28,12 +31,42 @@ namespace nd {
         intptr_t ndim;
       };
 
+      /**
+       * What the outermost dimension needs to run on a thread pool, which is
+       * only known once the whole reduction has been resolved.
+       */
+      struct parallel_type {
+        bool enabled;
+        // The number of scalar elements in one element of the dimension
+        size_t inner_size;
+        // The size of the result, when the dimension is reduced
+        size_t data_size;
+        // Accumulates one partial result into another, when the dimension is
+        // reduced
+        call_graph combine;
+
+        parallel_type() : enabled(false), inner_size(1), data_size(0) {}
+      };
+
       struct node_type {
         bool inner;
         bool broadcast;
         bool keepdim;
+        std::shared_ptr<parallel_type> parallel;
       };
 
+    private:
+      static size_t get_fixed_size(ndt::type tp) {
+        size_t size = 1;
+        while (tp.get_id() == fixed_dim_id) {
+          size *= tp.extended<ndt::fixed_dim_type>()->get_fixed_dim_size();
+          tp = tp.extended<ndt::fixed_dim_type>()->get_element_type();
+        }
+
+        return size;
+      }
+
+    public:
       base_reduction_callable() : base_callable(ndt::type()) {}
 
       virtual void resolve(call_graph &cg, char *data) = 0;
@@ -55,6 +88,13 @@ namespace nd {
         node.broadcast = !reduce;
         node.keepdim = reinterpret_cast<data_type *>(data)->keepdims;
 
+        // Only the outermost dimension of a single argument reduction may run
+        // in parallel, if its element types do not reference memory blocks
+        if (reinterpret_cast<data_type *>(data)->axis == 0 && nsrc == 1 && src_tp[0].get_id() == fixed_dim_id &&
+            (src_tp[0].get_flags() & type_flag_blockref) == 0) {
+          node.parallel = std::make_shared<parallel_type>();
+        }
+
         std::vector<ndt::type> arg_element_tp(2);
         for (size_t i = 0; i < nsrc; ++i) {
           if (reduce) {
@@ -82,6 +122,23 @@ namespace nd {
           ret_element_tp = caller->resolve(this, data, cg, res_tp, nsrc, arg_element_tp.data(), nkwd, kwds, tp_vars);
         }
 
+        if (node.parallel && (ret_element_tp.get_flags() & type_flag_blockref) == 0) {
+          parallel_type &parallel = *node.parallel;
+          parallel.inner_size = get_fixed_size(arg_element_tp[0]);
+          if (!reduce) {
+            parallel.enabled = !node.inner;
+          } else {
+            // The partial results have to be single builtin values of the
+            // source type, which the reduction child itself can combine
+            ndt::type ret_dtp = ret_element_tp.get_dtype();
+            if (ret_dtp.is_builtin() && ret_dtp == src_tp[0].get_dtype() && get_fixed_size(ret_element_tp) == 1) {
+              parallel.data_size = ret_dtp.get_data_size();
+              parallel.enabled = child->resolve(this, nullptr, parallel.combine, ret_dtp, 1, &ret_dtp, nkwd - 2,
+                                                kwds + 2, tp_vars) == ret_dtp;
+            }
+          }
+        }
+
         if (reduce) {
           if (reinterpret_cast<data_type *>(data)->keepdims) {
             return ndt::make_type<ndt::fixed_dim_type>(1, ret_element_tp);
@@ -103,10 +160,89 @@ namespace nd {
         bool inner = reinterpret_cast<node_type *>(data)->inner;
         bool broadcast = reinterpret_cast<node_type *>(data)->broadcast;
         bool keepdim = reinterpret_cast<node_type *>(data)->keepdim;
+        std::shared_ptr<parallel_type> parallel = reinterpret_cast<node_type *>(data)->parallel;
+
+        cg.emplace_back([inner, broadcast, keepdim, parallel](kernel_builder &kb, kernel_request_t kernreq,
+                                                              char *DYND_UNUSED(data), const char *dst_arrmeta,
+                                                              size_t nsrc, const char *const *src_arrmeta) {
+          // Only the outermost dimension is split, once there is enough work
+          // for at least two threads
+          if (parallel && parallel->enabled && kernreq != kernel_request_strided) {
+            size_t src_size = reinterpret_cast<const size_stride_t *>(src_arrmeta[0])->dim_size;
+            size_t nthreads = eval::default_eval_context.nthreads;
+            size_t grain_size = std::max<size_t>(eval::default_eval_context.grain_size / parallel->inner_size, 1);
+            if (nthreads != 1 && src_size >= 2 * grain_size) {
+              std::shared_ptr<thread_pool> pool = get_thread_pool(nthreads);
+              intptr_t src_stride = reinterpret_cast<const size_stride_t *>(src_arrmeta[0])->stride;
+              const char *src_element_arrmeta = src_arrmeta[0] + sizeof(size_stride_t);
+
+              if (broadcast) {
+                typedef parallel_reduction_kernel<true, false> self_type;
+                intptr_t dst_stride = reinterpret_cast<const size_stride_t *>(dst_arrmeta)->stride;
+                const char *dst_element_arrmeta = dst_arrmeta + sizeof(size_stride_t);
+
+                intptr_t self_offset = kb.size();
+                kb.emplace_back<self_type>(kernreq, src_size, dst_stride, src_stride, grain_size, pool);
+
+                call_node *child_call = kb.get_call();
+                kb(kernel_request_strided, nullptr, dst_element_arrmeta, 1, &src_element_arrmeta);
+
+                self_type *self = kb.get_at<self_type>(self_offset);
+                for (size_t i = 1; i < pool->get_nthreads(); ++i) {
+                  self->m_workers.emplace_back(new kernel_builder(child_call));
+                  (*self->m_workers.back())(kernel_request_strided, nullptr, dst_element_arrmeta, 1,
+                                            &src_element_arrmeta);
+                }
+              } else if (inner) {
+                typedef parallel_reduction_kernel<false, true> self_type;
+                const char *dst_element_arrmeta = keepdim ? (dst_arrmeta + sizeof(size_stride_t)) : dst_arrmeta;
+
+                intptr_t self_offset = kb.size();
+                kb.emplace_back<self_type>(kernreq, src_size, src_stride, grain_size, pool, parallel->data_size);
+
+                call_node *child_call = kb.get_call();
+                kb(kernel_request_strided, nullptr, dst_element_arrmeta, 1, &src_element_arrmeta);
+
+                intptr_t init_offset = kb.size();
+                kb(kernel_request_single, nullptr, dst_element_arrmeta, 1, &src_element_arrmeta);
+
+                self_type *self = kb.get_at<self_type>(self_offset);
+                self->init_offset = init_offset - self_offset;
+                for (size_t i = 1; i < pool->get_nthreads(); ++i) {
+                  self->m_workers.emplace_back(new kernel_builder(child_call));
+                  kernel_builder &worker_kb = *self->m_workers.back();
+                  worker_kb(kernel_request_strided, nullptr, dst_element_arrmeta, 1, &src_element_arrmeta);
+                  self->worker_init_offset = worker_kb.size();
+                  worker_kb(kernel_request_single, nullptr, dst_element_arrmeta, 1, &src_element_arrmeta);
+                }
+                self->m_combine.reset(new kernel_builder(parallel->combine.get()));
+                const char *combine_arrmeta = nullptr;
+                (*self->m_combine)(kernel_request_single, nullptr, nullptr, 1, &combine_arrmeta);
+              } else {
+                typedef parallel_reduction_kernel<false, false> self_type;
+                const char *dst_element_arrmeta = keepdim ? (dst_arrmeta + sizeof(size_stride_t)) : dst_arrmeta;
+
+                intptr_t self_offset = kb.size();
+                kb.emplace_back<self_type>(kernreq, src_size, src_stride, grain_size, pool, parallel->data_size);
+
+                call_node *child_call = kb.get_call();
+                kb(kernel_request_single, nullptr, dst_element_arrmeta, 1, &src_element_arrmeta);
+
+                self_type *self = kb.get_at<self_type>(self_offset);
+                for (size_t i = 1; i < pool->get_nthreads(); ++i) {
+                  self->m_workers.emplace_back(new kernel_builder(child_call));
+                  (*self->m_workers.back())(kernel_request_single, nullptr, dst_element_arrmeta, 1,
+                                            &src_element_arrmeta);
+                }
+                self->m_combine.reset(new kernel_builder(parallel->combine.get()));
+                const char *combine_arrmeta = nullptr;
+                (*self->m_combine)(kernel_request_single, nullptr, nullptr, 1, &combine_arrmeta);
+              }
+
+              return;
+            }
+          }
 
-        cg.emplace_back([inner, broadcast, keepdim](kernel_builder &kb, kernel_request_t kernreq,
-                                                    char *DYND_UNUSED(data), const char *dst_arrmeta, size_t nsrc,
-                                                    const char *const *src_arrmeta) {
           if (inner) {
             if (!broadcast) {
               intptr_t src_size = reinterpret_cast<const size_stride_t *>(src_arrmeta[0])->dim_size;
@@ -8,6 +8,7 @@
 #include <dynd/callables/base_callable.hpp>
 #include <dynd/callables/base_elwise_callable.hpp>
 #include <dynd/kernels/elwise_kernel.hpp>
+#include <dynd/shape_tools.hpp>
 
 namespace dynd {
 namespace nd {
@@ -45,14 +46,141 @@ namespace nd {
     class elwise_callable<fixed_dim_id, fixed_dim_id, TraitsType, N> : public base_elwise_callable<N> {
       typedef typename base_elwise_callable<N>::data_type data_type;
 
+      struct loop_type {
+        intptr_t size;
+        intptr_t dst_stride;
+        std::array<intptr_t, N> src_stride;
+      };
+
+      /**
+       * Instantiates the loops from ``begin`` on, one kernel each, passes over
+       * the call nodes of the dimensions they absorbed, and instantiates the
+       * child.
+       */
+      static void instantiate_loops(kernel_builder &kb, char *data, const std::vector<loop_type> &loops, size_t begin,
+                                    size_t ndim, const char *dst_arrmeta, const char *const *src_arrmeta) {
+        for (size_t j = begin; j < loops.size(); ++j) {
+          kb.emplace_back<elwise_kernel<fixed_dim_id, fixed_dim_id, TraitsType, N>>(
+              kernel_request_strided, data, loops[j].size, loops[j].dst_stride, loops[j].src_stride.data());
+        }
+        for (size_t j = loops.size(); j < ndim; ++j) {
+          kb.pass();
+        }
+
+        kb(kernel_request_strided, TraitsType::child_data(data), dst_arrmeta, N, src_arrmeta);
+      }
+
+      /**
+       * Instantiates ``ndim`` fixed dimensions at once. The dimensions are
+       * ordered so that the one with the smallest strides is innermost, and
+       * neighbours that step through memory like a single dimension are
+       * merged, so that the child is called on runs as long as possible.
+       */
+      static void instantiate_coalesced(kernel_builder &kb, kernel_request_t kernreq, char *data,
+                                        const char *dst_arrmeta, const char *const *src_arrmeta, size_t ndim,
+                                        const std::array<size_t, N> &arg_lead, bool parallel) {
+        // The strides of the destination, then of every argument
+        std::vector<intptr_t> shape(ndim), strides((N + 1) * ndim);
+        for (size_t j = 0; j < ndim; ++j) {
+          shape[j] = reinterpret_cast<const size_stride_t *>(dst_arrmeta)[j].dim_size;
+          strides[j] = reinterpret_cast<const size_stride_t *>(dst_arrmeta)[j].stride;
+        }
+        std::array<const char *, N> child_src_arrmeta;
+        for (size_t i = 0; i < N; ++i) {
+          for (size_t j = 0; j < ndim; ++j) {
+            strides[(i + 1) * ndim + j] =
+                (j < arg_lead[i]) ? 0 : reinterpret_cast<const size_stride_t *>(src_arrmeta[i])[j - arg_lead[i]].stride;
+          }
+          child_src_arrmeta[i] = src_arrmeta[i] + (ndim - std::min(ndim, arg_lead[i])) * sizeof(size_stride_t);
+        }
+        const char *child_dst_arrmeta = dst_arrmeta + ndim * sizeof(size_stride_t);
+
+        std::array<const intptr_t *, N + 1> operstrides;
+        for (size_t i = 0; i <= N; ++i) {
+          operstrides[i] = strides.data() + i * ndim;
+        }
+        std::vector<int> axis_perm(ndim);
+        multistrides_to_axis_perm(ndim, N + 1, operstrides.data(), axis_perm.data());
+
+        // From the outermost loop to the innermost
+        std::vector<loop_type> loops;
+        for (size_t j = ndim; j-- > 0;) {
+          int axis = axis_perm[j];
+          loop_type loop;
+          loop.size = shape[axis];
+          loop.dst_stride = strides[axis];
+          for (size_t i = 0; i < N; ++i) {
+            loop.src_stride[i] = strides[(i + 1) * ndim + axis];
+          }
+
+          if (!loops.empty()) {
+            loop_type &outer = loops.back();
+            bool contiguous = outer.dst_stride == loop.dst_stride * loop.size;
+            for (size_t i = 0; i < N; ++i) {
+              contiguous &= outer.src_stride[i] == loop.src_stride[i] * loop.size;
+            }
+            if (contiguous) {
+              outer.size *= loop.size;
+              outer.dst_stride = loop.dst_stride;
+              outer.src_stride = loop.src_stride;
+              continue;
+            }
+          }
+
+          loops.push_back(loop);
+        }
+
+        size_t inner_size = 1;
+        for (size_t j = 1; j < loops.size(); ++j) {
+          inner_size *= loops[j].size;
+        }
+
+        size_t nthreads = eval::default_eval_context.nthreads;
+        size_t grain_size = std::max<size_t>(eval::default_eval_context.grain_size / inner_size, 1);
+        if (parallel && kernreq != kernel_request_strided && nthreads != 1 &&
+            static_cast<size_t>(loops[0].size) >= 2 * grain_size) {
+          std::shared_ptr<thread_pool> pool = get_thread_pool(nthreads);
+
+          intptr_t self_offset = kb.size();
+          kb.emplace_back<parallel_elwise_kernel<N>>(kernreq, loops[0].size, loops[0].dst_stride,
+                                                     loops[0].src_stride.data(), grain_size, pool);
+
+          call_node *child_call = kb.get_call();
+          instantiate_loops(kb, data, loops, 1, ndim, child_dst_arrmeta, child_src_arrmeta.data());
+
+          parallel_elwise_kernel<N> *self = kb.get_at<parallel_elwise_kernel<N>>(self_offset);
+          for (size_t i = 1; i < pool->get_nthreads(); ++i) {
+            self->m_workers.emplace_back(new kernel_builder(child_call));
+            instantiate_loops(*self->m_workers.back(), data, loops, 1, ndim, child_dst_arrmeta,
+                              child_src_arrmeta.data());
+          }
+          return;
+        }
+
+        kb.emplace_back<elwise_kernel<fixed_dim_id, fixed_dim_id, TraitsType, N>>(
+            kernreq, data, loops[0].size, loops[0].dst_stride, loops[0].src_stride.data());
+        instantiate_loops(kb, data, loops, 1, ndim, child_dst_arrmeta, child_src_arrmeta.data());
+      }
+
     public:
       void subresolve(call_graph &cg, const char *data) {
         bool res_broadcast = reinterpret_cast<const data_type *>(data)->res_ignore;
         const std::array<bool, N> &arg_broadcast = reinterpret_cast<const data_type *>(data)->arg_broadcast;
+        bool parallel = std::is_same<TraitsType, no_traits>::value && !res_broadcast &&
+                        reinterpret_cast<const data_type *>(data)->parallel;
+        size_t inner_size = reinterpret_cast<const data_type *>(data)->inner_size;
+        size_t ncoalesce =
+            std::is_same<TraitsType, no_traits>::value ? reinterpret_cast<const data_type *>(data)->ncoalesce : 0;
+        const std::array<size_t, N> &arg_lead = reinterpret_cast<const data_type *>(data)->arg_lead;
+
+        cg.emplace_back([res_broadcast, arg_broadcast, parallel, inner_size, ncoalesce, arg_lead](
+            kernel_builder &kb, kernel_request_t kernreq, char *data, const char *dst_arrmeta,
+            size_t DYND_UNUSED(nsrc), const char *const *src_arrmeta) {
+          if (ncoalesce > 1) {
+            instantiate_coalesced(kb, kernreq, data, dst_arrmeta, src_arrmeta, ncoalesce, arg_lead, parallel);
+            return;
+          }
 
-        cg.emplace_back([res_broadcast, arg_broadcast](kernel_builder &kb, kernel_request_t kernreq, char *data,
-                                                       const char *dst_arrmeta, size_t DYND_UNUSED(nsrc),
-                                                       const char *const *src_arrmeta) {
           size_t size;
           if (res_broadcast) {
             size = reinterpret_cast<const size_stride_t *>(src_arrmeta[0])->dim_size;
@@ -82,6 +210,27 @@ namespace nd {
             }
           }
 
+          // Only the outermost dimension is split, once there is enough work
+          // for at least two threads
+          size_t nthreads = eval::default_eval_context.nthreads;
+          size_t grain_size = std::max<size_t>(eval::default_eval_context.grain_size / inner_size, 1);
+          if (parallel && kernreq != kernel_request_strided && nthreads != 1 && size >= 2 * grain_size) {
+            std::shared_ptr<thread_pool> pool = get_thread_pool(nthreads);
+
+            intptr_t self_offset = kb.size();
+            kb.emplace_back<parallel_elwise_kernel<N>>(kernreq, size, dst_stride, src_stride.data(), grain_size, pool);
+
+            call_node *child_call = kb.get_call();
+            kb(kernel_request_strided, data, child_dst_arrmeta, N, child_src_arrmeta.data());
+
+            parallel_elwise_kernel<N> *self = kb.get_at<parallel_elwise_kernel<N>>(self_offset);
+            for (size_t i = 1; i < pool->get_nthreads(); ++i) {
+              self->m_workers.emplace_back(new kernel_builder(child_call));
+              (*self->m_workers.back())(kernel_request_strided, data, child_dst_arrmeta, N, child_src_arrmeta.data());
+            }
+            return;
+          }
+
           kb.emplace_back<elwise_kernel<fixed_dim_id, fixed_dim_id, TraitsType, N>>(kernreq, data, size, dst_stride,
                                                                                     src_stride.data());
 
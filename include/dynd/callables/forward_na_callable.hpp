@@ -28,16 +28,16 @@ namespace nd {
         size_t self_offset = kb.size();
         kb.emplace_back<forward_na_kernel<I...>>(kernreq);
 
-        kb(kernel_request_single, nullptr, dst_arrmeta, nsrc, src_arrmeta);
+        kb(kernel_request_strided, nullptr, dst_arrmeta, nsrc, src_arrmeta);
 
         for (intptr_t i : std::array<index_t, sizeof...(I)>({I...})) {
           size_t is_na_offset = kb.size() - self_offset;
-          kb(kernel_request_single, nullptr, nullptr, 1, src_arrmeta + i);
+          kb(kernel_request_strided, nullptr, nullptr, 1, src_arrmeta + i);
           kb.get_at<forward_na_kernel<I...>>(self_offset)->is_na_offset[i] = is_na_offset;
         }
 
         size_t assign_na_offset = kb.size() - self_offset;
-        kb(kernel_request_single, nullptr, nullptr, 0, nullptr);
+        kb(kernel_request_strided, nullptr, nullptr, 0, nullptr);
         kb.get_at<forward_na_kernel<I...>>(self_offset)->assign_na_offset = assign_na_offset;
       });
 
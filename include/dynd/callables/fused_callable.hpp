@@ -0,0 +1,89 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/callables/base_callable.hpp>
+#include <dynd/kernels/fused_kernel.hpp>
+
+namespace dynd {
+namespace nd {
+  namespace functional {
+
+    /**
+     * One step of a fused expression, a callable applied to sources of the
+     * expression or to the results of earlier steps.
+     */
+    struct fused_step {
+      callable func;
+      // The resolved type of the result
+      ndt::type tp;
+      // The sources of the expression, followed by the results of the steps
+      std::vector<size_t> args;
+    };
+
+    /**
+     * A callable on scalars that evaluates a sequence of steps with one
+     * fused_kernel. Wrapped in elwise, it streams through arrays without
+     * materializing the intermediate results.
+     */
+    class fused_callable : public base_callable {
+      std::vector<fused_step> m_steps;
+
+    public:
+      fused_callable(const ndt::type &tp, const std::vector<fused_step> &steps) : base_callable(tp), m_steps(steps) {}
+
+      ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                        const ndt::type &DYND_UNUSED(dst_tp), size_t nsrc, const ndt::type *src_tp,
+                        size_t DYND_UNUSED(nkwd), const array *DYND_UNUSED(kwds),
+                        const std::map<std::string, ndt::type> &tp_vars) {
+        std::vector<intptr_t> data_sizes;
+        std::vector<size_t> args_begin{0};
+        std::vector<size_t> args;
+        for (const fused_step &step : m_steps) {
+          data_sizes.push_back(step.tp.get_data_size());
+          args.insert(args.end(), step.args.begin(), step.args.end());
+          args_begin.push_back(args.size());
+        }
+
+        cg.emplace_back([nsrc, data_sizes, args_begin, args](kernel_builder &kb, kernel_request_t kernreq,
+                                                             char *DYND_UNUSED(data), const char *dst_arrmeta,
+                                                             size_t DYND_UNUSED(nsrc), const char *const *src_arrmeta) {
+          intptr_t root_kb_offset = kb.size();
+          kb.emplace_back<fused_kernel>(kernreq, nsrc, data_sizes, args_begin, args);
+
+          size_t nstep = data_sizes.size();
+          std::vector<const char *> child_src_arrmeta;
+          for (size_t i = 0; i < nstep; ++i) {
+            child_src_arrmeta.clear();
+            for (size_t k = args_begin[i]; k < args_begin[i + 1]; ++k) {
+              child_src_arrmeta.push_back(args[k] < nsrc ? src_arrmeta[args[k]] : nullptr);
+            }
+
+            intptr_t kb_offset = kb.size();
+            kb.get_at<fused_kernel>(root_kb_offset)->m_offsets[i] = kb_offset - root_kb_offset;
+            kb(kernel_request_strided, nullptr, (i + 1 == nstep) ? dst_arrmeta : nullptr, child_src_arrmeta.size(),
+               child_src_arrmeta.data());
+          }
+        });
+
+        std::vector<ndt::type> step_src_tp;
+        for (size_t i = 0; i < m_steps.size(); ++i) {
+          step_src_tp.clear();
+          for (size_t arg : m_steps[i].args) {
+            step_src_tp.push_back(arg < nsrc ? src_tp[arg] : m_steps[arg - nsrc].tp);
+          }
+
+          m_steps[i].func->resolve(this, nullptr, cg, m_steps[i].tp, step_src_tp.size(), step_src_tp.data(), 0, nullptr,
+                                   tp_vars);
+        }
+
+        return m_steps.back().tp;
+      }
+    };
+
+  } // namespace dynd::nd::functional
+} // namespace dynd::nd
+} // namespace dynd
@@ -0,0 +1,65 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/callables/sort_callable.hpp>
+#include <dynd/exceptions.hpp>
+#include <dynd/kernels/partition_kernel.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * Partitions an array in place around the element at index ``kth``, which
+   * counts from the end when negative.
+   */
+  class partition_callable : public base_callable {
+    template <typename LessType>
+    static void resolve_partition(call_graph &cg, size_t src0_element_data_size, intptr_t kth) {
+      cg.emplace_back([src0_element_data_size, kth](kernel_builder &kb, kernel_request_t kernreq,
+                                                     char *DYND_UNUSED(data), const char *DYND_UNUSED(dst_arrmeta),
+                                                     size_t DYND_UNUSED(nsrc), const char *const *src_arrmeta) {
+        kb.emplace_back<partition_kernel<LessType>>(
+            kernreq, reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->dim_size,
+            reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->stride, src0_element_data_size, kth);
+        if (LessType::nchild != 0) {
+          kb(kernel_request_single, nullptr, nullptr, 2, nullptr);
+        }
+      });
+    }
+
+  public:
+    partition_callable() : base_callable(ndt::type("(Fixed * Scalar, kth: Int) -> void")) {}
+
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &dst_tp, size_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+                      size_t DYND_UNUSED(nkwd), const array *kwds, const std::map<std::string, ndt::type> &tp_vars) {
+      intptr_t size = src_tp[0].extended<ndt::fixed_dim_type>()->get_fixed_dim_size();
+      intptr_t kth = kwds[0].as<intptr_t>();
+      if (kth < -size || kth >= size) {
+        throw index_out_of_bounds(kth, size);
+      }
+      if (kth < 0) {
+        kth += size;
+      }
+
+      const ndt::type &src0_element_tp = src_tp[0].extended<ndt::fixed_dim_type>()->get_element_type();
+      size_t src0_element_data_size = src0_element_tp.get_data_size();
+      if (!dynd::detail::with_primitive_type(src0_element_tp.get_id(), [&](auto value) {
+            resolve_partition<dynd::detail::typed_less<decltype(value)>>(cg, src0_element_data_size, kth);
+          })) {
+        resolve_partition<dynd::detail::kernel_less>(cg, src0_element_data_size, kth);
+
+        const ndt::type child_src_tp[2] = {src0_element_tp, src0_element_tp};
+        less->resolve(this, nullptr, cg, ndt::make_type<bool1>(), 2, child_src_tp, 0, nullptr, tp_vars);
+      }
+
+      return dst_tp;
+    }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
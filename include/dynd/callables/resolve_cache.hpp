@@ -0,0 +1,142 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <dynd/array.hpp>
+#include <dynd/callables/call_graph.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * A bounded, thread-safe cache of resolved call graphs. Entries are keyed
+   * by the destination type, the argument types, the type variables and the
+   * values of the keyword arguments a callable was resolved with, and hold
+   * the resolved destination type together with the call graph that
+   * instantiates the kernel. Instantiating a kernel only reads a call graph,
+   * so one cached graph may be shared by any number of concurrent calls.
+   *
+   * Eviction is least-recently-used once the capacity is exceeded.
+   *
+   * The resolution of a dispatch callable depends on the callables it
+   * dispatches to, so overloading any callable invalidates every cache.
+   */
+  class DYND_API resolve_cache {
+  public:
+    /**
+     * The structural key of one resolution. Types are compared with
+     * ndt::type::operator==, keyword values byte for byte.
+     */
+    struct key_type {
+      size_t hash;
+      std::vector<ndt::type> types;
+      std::vector<char> bytes;
+      // The generation the key was made in
+      size_t generation;
+
+      key_type() : hash(0), generation(0) {}
+
+      bool operator==(const key_type &rhs) const {
+        return hash == rhs.hash && types == rhs.types && bytes == rhs.bytes;
+      }
+    };
+
+    /**
+     * The default number of entries kept per callable.
+     */
+    static const size_t default_capacity = 32;
+
+  private:
+    struct entry_type {
+      key_type key;
+      ndt::type dst_tp;
+      std::shared_ptr<call_graph> cg;
+    };
+
+    static std::atomic<size_t> s_generation;
+
+    mutable std::mutex m_mutex;
+    std::list<entry_type> m_entries;
+    // The entries by the hash of their keys
+    std::unordered_multimap<size_t, std::list<entry_type>::iterator> m_index;
+    size_t m_generation;
+    std::atomic<size_t> m_capacity;
+    std::atomic<size_t> m_hit_count;
+    std::atomic<size_t> m_miss_count;
+
+    // Drops the least recently used entries beyond the capacity, with the
+    // mutex held
+    void evict();
+
+  public:
+    resolve_cache(size_t capacity = default_capacity)
+        : m_generation(s_generation), m_capacity(capacity), m_hit_count(0), m_miss_count(0) {}
+
+    // non-copyable
+    resolve_cache(const resolve_cache &) = delete;
+
+    /**
+     * Builds the key for a resolution. Returns false if one of the keyword
+     * arguments has a value which cannot be compared structurally (e.g. it
+     * holds references to other memory), in which case the resolution must
+     * not be cached.
+     */
+    static bool make_key(key_type &key, const ndt::type &dst_tp, size_t narg, const ndt::type *arg_tp, size_t nkwd,
+                         const array *kwds, const std::map<std::string, ndt::type> &tp_vars);
+
+    /**
+     * Looks up a previous resolution, counting a hit or a miss. On a hit,
+     * ``dst_tp`` and ``cg`` are set from the cached entry.
+     */
+    bool find(const key_type &key, ndt::type &dst_tp, std::shared_ptr<call_graph> &cg);
+
+    /**
+     * Records a resolution, evicting the least recently used entry if the
+     * cache is full.
+     */
+    void insert(key_type &&key, const ndt::type &dst_tp, const std::shared_ptr<call_graph> &cg);
+
+    /**
+     * Removes all the entries.
+     */
+    void clear();
+
+    /**
+     * Invalidates the entries of every cache. Required whenever the
+     * resolution of a callable changes, e.g. after it is overloaded.
+     */
+    static void invalidate_all() { ++s_generation; }
+
+    size_t size() const;
+
+    size_t get_capacity() const { return m_capacity; }
+
+    /**
+     * Sets the maximum number of entries. A capacity of zero disables caching.
+     */
+    void set_capacity(size_t capacity);
+
+    size_t get_hit_count() const { return m_hit_count; }
+
+    size_t get_miss_count() const { return m_miss_count; }
+
+    void reset_counts() {
+      m_hit_count = 0;
+      m_miss_count = 0;
+    }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
@@ -0,0 +1,24 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/callables/default_instantiable_callable.hpp>
+#include <dynd/kernels/simd_arithmetic.hpp>
+#include <dynd/types/callable_type.hpp>
+
+namespace dynd {
+namespace nd {
+
+  template <template <typename, typename> class InlineType, dynd::detail::simd_binary_op_t Op, typename T>
+  class simd_binary_callable : public default_instantiable_callable<simd_binary_kernel<InlineType, Op, T>> {
+  public:
+    simd_binary_callable()
+        : default_instantiable_callable<simd_binary_kernel<InlineType, Op, T>>(ndt::make_type<ndt::callable_type>(
+              ndt::make_type<T>(), {ndt::make_type<T>(), ndt::make_type<T>()})) {}
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
@@ -7,13 +7,81 @@
 
 #include <dynd/callables/base_callable.hpp>
 #include <dynd/comparison.hpp>
+#include <dynd/eval/eval_context.hpp>
 #include <dynd/kernels/sort_kernel.hpp>
 
 namespace dynd {
+namespace detail {
+
+  /**
+   * Calls ``func`` with a value of the C++ type of ``id`` if it is one of the
+   * primitive types that radix_key orders, and returns whether it did.
+   */
+  template <typename FuncType>
+  bool with_primitive_type(type_id_t id, FuncType &&func) {
+    switch (id) {
+    case bool_id:
+      func(bool1());
+      return true;
+    case int8_id:
+      func(int8_t());
+      return true;
+    case int16_id:
+      func(int16_t());
+      return true;
+    case int32_id:
+      func(int32_t());
+      return true;
+    case int64_id:
+      func(int64_t());
+      return true;
+    case uint8_id:
+      func(uint8_t());
+      return true;
+    case uint16_id:
+      func(uint16_t());
+      return true;
+    case uint32_id:
+      func(uint32_t());
+      return true;
+    case uint64_id:
+      func(uint64_t());
+      return true;
+    case float32_id:
+      func(float());
+      return true;
+    case float64_id:
+      func(double());
+      return true;
+    default:
+      return false;
+    }
+  }
+
+} // namespace dynd::detail
+
 namespace nd {
 
   class sort_callable : public base_callable {
   public:
+    template <typename T>
+    static void resolve_radix(call_graph &cg) {
+      cg.emplace_back([](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                         const char *DYND_UNUSED(dst_arrmeta), size_t DYND_UNUSED(nsrc),
+                         const char *const *src_arrmeta) {
+        intptr_t size = reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->dim_size;
+        intptr_t stride = reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->stride;
+
+        std::shared_ptr<thread_pool> pool;
+        size_t nthreads = eval::default_eval_context.nthreads;
+        if (nthreads != 1 && static_cast<size_t>(size) >= 2 * eval::default_eval_context.grain_size) {
+          pool = get_thread_pool(nthreads);
+        }
+
+        kb.emplace_back<radix_sort_kernel<T>>(kernreq, size, stride, pool);
+      });
+    }
+
     sort_callable()
         : base_callable(ndt::make_type<ndt::callable_type>(ndt::make_type<void>(), {ndt::type("Fixed * Scalar")})) {}
 
@@ -22,6 +90,13 @@ namespace nd {
                       size_t DYND_UNUSED(nkwd), const array *DYND_UNUSED(kwds),
                       const std::map<std::string, ndt::type> &tp_vars) {
       const ndt::type &src0_element_tp = src_tp[0].extended<ndt::fixed_dim_type>()->get_element_type();
+
+      // Primitive types are radix sorted without a comparison kernel
+      if (dynd::detail::with_primitive_type(src0_element_tp.get_id(),
+                                            [&](auto value) { resolve_radix<decltype(value)>(cg); })) {
+        return dst_tp;
+      }
+
       size_t src0_element_data_size = src0_element_tp.get_data_size();
       cg.emplace_back([src0_element_data_size](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
                                                const char *DYND_UNUSED(dst_arrmeta), size_t DYND_UNUSED(nsrc),
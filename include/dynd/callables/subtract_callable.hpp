@@ -5,16 +5,21 @@
 
 #pragma once
 
+#include <type_traits>
+
 #include <dynd/callables/apply_function_callable.hpp>
+#include <dynd/callables/simd_binary_callable.hpp>
 #include <dynd/kernels/arithmetic.hpp>
 
 namespace dynd {
 namespace nd {
 
   template <typename Arg0Type, typename Arg1Type>
-  using subtract_callable =
+  using subtract_callable = typename std::conditional<
+      dynd::detail::has_simd_binary<Arg0Type, Arg1Type>::value,
+      simd_binary_callable<dynd::detail::inline_subtract, dynd::detail::simd_subtract, Arg0Type>,
       functional::apply_function_callable<decltype(&dynd::detail::inline_subtract<Arg0Type, Arg1Type>::f),
-                                          &dynd::detail::inline_subtract<Arg0Type, Arg1Type>::f>;
+                                          &dynd::detail::inline_subtract<Arg0Type, Arg1Type>::f>>::type;
 
 } // namespace dynd::nd
 } // namespace dynd
@@ -19,5 +19,13 @@ namespace nd {
               ndt::make_type<typename nd::sum_kernel<Arg0Type>::dst_type>(), {ndt::make_type<Arg0Type>()})) {}
   };
 
+  template <typename ResType>
+  class sum_identity_callable : public default_instantiable_callable<sum_identity_kernel<ResType>> {
+  public:
+    sum_identity_callable()
+        : default_instantiable_callable<sum_identity_kernel<ResType>>(
+              ndt::make_type<ndt::callable_type>(ndt::make_type<ResType>(), {})) {}
+  };
+
 } // namespace dynd::nd
 } // namespace dynd
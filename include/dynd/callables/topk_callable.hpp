@@ -0,0 +1,78 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <sstream>
+
+#include <dynd/assignment.hpp>
+#include <dynd/callables/sort_callable.hpp>
+#include <dynd/kernels/topk_kernel.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * Returns the ``k`` smallest elements of an array in sorted order, or the
+   * ``k`` largest in reverse sorted order when ``largest`` is true.
+   */
+  class topk_callable : public base_callable {
+    template <typename LessType>
+    static void resolve_topk(call_graph &cg, intptr_t k, bool largest) {
+      cg.emplace_back([k, largest](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                                   const char *dst_arrmeta, size_t DYND_UNUSED(nsrc),
+                                   const char *const *src_arrmeta) {
+        intptr_t root_ckb_offset = kb.size();
+        kb.emplace_back<topk_kernel<LessType>>(
+            kernreq, reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->dim_size,
+            reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->stride, k,
+            reinterpret_cast<const fixed_dim_type_arrmeta *>(dst_arrmeta)->stride, largest);
+        if (LessType::nchild != 0) {
+          kb(kernel_request_single, nullptr, nullptr, 2, nullptr);
+        }
+
+        intptr_t copy_offset = kb.size();
+        kb.get_at<topk_kernel<LessType>>(root_ckb_offset)->m_copy_offset = copy_offset - root_ckb_offset;
+
+        const char *src0_element_arrmeta = src_arrmeta[0] + sizeof(fixed_dim_type_arrmeta);
+        kb(kernel_request_single, nullptr, dst_arrmeta + sizeof(fixed_dim_type_arrmeta), 1, &src0_element_arrmeta);
+      });
+    }
+
+  public:
+    topk_callable()
+        : base_callable(ndt::type("(Fixed * Scalar, k: Int, largest: ?bool) -> Fixed * Scalar")) {}
+
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &DYND_UNUSED(dst_tp), size_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+                      size_t DYND_UNUSED(nkwd), const array *kwds, const std::map<std::string, ndt::type> &tp_vars) {
+      intptr_t size = src_tp[0].extended<ndt::fixed_dim_type>()->get_fixed_dim_size();
+      intptr_t k = kwds[0].as<intptr_t>();
+      if (k < 0 || k > size) {
+        std::stringstream ss;
+        ss << "topk cannot select " << k << " elements of a dimension of size " << size;
+        throw std::invalid_argument(ss.str());
+      }
+      bool largest = !kwds[1].is_na() && kwds[1].as<bool>();
+
+      ndt::type src0_element_tp = src_tp[0].extended<ndt::fixed_dim_type>()->get_element_type();
+      if (!dynd::detail::with_primitive_type(src0_element_tp.get_id(), [&](auto value) {
+            resolve_topk<dynd::detail::typed_less<decltype(value)>>(cg, k, largest);
+          })) {
+        resolve_topk<dynd::detail::kernel_less>(cg, k, largest);
+
+        const ndt::type child_src_tp[2] = {src0_element_tp, src0_element_tp};
+        less->resolve(this, nullptr, cg, ndt::make_type<bool1>(), 2, child_src_tp, 0, nullptr, tp_vars);
+      }
+
+      nd::array error_mode = assign_error_default;
+      assign->resolve(this, nullptr, cg, src0_element_tp, 1, &src0_element_tp, 1, &error_mode, tp_vars);
+
+      return ndt::make_fixed_dim(k, src0_element_tp);
+    }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
@@ -5,42 +5,89 @@
 
 #pragma once
 
+#include <sstream>
+
+#include <dynd/assignment.hpp>
 #include <dynd/callables/base_callable.hpp>
+#include <dynd/callables/sort_callable.hpp>
 #include <dynd/kernels/unique_kernel.hpp>
+#include <dynd/types/struct_type.hpp>
 
 namespace dynd {
 namespace nd {
 
+  /**
+   * Returns the distinct elements of an array in the order they first
+   * appear, found with a hash table. With ``Counts``, every element is
+   * returned in a ``{value, count}`` struct with its number of occurrences.
+   */
+  template <bool Counts>
   class unique_callable : public base_callable {
+    template <typename HashType>
+    static void resolve_unique(call_graph &cg, size_t src0_element_data_size, const ndt::type &dst_element_tp) {
+      cg.emplace_back([src0_element_data_size, dst_element_tp](
+          kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data), const char *dst_arrmeta,
+          size_t DYND_UNUSED(nsrc), const char *const *src_arrmeta) {
+        intptr_t size = reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->dim_size;
+        intptr_t stride = reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->stride;
+
+        std::shared_ptr<thread_pool> pool;
+        size_t nthreads = eval::default_eval_context.nthreads;
+        if (nthreads != 1 && static_cast<size_t>(size) >= 2 * eval::default_eval_context.grain_size) {
+          pool = get_thread_pool(nthreads);
+        }
+
+        // The struct arrmeta starts with the data offsets of its fields
+        const char *dst_element_arrmeta = dst_arrmeta + sizeof(ndt::var_dim_type::metadata_type);
+        const char *dst_value_arrmeta = dst_element_arrmeta;
+        intptr_t value_offset = 0, count_offset = -1;
+        if (Counts) {
+          const uintptr_t *data_offsets = reinterpret_cast<const uintptr_t *>(dst_element_arrmeta);
+          dst_value_arrmeta += dst_element_tp.extended<ndt::struct_type>()->get_arrmeta_offset(0);
+          value_offset = data_offsets[0];
+          count_offset = data_offsets[1];
+        }
+
+        kb.emplace_back<unique_kernel<HashType>>(kernreq, size, stride, src0_element_data_size, dst_arrmeta,
+                                                 value_offset, count_offset, pool);
+
+        const char *src0_element_arrmeta = src_arrmeta[0] + sizeof(fixed_dim_type_arrmeta);
+        kb(kernel_request_single, nullptr, dst_value_arrmeta, 1, &src0_element_arrmeta);
+      });
+    }
+
   public:
     unique_callable()
-        : base_callable(ndt::make_type<ndt::callable_type>(ndt::make_type<void>(), {ndt::type("Fixed * Scalar")})) {}
+        : base_callable(ndt::make_type<ndt::callable_type>(
+              Counts ? ndt::type("var * {value: Scalar, count: int64}") : ndt::type("var * Scalar"),
+              {ndt::type("Fixed * Scalar")})) {}
 
-    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &DYND_UNUSED(cg),
-                      const ndt::type &dst_tp, size_t DYND_UNUSED(nsrc), const ndt::type *DYND_UNUSED(src_tp),
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &DYND_UNUSED(dst_tp), size_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
                       size_t DYND_UNUSED(nkwd), const array *DYND_UNUSED(kwds),
-                      const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
-      return dst_tp;
-    }
+                      const std::map<std::string, ndt::type> &tp_vars) {
+      ndt::type src0_element_tp = src_tp[0].extended<ndt::fixed_dim_type>()->get_element_type();
+      size_t src0_element_data_size = src0_element_tp.get_data_size();
 
-    /*
-        void instantiate(call_node *&node, char *data, kernel_builder *ckb, const ndt::type &DYND_UNUSED(dst_tp),
-                         const char *DYND_UNUSED(dst_arrmeta), intptr_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
-                         const char *const *src_arrmeta, kernel_request_t kernreq, intptr_t nkwd, const nd::array *kwds,
-                         const std::map<std::string, ndt::type> &tp_vars) {
-          const ndt::type &src0_element_tp = src_tp[0].extended<ndt::fixed_dim_type>()->get_element_type();
-          ckb->emplace_back<unique_kernel>(
-              kernreq, reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->dim_size,
-              reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->stride,
-       src0_element_tp.get_data_size());
-          node = next(node);
-
-          const ndt::type equal_src_tp[2] = {src0_element_tp, src0_element_tp};
-          equal->instantiate(node, data, ckb, ndt::make_type<bool1>(), NULL, 2, equal_src_tp, NULL,
-       kernel_request_single,
-                             nkwd, kwds, tp_vars);
-        }
-    */
+      ndt::type dst_element_tp = src0_element_tp;
+      if (Counts) {
+        dst_element_tp = ndt::make_type<ndt::struct_type>(
+            {{src0_element_tp, "value"}, {ndt::make_type<int64_t>(), "count"}});
+      }
+
+      if (!dynd::detail::with_element_hash(src0_element_tp.get_id(), src0_element_data_size, [&](auto hash) {
+            resolve_unique<decltype(hash)>(cg, src0_element_data_size, dst_element_tp);
+          })) {
+        std::stringstream ss;
+        ss << "cannot find the distinct elements of type " << src0_element_tp << ", which has no hash";
+        throw type_error(ss.str());
+      }
+
+      nd::array error_mode = assign_error_default;
+      assign->resolve(this, nullptr, cg, src0_element_tp, 1, &src0_element_tp, 1, &error_mode, tp_vars);
+
+      return ndt::make_type<ndt::var_dim_type>(dst_element_tp);
+    }
   };
 
 } // namespace dynd::nd
@@ -13,8 +13,13 @@ namespace eval {
   struct DYNDT_API eval_context {
     // Default error mode for computations
     assign_error_mode errmode;
+    // Number of threads that elementwise kernels may split their outermost
+    // dimension across, 0 means one per hardware thread
+    size_t nthreads;
+    // Minimum number of scalar elements given to one thread at a time
+    size_t grain_size;
 
-    eval_context() : errmode(assign_error_fractional) {}
+    eval_context() : errmode(assign_error_fractional), nthreads(1), grain_size(32768) {}
   };
 
   extern DYNDT_API eval_context default_eval_context;
@@ -0,0 +1,40 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/config.hpp>
+
+namespace dynd {
+
+/**
+ * The most characters any of the number formatting functions writes.
+ */
+const int max_number_format_size = 32;
+
+/**
+ * Writes the decimal digits of an integer to ``out``, which must have room
+ * for ``max_number_format_size`` characters, and returns the end of what was
+ * written. No terminating NUL is written.
+ */
+DYNDT_API char *format_int(int64_t value, char *out);
+DYNDT_API char *format_uint(uint64_t value, char *out);
+
+/**
+ * Writes the shortest decimal number that parses back to ``value``, choosing
+ * the closest one if there are several, to ``out``, which must have room for
+ * ``max_number_format_size`` characters. Returns the end of what was written.
+ *
+ * The digits are found with the Schubfach algorithm (R. Giulietti, "The
+ * Schubfach way to render doubles", 2020), which needs no allocation and no
+ * loop over the candidate lengths. Values with a decimal exponent in [-4, 17)
+ * are written in positional notation, others in scientific notation, as in
+ * "1.5", "-0.00025", "123" and "6.02214076e+23". NaN and infinity are written
+ * as "nan", "inf" and "-inf".
+ */
+DYNDT_API char *format_float(float value, char *out);
+DYNDT_API char *format_float(double value, char *out);
+
+} // namespace dynd
@@ -158,6 +158,11 @@ namespace nd {
     /**
      * Lifts the provided callable, broadcasting it as necessary to execute
      * across the additional dimensions in the ``lifted_types`` array.
+     *
+     * When ``eval::default_eval_context.nthreads`` is not 1, the outermost
+     * dimension may be split across threads, each seeded from ``identity``
+     * and combined with ``child``. The reduction then has to be associative
+     * and commutative, and ``identity`` its neutral element.
      */
     DYND_API callable reduction(const callable &identity, const callable &child);
 
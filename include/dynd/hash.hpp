@@ -0,0 +1,173 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include <dynd/bool1.hpp>
+#include <dynd/types/string_type.hpp>
+#include <dynd/types/type_id.hpp>
+
+namespace dynd {
+namespace detail {
+
+  /**
+   * Scrambles the bits of a 64-bit value so that every input bit affects
+   * every output bit, the finalizer of splitmix64.
+   */
+  inline uint64_t hash_mix(uint64_t value) {
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+  }
+
+  /**
+   * Hashes ``size`` bytes eight at a time. Equal byte strings hash equally
+   * on the same machine, which is all the hash tables in dynd need.
+   */
+  inline uint64_t hash_bytes(const char *data, size_t size) {
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ size;
+    for (; size >= 8; data += 8, size -= 8) {
+      uint64_t word;
+      std::memcpy(&word, data, 8);
+      h = (h ^ hash_mix(word)) * 0x9e3779b97f4a7c15ULL;
+    }
+    if (size != 0) {
+      uint64_t word = 0;
+      std::memcpy(&word, data, size);
+      h = (h ^ hash_mix(word)) * 0x9e3779b97f4a7c15ULL;
+    }
+
+    return hash_mix(h);
+  }
+
+  /**
+   * Hashes and compares elements of a primitive type by value. All zeros
+   * are equal, and so are all NaNs.
+   */
+  template <typename T>
+  struct primitive_hash {
+    primitive_hash(size_t DYND_UNUSED(data_size)) {}
+
+    template <typename U = T>
+    static std::enable_if_t<std::is_floating_point<U>::value, uint64_t> bits(U value) {
+      if (value != value) {
+        return ~static_cast<uint64_t>(0);
+      }
+      if (value == 0) {
+        return 0;
+      }
+
+      std::conditional_t<sizeof(U) == 4, uint32_t, uint64_t> result;
+      std::memcpy(&result, &value, sizeof(U));
+      return result;
+    }
+
+    template <typename U = T>
+    static std::enable_if_t<!std::is_floating_point<U>::value, uint64_t> bits(U value) {
+      return static_cast<uint64_t>(value);
+    }
+
+    uint64_t hash(const char *data) const { return hash_mix(bits(*reinterpret_cast<const T *>(data))); }
+
+    bool equal(const char *lhs, const char *rhs) const {
+      return bits(*reinterpret_cast<const T *>(lhs)) == bits(*reinterpret_cast<const T *>(rhs));
+    }
+  };
+
+  template <>
+  struct primitive_hash<bool1> : primitive_hash<uint8_t> {
+    using primitive_hash<uint8_t>::primitive_hash;
+  };
+
+  /**
+   * Hashes and compares ``string`` elements by their bytes.
+   */
+  struct string_hash {
+    string_hash(size_t DYND_UNUSED(data_size)) {}
+
+    uint64_t hash(const char *data) const {
+      const string &s = *reinterpret_cast<const string *>(data);
+      return hash_bytes(s.data(), s.size());
+    }
+
+    bool equal(const char *lhs, const char *rhs) const {
+      return *reinterpret_cast<const string *>(lhs) == *reinterpret_cast<const string *>(rhs);
+    }
+  };
+
+  /**
+   * Hashes and compares elements by their ``data_size`` bytes, which suits
+   * ``fixed_string`` as it pads with zeros.
+   */
+  struct fixed_bytes_hash {
+    size_t data_size;
+
+    fixed_bytes_hash(size_t data_size) : data_size(data_size) {}
+
+    uint64_t hash(const char *data) const { return hash_bytes(data, data_size); }
+
+    bool equal(const char *lhs, const char *rhs) const { return std::memcmp(lhs, rhs, data_size) == 0; }
+  };
+
+  /**
+   * Calls ``func`` with the hasher of elements of type ``id`` and size
+   * ``data_size``, if they can be hashed, and returns whether it did.
+   */
+  template <typename FuncType>
+  bool with_element_hash(type_id_t id, size_t data_size, FuncType &&func) {
+    switch (id) {
+    case bool_id:
+      func(primitive_hash<bool1>(data_size));
+      return true;
+    case int8_id:
+      func(primitive_hash<int8_t>(data_size));
+      return true;
+    case int16_id:
+      func(primitive_hash<int16_t>(data_size));
+      return true;
+    case int32_id:
+      func(primitive_hash<int32_t>(data_size));
+      return true;
+    case int64_id:
+      func(primitive_hash<int64_t>(data_size));
+      return true;
+    case uint8_id:
+      func(primitive_hash<uint8_t>(data_size));
+      return true;
+    case uint16_id:
+      func(primitive_hash<uint16_t>(data_size));
+      return true;
+    case uint32_id:
+      func(primitive_hash<uint32_t>(data_size));
+      return true;
+    case uint64_id:
+      func(primitive_hash<uint64_t>(data_size));
+      return true;
+    case float32_id:
+      func(primitive_hash<float>(data_size));
+      return true;
+    case float64_id:
+      func(primitive_hash<double>(data_size));
+      return true;
+    case string_id:
+      func(string_hash(data_size));
+      return true;
+    case fixed_string_id:
+      func(fixed_bytes_hash(data_size));
+      return true;
+    default:
+      return false;
+    }
+  }
+
+} // namespace dynd::detail
+} // namespace dynd
@@ -5,14 +5,54 @@
 
 #pragma once
 
+#include <deque>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include <dynd/array.hpp>
 
 namespace dynd {
 namespace ndt {
   namespace json {
 
+    /**
+     * Options limiting type discovery to a sample of the records of the
+     * input, i.e. the elements of a top-level array or the lines of
+     * newline-delimited JSON.
+     */
+    struct discover_options {
+      // The number of records to discover the type from, 0 means all of them
+      intptr_t sample_size;
+      // Whether to sample records uniformly at random instead of taking the
+      // first ones
+      bool random;
+      // The seed of the random sample
+      uint32_t seed;
+
+      discover_options() : sample_size(0), random(false), seed(0) {}
+    };
+
+    /**
+     * Discovers the type of the JSON in ``[begin, end)``. Numbers are int64 or
+     * float64, null is ``?Any``, and the types of the elements of an array are
+     * merged with promote_types_inferred, falling back to a tuple if they have
+     * no common type.
+     */
     DYND_API void discover(ndt::type &res, const char *begin, const char *end);
 
+    /**
+     * Discovers the type of the JSON in ``[begin, end)`` like the version
+     * without options, but if it is an array and a sample size is given, from
+     * a sample of its elements only. The type is then ``var * T``, with ``T``
+     * merged from the sampled elements. An empty array has no elements to
+     * merge, so its type is ``()`` as without options, which promotes to the
+     * type of any other array. Taking the first elements stops reading there,
+     * while a random sample needs a pass that skips over every element.
+     */
+    DYND_API void discover(ndt::type &res, const char *begin, const char *end, const discover_options &options);
+
     inline void discover(ndt::type &res, const std::string &str) { discover(res, str.data(), str.data() + str.size()); }
 
     inline ndt::type discover(const std::string &str) {
@@ -22,6 +62,81 @@ namespace ndt {
       return res;
     }
 
+    inline ndt::type discover(const std::string &str, const discover_options &options) {
+      ndt::type res;
+      discover(res, str.data(), str.data() + str.size(), options);
+
+      return res;
+    }
+
+    /**
+     * Incremental type discovery for newline-delimited JSON, to run alongside
+     * the streaming read of the input. It is fed chunks of any size like
+     * nd::json::ndjson_parser, and merges the types of the records with
+     * promote_types_inferred as lines are completed, so that the types of
+     * separately read parts of a dataset can be merged the same way.
+     *
+     * With a sample size, either the first records are used, after which
+     * ``is_done()`` tells the reader it can stop, or a uniform random sample
+     * of the lines is kept and discovered by ``finish()``.
+     */
+    class DYND_API ndjson_discoverer {
+      discover_options m_options;
+      ndt::type m_tp;
+      // The number of records whose type is merged into m_tp, or which are
+      // sampled from
+      intptr_t m_count;
+      // The start of a line split across chunks
+      std::string m_partial;
+      // The number of lines seen, for error messages
+      intptr_t m_line;
+      // For a random sample, the line numbers and the text of the sampled
+      // records, and the state of the generator
+      std::vector<std::pair<intptr_t, std::string>> m_sample;
+      std::default_random_engine m_random;
+
+      void discover_line(const char *begin, const char *end);
+      void discover_record(intptr_t line, const char *begin, const char *end);
+
+    public:
+      ndjson_discoverer(const discover_options &options = discover_options());
+
+      /**
+       * Discovers the types of the lines completed by the chunk
+       * ``[begin, end)``.
+       */
+      void feed(const char *begin, const char *end);
+
+      void feed(const std::string &chunk) { feed(chunk.data(), chunk.data() + chunk.size()); }
+
+      /**
+       * Discovers the type of a last line without a terminating newline, and
+       * of the random sample if there is one. Call this at the end of the
+       * input.
+       */
+      void finish();
+
+      /**
+       * Whether the first ``sample_size`` records have been discovered, so
+       * the rest of the input need not be read.
+       */
+      bool is_done() const {
+        return !m_options.random && m_options.sample_size > 0 && m_count >= m_options.sample_size;
+      }
+
+      /**
+       * The type of one record, merged from all the records discovered so far,
+       * or a null type if there is none yet.
+       */
+      const ndt::type &get_type() const { return m_tp; }
+
+      /**
+       * The number of records discovered so far, or seen so far when taking
+       * a random sample.
+       */
+      intptr_t get_record_count() const { return m_count; }
+    };
+
   } // namespace dynd::ndt::json
 } // namespace dynd::ndt
 
@@ -30,6 +145,68 @@ namespace nd {
 
     DYND_API array parse2(const ndt::type &tp, const std::string &str);
 
+    /**
+     * An incremental parser of newline-delimited JSON, with one record of a
+     * fixed type per line. It is fed the input in chunks of any size, for
+     * example as they are returned by ``read()``, and parses every complete
+     * line into a batch of ``batch_size`` records. Full batches are queued as
+     * ``batch_size * tp`` arrays, to be taken with ``next()``.
+     *
+     * Only the incomplete line at the end of the last chunk is copied, so
+     * apart from the queued batches memory is bounded by the batch and the
+     * longest line. Blank lines are skipped. If a line fails to parse, the
+     * exception names its line number and the parser cannot be used further.
+     */
+    class DYND_API ndjson_parser {
+      ndt::type m_tp;
+      intptr_t m_batch_size;
+      const eval::eval_context *m_ectx;
+      // The batch being filled, and the number of records parsed into it
+      array m_batch;
+      intptr_t m_count;
+      // The start of a line split across chunks
+      std::string m_partial;
+      // The number of lines seen, for error messages
+      intptr_t m_line;
+      std::deque<array> m_batches;
+
+      void parse_line(const char *begin, const char *end);
+      void flush();
+
+    public:
+      /**
+       * \param tp  The type of one record, which must be concrete.
+       * \param batch_size  The number of records in every batch but the last.
+       * \param ectx  An evaluation context.
+       */
+      ndjson_parser(const ndt::type &tp, intptr_t batch_size,
+                    const eval::eval_context *ectx = &eval::default_eval_context);
+
+      /**
+       * Parses the lines completed by the chunk ``[begin, end)``.
+       */
+      void feed(const char *begin, const char *end);
+
+      void feed(const std::string &chunk) { feed(chunk.data(), chunk.data() + chunk.size()); }
+
+      /**
+       * Parses a last line without a terminating newline and queues the
+       * partially filled batch, if any. Call this at the end of the input.
+       */
+      void finish();
+
+      /**
+       * Moves the oldest queued batch into ``out``, returning false if there
+       * is none.
+       */
+      bool next(array &out);
+
+      /**
+       * The number of lines seen so far, including blank ones.
+       */
+      intptr_t get_line_count() const { return m_line; }
+    };
+
   } // namespace dynd::nd::json
 } // namespace dynd::nd
 
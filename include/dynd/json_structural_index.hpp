@@ -0,0 +1,115 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <dynd/config.hpp>
+
+namespace dynd {
+namespace json {
+
+  /**
+   * An index of the structure of a JSON document, built by one vectorized
+   * pass over its bytes in 64 byte blocks. It records the position of every
+   * unescaped double quote and of every bracket or brace outside a string,
+   * along with the entry that closes each string, array and object and
+   * whether a string contains escapes.
+   *
+   * A second pass then follows the JSON grammar over the document, jumping
+   * over the body of each string without escapes, and checks that it is a
+   * single valid JSON value. A valid index therefore vouches for everything
+   * between an opening character and its closing one, and the typed parser
+   * uses it to find the end of a value without reading the value, so
+   * skipping a value or the body of a string is O(1). The parser only moves
+   * forward through the document, so the index keeps a cursor and looking
+   * up the next entry is amortized O(1) as well.
+   *
+   * If the document is not valid JSON, the index is left invalid and the
+   * parser scans the bytes instead, which reports the precise error. The
+   * entries are 32-bit offsets, so a document of 4 GiB or more is not indexed
+   * and is left invalid as well.
+   *
+   * Copies share the entries, which do not change once built, but each has
+   * a cursor of its own, so threads parsing different parts of a document
+   * can each use a copy.
+   */
+  class DYND_API structural_index {
+    struct entries_type {
+      // The offsets of the structural characters, in order
+      std::vector<uint32_t> positions;
+      // For an opening quote, bracket or brace, the entry that closes it
+      std::vector<uint32_t> close;
+      // For an opening quote, whether the string contains escapes
+      std::vector<bool> escaped;
+    };
+
+    const char *m_begin;
+    const char *m_end;
+    std::shared_ptr<entries_type> m_entries;
+    size_t m_cursor;
+    bool m_valid;
+
+    void build();
+    bool validate();
+
+  public:
+    structural_index(const char *begin, const char *end);
+
+    /**
+     * Whether the quotes and brackets of the document balance, so that the
+     * index can be used.
+     */
+    bool is_valid() const { return m_valid; }
+
+    size_t size() const { return m_entries->positions.size(); }
+
+    /**
+     * A pointer to the structural character of entry ``i``.
+     */
+    const char *get(size_t i) const { return m_begin + m_entries->positions[i]; }
+
+    /**
+     * Moves the cursor to the first entry at or after ``p``, to start using
+     * the index from the middle of the document.
+     */
+    void seek(const char *p);
+
+    /**
+     * Returns the entry of the structural character at ``p``, or -1 if
+     * there is none.
+     */
+    intptr_t find(const char *p);
+
+    /**
+     * If ``p`` is the opening quote of a string, bracket of an array or brace
+     * of an object, returns a pointer to its closing character, otherwise
+     * NULL. If ``out_escaped`` is not NULL, it is set to whether the string
+     * contains escapes, or false for an array or object.
+     */
+    const char *find_close(const char *p, bool *out_escaped = NULL) {
+      intptr_t i = find(p);
+      if (i < 0 || m_entries->close[i] == 0) {
+        return NULL;
+      }
+
+      if (out_escaped != NULL) {
+        *out_escaped = m_entries->escaped[i];
+      }
+      m_cursor = m_entries->close[i];
+      return get(m_cursor);
+    }
+  };
+
+  /**
+   * The name of the instruction set the index is built with, one of "avx2",
+   * "sse2" or "none".
+   */
+  DYND_API const char *get_structural_index_isa();
+
+} // namespace dynd::json
+} // namespace dynd
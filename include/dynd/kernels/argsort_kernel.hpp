@@ -0,0 +1,72 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <vector>
+
+#include <dynd/kernels/sort_kernel.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * Writes the int64 indices that stably sort every line of a fixed
+   * dimension ``axis`` of an array with ``ndim`` fixed dimensions.
+   * ``LessType`` is detail::typed_less for primitive types and
+   * detail::kernel_less, with a ``less`` child, otherwise.
+   */
+  template <typename LessType>
+  struct argsort_kernel : base_strided_kernel<argsort_kernel<LessType>, 1> {
+    const size_t m_axis;
+    const std::vector<intptr_t> m_shape;
+    const std::vector<intptr_t> m_dst_stride;
+    const std::vector<intptr_t> m_src0_stride;
+    std::vector<int64_t> m_indices;
+
+    argsort_kernel(size_t axis, const std::vector<intptr_t> &shape, const std::vector<intptr_t> &dst_stride,
+                   const std::vector<intptr_t> &src0_stride)
+        : m_axis(axis), m_shape(shape), m_dst_stride(dst_stride), m_src0_stride(src0_stride),
+          m_indices(shape[axis]) {}
+
+    ~argsort_kernel() {
+      if (LessType::nchild != 0) {
+        this->get_child()->destroy();
+      }
+    }
+
+    void sort_line(const LessType &less, char *dst, char *src0) {
+      intptr_t dst_stride = m_dst_stride[m_axis];
+      intptr_t src0_stride = m_src0_stride[m_axis];
+
+      for (size_t i = 0; i < m_indices.size(); ++i) {
+        m_indices[i] = i;
+      }
+      std::stable_sort(m_indices.begin(), m_indices.end(), [&](int64_t lhs, int64_t rhs) {
+        return less(src0 + lhs * src0_stride, src0 + rhs * src0_stride);
+      });
+
+      for (size_t i = 0; i < m_indices.size(); ++i) {
+        *reinterpret_cast<int64_t *>(dst + i * dst_stride) = m_indices[i];
+      }
+    }
+
+    void sort_lines(const LessType &less, size_t dim, char *dst, char *src0) {
+      if (dim == m_shape.size()) {
+        sort_line(less, dst, src0);
+      } else if (dim == m_axis) {
+        sort_lines(less, dim + 1, dst, src0);
+      } else {
+        for (intptr_t i = 0; i < m_shape[dim]; ++i) {
+          sort_lines(less, dim + 1, dst + i * m_dst_stride[dim], src0 + i * m_src0_stride[dim]);
+        }
+      }
+    }
+
+    void single(char *dst, char *const *src) { sort_lines(LessType(this->get_child()), 0, dst, src[0]); }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
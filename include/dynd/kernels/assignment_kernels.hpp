@@ -85,6 +85,27 @@ inline void to_lower(std::string &s) {
 namespace nd {
   namespace detail {
 
+    /**
+     * Gets the UTF-8 text of a string element with the surrounding whitespace
+     * trimmed. A string of the UTF-8 string type is used in place, other
+     * string types are converted into ``buffer``.
+     */
+    inline void get_trimmed_utf8_string(const ndt::type &string_tp, const char *arrmeta, const char *data,
+                                        assign_error_mode error_mode, std::string &buffer, const char *&begin,
+                                        const char *&end) {
+      if (string_tp.get_id() == string_id) {
+        const string *s = reinterpret_cast<const string *>(data);
+        begin = s->begin();
+        end = s->end();
+      } else {
+        buffer = string_tp.extended<ndt::base_string_type>()->get_utf8_string(arrmeta, data, error_mode);
+        begin = buffer.data();
+        end = begin + buffer.size();
+      }
+      begin = trim_begin(begin, end);
+      end = trim_end(begin, end);
+    }
+
     template <typename ReturnType, typename Arg0Type, typename Enable = void>
     struct assignment_virtual_kernel;
 
@@ -1005,51 +1026,35 @@ namespace nd {
     template <assign_error_mode ErrorMode>
     struct assignment_kernel<string, ndt::fixed_string_type, ErrorMode>
         : base_strided_kernel<assignment_kernel<string, ndt::fixed_string_type, ErrorMode>, 1> {
-      string_encoding_t m_dst_encoding, m_src_encoding;
+      string_encoding_t m_src_encoding;
       intptr_t m_src_element_size;
-      next_unicode_codepoint_t m_next_fn;
-      append_unicode_codepoint_t m_append_fn;
+      string_transcoder m_transcode;
 
       assignment_kernel(string_encoding_t dst_encoding, string_encoding_t src_encoding, intptr_t src_element_size,
-                        next_unicode_codepoint_t next_fn, append_unicode_codepoint_t append_fn)
-          : m_dst_encoding(dst_encoding), m_src_encoding(src_encoding), m_src_element_size(src_element_size),
-            m_next_fn(next_fn), m_append_fn(append_fn) {}
+                        assign_error_mode error_mode)
+          : m_src_encoding(src_encoding), m_src_element_size(src_element_size),
+            m_transcode(dst_encoding, src_encoding, error_mode) {}
 
       void single(char *dst, char *const *src) {
         dynd::string *dst_d = reinterpret_cast<dynd::string *>(dst);
         intptr_t src_charsize = string_encoding_char_size_table[m_src_encoding];
 
-        char *dst_current;
         const char *src_begin = src[0];
         const char *src_end = src[0] + m_src_element_size;
-        next_unicode_codepoint_t next_fn = m_next_fn;
-        append_unicode_codepoint_t append_fn = m_append_fn;
-        uint32_t cp;
 
         // Allocate the initial output as the src number of characters + some padding
         dst_d->resize(((src_end - src_begin) / src_charsize + 16) * 1124 / 1024);
         char *dst_begin = dst_d->begin();
         char *dst_end = dst_d->end();
 
-        dst_current = dst_begin;
-        while (src_begin < src_end) {
-          cp = next_fn(src_begin, src_end);
-          // Append the codepoint, or increase the allocated memory as necessary
-          if (cp != 0) {
-            if (dst_end - dst_current >= 8) {
-              append_fn(cp, dst_current, dst_end);
-            } else {
-              char *dst_begin_saved = dst_begin;
-              dst_d->resize(2 * (dst_end - dst_begin));
-              dst_begin = dst_d->begin();
-              dst_end = dst_d->end();
-              dst_current = dst_begin + (dst_current - dst_begin_saved);
-
-              append_fn(cp, dst_current, dst_end);
-            }
-          } else {
-            break;
-          }
+        char *dst_current = dst_begin;
+        while (!m_transcode(dst_current, dst_end, src_begin, src_end, true) && src_begin < src_end) {
+          // Increase the allocated memory for the rest of the string
+          intptr_t size = dst_current - dst_begin;
+          dst_d->resize(2 * (dst_end - dst_begin));
+          dst_begin = dst_d->begin();
+          dst_end = dst_d->end();
+          dst_current = dst_begin + size;
         }
 
         // Shrink-wrap the memory to just fit the string
@@ -1212,19 +1217,24 @@ namespace nd {
           : src_string_tp(src_string_tp), src_arrmeta(src_arrmeta), error_mode(error_mode) {}
 
       void single(char *dst, char *const *src) {
-        // Get the string from the source
-        std::string s = reinterpret_cast<const ndt::base_string_type *>(src_string_tp.extended())
-                            ->get_utf8_string(src_arrmeta, src[0], error_mode);
-        trim(s);
-        double value = parse<double>(s.data(), s.data() + s.size());
+        std::string buffer;
+        const char *begin, *end;
+        get_trimmed_utf8_string(src_string_tp, src_arrmeta, src[0], error_mode, buffer, begin, end);
+        if (error_mode != assign_error_inexact) {
+          // Parsing straight to float rounds once, where going through double
+          // can round twice
+          float value = parse<float>(begin, end);
+          if (!std::isinf(value) || error_mode == assign_error_default || error_mode == assign_error_nocheck) {
+            *reinterpret_cast<float *>(dst) = value;
+            return;
+          }
+        }
+
+        // Check the conversion from double, which raises errors per the mode
+        double value = parse<double>(begin, end);
         // Assign double -> float according to the error mode
         char *child_src[1] = {reinterpret_cast<char *>(&value)};
         switch (error_mode) {
-        case assign_error_default:
-        case assign_error_nocheck:
-          dynd::nd::detail::assignment_kernel<float, double, assign_error_nocheck>::single_wrapper(NULL, dst,
-                                                                                                   child_src);
-          break;
         case assign_error_overflow:
           dynd::nd::detail::assignment_kernel<float, double, assign_error_overflow>::single_wrapper(NULL, dst,
                                                                                                     child_src);
@@ -1254,12 +1264,10 @@ namespace nd {
           : src_string_tp(src_string_tp), src_arrmeta(src_arrmeta), error_mode(error_mode) {}
 
       void single(char *dst, char *const *src) {
-        // Get the string from the source
-        std::string s = reinterpret_cast<const ndt::base_string_type *>(src_string_tp.extended())
-                            ->get_utf8_string(src_arrmeta, src[0], error_mode);
-        trim(s);
-        double value = parse<double>(s.data(), s.data() + s.size());
-        *reinterpret_cast<double *>(dst) = value;
+        std::string buffer;
+        const char *begin, *end;
+        get_trimmed_utf8_string(src_string_tp, src_arrmeta, src[0], error_mode, buffer, begin, end);
+        *reinterpret_cast<double *>(dst) = parse<double>(begin, end);
       }
     };
 
@@ -1295,43 +1303,26 @@ namespace nd {
     template <assign_error_mode ErrorMode>
     struct assignment_kernel<ndt::fixed_string_type, ndt::fixed_string_type, ErrorMode>
         : base_strided_kernel<assignment_kernel<ndt::fixed_string_type, ndt::fixed_string_type, ErrorMode>, 1> {
-      next_unicode_codepoint_t m_next_fn;
-      append_unicode_codepoint_t m_append_fn;
+      string_transcoder m_transcode;
       intptr_t m_dst_data_size, m_src_data_size;
       bool m_overflow_check;
 
-      assignment_kernel(next_unicode_codepoint_t next_fn, append_unicode_codepoint_t append_fn, intptr_t dst_data_size,
-                        intptr_t src_data_size, bool overflow_check)
-          : m_next_fn(next_fn), m_append_fn(append_fn), m_dst_data_size(dst_data_size), m_src_data_size(src_data_size),
-            m_overflow_check(overflow_check) {}
+      assignment_kernel(string_encoding_t dst_encoding, string_encoding_t src_encoding, assign_error_mode error_mode,
+                        intptr_t dst_data_size, intptr_t src_data_size)
+          : m_transcode(dst_encoding, src_encoding, error_mode), m_dst_data_size(dst_data_size),
+            m_src_data_size(src_data_size), m_overflow_check(error_mode != assign_error_nocheck) {}
 
       void single(char *dst, char *const *src) {
         char *dst_end = dst + m_dst_data_size;
+        const char *src_begin = src[0];
         const char *src_end = src[0] + m_src_data_size;
-        next_unicode_codepoint_t next_fn = m_next_fn;
-        append_unicode_codepoint_t append_fn = m_append_fn;
-        uint32_t cp = 0;
-
-        char *src_copy = src[0];
-        while (src_copy < src_end && dst < dst_end) {
-          cp = next_fn(const_cast<const char *&>(src_copy), src_end);
-          // The fixed_string type uses null-terminated strings
-          if (cp == 0) {
-            // Null-terminate the destination string, and we're done
-            memset(dst, 0, dst_end - dst);
-            return;
-          } else {
-            append_fn(cp, dst, dst_end);
-          }
-        }
-        if (src_copy < src_end) {
-          if (m_overflow_check) {
-            throw std::runtime_error("Input string is too large to convert to "
-                                     "destination fixed-size string");
-          }
-        } else if (dst < dst_end) {
-          memset(dst, 0, dst_end - dst);
+
+        // The fixed_string type uses null-terminated strings
+        if (!m_transcode(dst, dst_end, src_begin, src_end, true) && src_begin < src_end && m_overflow_check) {
+          throw std::runtime_error("Input string is too large to convert to "
+                                   "destination fixed-size string");
         }
+        memset(dst, 0, dst_end - dst);
       }
     };
 
@@ -1357,38 +1348,28 @@ namespace nd {
     template <assign_error_mode ErrorMode>
     struct assignment_kernel<ndt::fixed_string_type, string, ErrorMode>
         : base_strided_kernel<assignment_kernel<ndt::fixed_string_type, string, ErrorMode>, 1> {
-      next_unicode_codepoint_t m_next_fn;
-      append_unicode_codepoint_t m_append_fn;
+      string_transcoder m_transcode;
       intptr_t m_dst_data_size;
       bool m_overflow_check;
 
-      assignment_kernel(next_unicode_codepoint_t next_fn, append_unicode_codepoint_t append_fn, intptr_t dst_data_size,
-                        bool overflow_check)
-          : m_next_fn(next_fn), m_append_fn(append_fn), m_dst_data_size(dst_data_size),
-            m_overflow_check(overflow_check) {}
+      assignment_kernel(string_encoding_t dst_encoding, string_encoding_t src_encoding, assign_error_mode error_mode,
+                        intptr_t dst_data_size)
+          : m_transcode(dst_encoding, src_encoding, error_mode), m_dst_data_size(dst_data_size),
+            m_overflow_check(error_mode != assign_error_nocheck) {}
 
       void single(char *dst, char *const *src) {
         char *dst_end = dst + m_dst_data_size;
         const dynd::string *src_d = reinterpret_cast<const dynd::string *>(src[0]);
         const char *src_begin = src_d->begin();
         const char *src_end = src_d->end();
-        next_unicode_codepoint_t next_fn = m_next_fn;
-        append_unicode_codepoint_t append_fn = m_append_fn;
-        uint32_t cp;
 
-        while (src_begin < src_end && dst < dst_end) {
-          cp = next_fn(src_begin, src_end);
-          append_fn(cp, dst, dst_end);
-        }
-        if (src_begin < src_end) {
-          if (m_overflow_check) {
-            throw std::runtime_error("Input string is too large to "
-                                     "convert to destination "
-                                     "fixed-size string");
-          }
-        } else if (dst < dst_end) {
-          memset(dst, 0, dst_end - dst);
+        m_transcode(dst, dst_end, src_begin, src_end, false);
+        if (src_begin < src_end && m_overflow_check) {
+          throw std::runtime_error("Input string is too large to "
+                                   "convert to destination "
+                                   "fixed-size string");
         }
+        memset(dst, 0, dst_end - dst);
       }
     };
 
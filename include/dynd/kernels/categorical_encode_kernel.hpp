@@ -0,0 +1,33 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/kernels/base_strided_kernel.hpp>
+#include <dynd/types/categorical_type.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * Assigns elements of the category type of a categorical type to it,
+   * encoding a whole strided run at a time through its hash index.
+   */
+  struct categorical_encode_kernel : base_strided_kernel<categorical_encode_kernel, 1> {
+    const ndt::type m_dst_tp;
+    const ndt::categorical_type *m_dst_cat;
+
+    categorical_encode_kernel(const ndt::type &dst_tp)
+        : m_dst_tp(dst_tp), m_dst_cat(dst_tp.extended<ndt::categorical_type>()) {}
+
+    void single(char *dst, char *const *src) { m_dst_cat->encode(dst, 0, src[0], 0, 1); }
+
+    void strided(char *dst, intptr_t dst_stride, char *const *src, const intptr_t *src_stride, size_t count) {
+      m_dst_cat->encode(dst, dst_stride, src[0], src_stride[0], count);
+    }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
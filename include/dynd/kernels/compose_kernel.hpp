@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include <dynd/arrmeta_holder.hpp>
 #include <dynd/callable.hpp>
 #include <dynd/kernels/base_kernel.hpp>
@@ -15,36 +17,53 @@ namespace nd {
   namespace functional {
 
     /**
-     * A kernel for chaining two other kernels, using temporary buffers
-     * dynamically allocated on the heap.
+     * A kernel for chaining two other kernels, using a temporary buffer of
+     * DYND_BUFFER_CHUNK_SIZE elements that is allocated once, with the kernel.
      */
     // All methods are inlined, so this does not need to be declared DYND_API.
     struct compose_kernel : base_strided_kernel<compose_kernel, 1> {
       intptr_t second_offset; // The offset to the second child kernel
       ndt::type buffer_tp;
       arrmeta_holder buffer_arrmeta;
-      std::vector<intptr_t> buffer_shape;
+      intptr_t buffer_stride;
+      std::unique_ptr<char[]> buffer_data;
 
-      compose_kernel(const ndt::type &buffer_tp) : buffer_tp(buffer_tp)
-      {
+      compose_kernel(const ndt::type &buffer_tp)
+          : buffer_tp(buffer_tp), buffer_stride(buffer_tp.get_data_size()),
+            buffer_data(new char[DYND_BUFFER_CHUNK_SIZE * buffer_stride]()) {
         arrmeta_holder(this->buffer_tp).swap(buffer_arrmeta);
         buffer_arrmeta.arrmeta_default_construct(true);
-        buffer_shape.push_back(DYND_BUFFER_CHUNK_SIZE);
       }
 
-      ~compose_kernel()
-      {
+      ~compose_kernel() {
+        if (buffer_tp.get_flags() & type_flag_destructor) {
+          buffer_tp.extended()->data_destruct_strided(buffer_arrmeta.get(), buffer_data.get(), buffer_stride,
+                                                      DYND_BUFFER_CHUNK_SIZE);
+        }
+
         // The first child ckernel
         get_child()->destroy();
         // The second child ckernel
         get_child(second_offset)->destroy();
       }
 
-      void single(char *dst, char *const *src)
-      {
-        // Allocate a temporary buffer on the heap
-        array buffer = empty(buffer_tp);
-        char *buffer_data = buffer.data();
+      /**
+       * Returns the first ``count`` elements of the buffer to the state they
+       * had after allocation, so they can be written again.
+       */
+      void reset_buffer(size_t count) {
+        uint32_t flags = buffer_tp.get_flags();
+        if (flags & (type_flag_blockref | type_flag_zeroinit | type_flag_destructor)) {
+          if (flags & type_flag_destructor) {
+            buffer_tp.extended()->data_destruct_strided(buffer_arrmeta.get(), buffer_data.get(), buffer_stride, count);
+          }
+          buffer_tp.extended()->arrmeta_reset_buffers(buffer_arrmeta.get());
+          memset(buffer_data.get(), 0, count * buffer_stride);
+        }
+      }
+
+      void single(char *dst, char *const *src) {
+        char *buffer = buffer_data.get();
 
         kernel_prefix *first = get_child();
         kernel_single_t first_func = first->get_function<kernel_single_t>();
@@ -52,16 +71,13 @@ namespace nd {
         kernel_prefix *second = get_child(second_offset);
         kernel_single_t second_func = second->get_function<kernel_single_t>();
 
-        first_func(first, buffer_data, src);
-        second_func(second, dst, &buffer_data);
+        first_func(first, buffer, src);
+        second_func(second, dst, &buffer);
+        reset_buffer(1);
       }
 
-      void strided(char *dst, intptr_t dst_stride, char *const *src, const intptr_t *src_stride, size_t count)
-      {
-        // Allocate a temporary buffer on the heap
-        array buffer = empty(buffer_shape[0], buffer_tp);
-        char *buffer_data = buffer.data();
-        intptr_t buffer_stride = reinterpret_cast<const fixed_dim_type_arrmeta *>(buffer.get()->metadata())->stride;
+      void strided(char *dst, intptr_t dst_stride, char *const *src, const intptr_t *src_stride, size_t count) {
+        char *buffer = buffer_data.get();
 
         kernel_prefix *first = get_child();
         kernel_strided_t first_func = first->get_function<kernel_strided_t>();
@@ -72,17 +88,13 @@ namespace nd {
         char *src0 = src[0];
         intptr_t src0_stride = src_stride[0];
 
-        size_t chunk_size = std::min(count, static_cast<size_t>(DYND_BUFFER_CHUNK_SIZE));
-        first_func(first, buffer_data, buffer_stride, &src0, src_stride, chunk_size);
-        second_func(second, dst, dst_stride, &buffer_data, &buffer_stride, chunk_size);
-        count -= chunk_size;
         while (count) {
+          size_t chunk_size = std::min(count, static_cast<size_t>(DYND_BUFFER_CHUNK_SIZE));
+          first_func(first, buffer, buffer_stride, &src0, src_stride, chunk_size);
+          second_func(second, dst, dst_stride, &buffer, &buffer_stride, chunk_size);
+          reset_buffer(chunk_size);
           src0 += chunk_size * src0_stride;
           dst += chunk_size * dst_stride;
-          reset_strided_buffer_array(buffer);
-          chunk_size = std::min(count, static_cast<size_t>(DYND_BUFFER_CHUNK_SIZE));
-          first_func(first, buffer_data, buffer_stride, &src0, src_stride, chunk_size);
-          second_func(second, dst, dst_stride, &buffer_data, &buffer_stride, chunk_size);
           count -= chunk_size;
         }
       }
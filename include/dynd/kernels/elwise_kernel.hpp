@@ -5,8 +5,13 @@
 
 #pragma once
 
+#include <array>
+#include <memory>
+#include <vector>
+
 #include <dynd/callable.hpp>
 #include <dynd/kernels/base_kernel.hpp>
+#include <dynd/thread_pool.hpp>
 
 namespace dynd {
 namespace nd {
@@ -77,6 +82,91 @@ namespace nd {
       }
     };
 
+    /**
+     * Expr kernel for a strided dimension which splits the dimension into
+     * chunks that are run on a thread pool. The first worker runs the child
+     * kernel, every other worker its own instance of it, instantiated from
+     * the same call node.
+     */
+    template <size_t N>
+    struct parallel_elwise_kernel : base_strided_kernel<parallel_elwise_kernel<N>, N> {
+      intptr_t m_size;
+      intptr_t m_dst_stride;
+      std::array<intptr_t, N> m_src_stride;
+      size_t m_grain_size;
+      std::shared_ptr<thread_pool> m_pool;
+      std::vector<std::unique_ptr<kernel_builder>> m_workers;
+
+      parallel_elwise_kernel(intptr_t size, intptr_t dst_stride, const intptr_t *src_stride, size_t grain_size,
+                             const std::shared_ptr<thread_pool> &pool)
+          : m_size(size), m_dst_stride(dst_stride), m_grain_size(grain_size), m_pool(pool) {
+        std::copy(src_stride, src_stride + N, m_src_stride.begin());
+      }
+
+      ~parallel_elwise_kernel() { this->get_child()->destroy(); }
+
+      void single(char *dst, char *const *src) {
+        m_pool->parallel_for(m_size, m_grain_size, [&](size_t worker, size_t begin, size_t end) {
+          kernel_prefix *child = (worker == 0) ? this->get_child() : m_workers[worker - 1]->get();
+
+          std::array<char *, N> child_src;
+          for (size_t i = 0; i < N; ++i) {
+            child_src[i] = src[i] + begin * m_src_stride[i];
+          }
+
+          child->strided(dst + begin * m_dst_stride, m_dst_stride, child_src.data(), m_src_stride.data(), end - begin);
+        });
+      }
+    };
+
+    /**
+     * Joins up the rows of var dimensions whose elements follow each other in
+     * memory, as they do when the rows are packed one after another in a
+     * single buffer of values, so that the child kernel runs over all of them
+     * as one flat loop.
+     */
+    template <size_t N>
+    struct flat_run {
+      char *m_dst;
+      char *m_src[N];
+      intptr_t m_dst_stride;
+      const intptr_t *m_src_stride;
+      size_t m_size;
+
+      flat_run(intptr_t dst_stride, const intptr_t *src_stride)
+          : m_dst(NULL), m_dst_stride(dst_stride), m_src_stride(src_stride), m_size(0) {}
+
+      /**
+       * Adds a row of ``size`` elements with the strides of the run,
+       * first running the rows so far if it does not continue them.
+       */
+      void add(kernel_prefix *child, char *dst, char *const *src, size_t size) {
+        bool continues = m_size != 0 && dst == m_dst + m_size * m_dst_stride;
+        for (size_t j = 0; continues && j < N; ++j) {
+          continues = src[j] == m_src[j] + m_size * m_src_stride[j];
+        }
+
+        if (continues) {
+          m_size += size;
+        } else {
+          flush(child);
+          m_dst = dst;
+          memcpy(m_src, src, sizeof(m_src));
+          m_size = size;
+        }
+      }
+
+      /**
+       * Runs the rows so far.
+       */
+      void flush(kernel_prefix *child) {
+        if (m_size != 0) {
+          child->strided(m_dst, m_dst_stride, m_src, m_src_stride, m_size);
+          m_size = 0;
+        }
+      }
+    };
+
     /**
      * Generic expr kernel + destructor for a strided/var dimensions with
      * a fixed number of src operands, outputing to a strided dimension.
@@ -131,15 +221,38 @@ namespace nd {
       }
 
       void strided(char *dst, intptr_t dst_stride, char *const *src, const intptr_t *src_stride, size_t count) {
+        kernel_prefix *child = this->get_child();
+
+        // Rows that need no broadcasting go through a flat run
+        flat_run<N> run(m_dst_stride, m_src_stride);
         char *src_loop[N];
         memcpy(src_loop, src, sizeof(src_loop));
         for (size_t i = 0; i != count; ++i) {
-          single(dst, src_loop);
+          char *row_src[N];
+          bool flat = true;
+          for (size_t j = 0; j < N; ++j) {
+            if (m_is_src_var[j]) {
+              ndt::var_dim_type::data_type *vddd = reinterpret_cast<ndt::var_dim_type::data_type *>(src_loop[j]);
+              row_src[j] = vddd->begin + m_src_offset[j];
+              flat &= vddd->size == static_cast<size_t>(m_size);
+            } else {
+              row_src[j] = src_loop[j];
+            }
+          }
+
+          if (flat) {
+            run.add(child, dst, row_src, m_size);
+          } else {
+            run.flush(child);
+            single(dst, src_loop);
+          }
+
           dst += dst_stride;
-          for (int j = 0; j != N; ++j) {
+          for (size_t j = 0; j != N; ++j) {
             src_loop[j] += src_stride[j];
           }
         }
+        run.flush(child);
       }
     };
 
@@ -247,36 +360,7 @@ namespace nd {
             throw std::runtime_error("Cannot assign to an uninitialized dynd var_dim "
                                      "which has a non-zero offset");
           }
-          // Broadcast all the inputs together to get the destination size
-          dim_size = 1;
-          for (size_t i = 0; i < N; ++i) {
-            if (m_is_src_var[i]) {
-              ndt::var_dim_type::data_type *vddd = reinterpret_cast<ndt::var_dim_type::data_type *>(src[i]);
-              modified_src[i] = vddd->begin + m_src_offset[i];
-              if (vddd->size == 1) {
-                modified_src_stride[i] = 0;
-              } else if (dim_size == 1) {
-                dim_size = vddd->size;
-                modified_src_stride[i] = m_src_stride[i];
-              } else if (vddd->size == static_cast<size_t>(dim_size)) {
-                modified_src_stride[i] = m_src_stride[i];
-              } else {
-                throw broadcast_error(dim_size, vddd->size, "var", "var");
-              }
-            } else {
-              modified_src[i] = src[i];
-              if (m_src_size[i] == 1) {
-                modified_src_stride[i] = 0;
-              } else if (m_src_size[i] == dim_size) {
-                modified_src_stride[i] = m_src_stride[i];
-              } else if (dim_size == 1) {
-                dim_size = m_src_size[i];
-                modified_src_stride[i] = m_src_stride[i];
-              } else {
-                throw broadcast_error(dim_size, m_src_size[i], "var", "strided");
-              }
-            }
-          }
+          dim_size = broadcast_src(src, modified_src, modified_src_stride);
           // Allocate the output array data
           dst_vddd->begin = m_dst_memblock->alloc(dim_size);
           modified_dst = dst_vddd->begin;
@@ -290,16 +374,119 @@ namespace nd {
         opchild(child, modified_dst, modified_dst_stride, modified_src, modified_src_stride, dim_size);
       }
 
+      /**
+       * Broadcasts all the inputs together, returning the size of a new
+       * destination row.
+       */
+      intptr_t broadcast_src(char *const *src, char **modified_src, intptr_t *modified_src_stride) {
+        intptr_t dim_size = 1;
+        for (size_t i = 0; i < N; ++i) {
+          if (m_is_src_var[i]) {
+            ndt::var_dim_type::data_type *vddd = reinterpret_cast<ndt::var_dim_type::data_type *>(src[i]);
+            modified_src[i] = vddd->begin + m_src_offset[i];
+            if (vddd->size == 1) {
+              modified_src_stride[i] = 0;
+            } else if (dim_size == 1) {
+              dim_size = vddd->size;
+              modified_src_stride[i] = m_src_stride[i];
+            } else if (vddd->size == static_cast<size_t>(dim_size)) {
+              modified_src_stride[i] = m_src_stride[i];
+            } else {
+              throw broadcast_error(dim_size, vddd->size, "var", "var");
+            }
+          } else {
+            modified_src[i] = src[i];
+            if (m_src_size[i] == 1) {
+              modified_src_stride[i] = 0;
+            } else if (m_src_size[i] == dim_size) {
+              modified_src_stride[i] = m_src_stride[i];
+            } else if (dim_size == 1) {
+              dim_size = m_src_size[i];
+              modified_src_stride[i] = m_src_stride[i];
+            } else {
+              throw broadcast_error(dim_size, m_src_size[i], "var", "strided");
+            }
+          }
+        }
+
+        return dim_size;
+      }
+
       void strided(char *dst, intptr_t dst_stride, char *const *src, const intptr_t *src_stride, size_t count) {
+        kernel_prefix *child = this->get_child();
         char *src_loop[N];
+
+        // The new destination rows are allocated together, packed one after
+        // another in the order of the rows
+        if (m_dst_offset == 0) {
+          size_t total_size = 0, new_rows = 0;
+          char *row_dst = dst;
+          memcpy(src_loop, src, sizeof(src_loop));
+          for (size_t i = 0; i != count; ++i) {
+            if (reinterpret_cast<ndt::var_dim_type::data_type *>(row_dst)->begin == NULL) {
+              char *modified_src[N];
+              intptr_t modified_src_stride[N];
+              total_size += broadcast_src(src_loop, modified_src, modified_src_stride);
+              ++new_rows;
+            }
+            row_dst += dst_stride;
+            for (size_t j = 0; j != N; ++j) {
+              src_loop[j] += src_stride[j];
+            }
+          }
+
+          if (new_rows > 1 && total_size > 0) {
+            char *begin = m_dst_memblock->alloc(total_size);
+            row_dst = dst;
+            memcpy(src_loop, src, sizeof(src_loop));
+            for (size_t i = 0; i != count; ++i) {
+              ndt::var_dim_type::data_type *dst_vddd = reinterpret_cast<ndt::var_dim_type::data_type *>(row_dst);
+              if (dst_vddd->begin == NULL) {
+                char *modified_src[N];
+                intptr_t modified_src_stride[N];
+                dst_vddd->begin = begin;
+                dst_vddd->size = broadcast_src(src_loop, modified_src, modified_src_stride);
+                begin += dst_vddd->size * m_dst_stride;
+              }
+              row_dst += dst_stride;
+              for (size_t j = 0; j != N; ++j) {
+                src_loop[j] += src_stride[j];
+              }
+            }
+          }
+        }
+
+        // Rows that need no broadcasting go through a flat run
+        flat_run<N> run(m_dst_stride, m_src_stride);
         memcpy(src_loop, src, sizeof(src_loop));
         for (size_t i = 0; i != count; ++i) {
-          single(dst, src_loop);
+          ndt::var_dim_type::data_type *dst_vddd = reinterpret_cast<ndt::var_dim_type::data_type *>(dst);
+          char *row_src[N];
+          bool flat = dst_vddd->begin != NULL;
+          for (size_t j = 0; flat && j < N; ++j) {
+            if (m_is_src_var[j]) {
+              ndt::var_dim_type::data_type *vddd = reinterpret_cast<ndt::var_dim_type::data_type *>(src_loop[j]);
+              row_src[j] = vddd->begin + m_src_offset[j];
+              flat = vddd->size == dst_vddd->size;
+            } else {
+              row_src[j] = src_loop[j];
+              flat = m_src_size[j] == static_cast<intptr_t>(dst_vddd->size);
+            }
+          }
+
+          if (flat) {
+            run.add(child, dst_vddd->begin + m_dst_offset, row_src, dst_vddd->size);
+          } else {
+            run.flush(child);
+            single(dst, src_loop);
+          }
+
           dst += dst_stride;
-          for (int j = 0; j != N; ++j) {
+          for (size_t j = 0; j != N; ++j) {
             src_loop[j] += src_stride[j];
           }
         }
+        run.flush(child);
       }
     };
 
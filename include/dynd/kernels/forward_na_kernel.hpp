@@ -5,30 +5,90 @@
 
 #pragma once
 
+#include <dynd/bitmask.hpp>
 #include <dynd/option.hpp>
 
 namespace dynd {
 namespace nd {
 
+  /**
+   * Calls the child on the arguments if those at I... are available, and
+   * otherwise assigns NA to the result. All the children are strided, so a
+   * strided call finds which elements are available 64 at a time, as the
+   * bits of a bitmask word, then calls the child once for each run of
+   * available elements and assign_na once for each run of missing ones.
+   */
   template <intptr_t... I>
   struct forward_na_kernel : base_strided_kernel<forward_na_kernel<I...>, 2> {
     size_t is_na_offset[2];
     size_t assign_na_offset;
 
+    // assign_na takes no arguments, but a strided kernel may still copy them
+    static char *const *no_args() {
+      static char *const args[2] = {nullptr, nullptr};
+      return args;
+    }
+
+    static const intptr_t *zero_strides() {
+      static const intptr_t strides[2] = {0, 0};
+      return strides;
+    }
+
     void single(char *res, char *const *args) {
       for (intptr_t i : std::array<intptr_t, sizeof...(I)>({I...})) {
         bool1 is_na;
-        this->get_child(is_na_offset[i])->single(reinterpret_cast<char *>(&is_na), args + i);
+        this->get_child(is_na_offset[i])->strided(reinterpret_cast<char *>(&is_na), 0, args + i, zero_strides(), 1);
 
         // Check if args[I] is not available
         if (is_na) {
           // assign_na
-          return this->get_child(assign_na_offset)->single(res, nullptr);
+          return this->get_child(assign_na_offset)->strided(res, 0, no_args(), zero_strides(), 1);
         }
       }
 
       // call the actual child
-      this->get_child()->single(res, args);
+      this->get_child()->strided(res, 0, args, zero_strides(), 1);
+    }
+
+    void strided(char *res, intptr_t res_stride, char *const *args, const intptr_t *args_stride, size_t count) {
+      kernel_prefix *child = this->get_child();
+      kernel_prefix *assign_na = this->get_child(assign_na_offset);
+
+      char *args_loop[2] = {args[0], args[1]};
+      for (size_t offset = 0; offset < count; offset += 64) {
+        size_t size = std::min<size_t>(64, count - offset);
+        uint64_t mask = size == 64 ? ~static_cast<uint64_t>(0) : (static_cast<uint64_t>(1) << size) - 1;
+
+        // Bit j is set if element j is available in all of args[I...]
+        uint64_t avail = mask;
+        for (intptr_t i : std::array<intptr_t, sizeof...(I)>({I...})) {
+          char is_na[64];
+          this->get_child(is_na_offset[i])->strided(is_na, 1, args_loop + i, args_stride + i, size);
+          avail &= ~bitmask::pack_bytes(is_na, size);
+        }
+
+        if (avail == 0) {
+          assign_na->strided(res, res_stride, no_args(), zero_strides(), size);
+        } else {
+          for (size_t j = 0; j < size;) {
+            bool j_avail = ((avail >> j) & 1) != 0;
+            // The end of the run of elements like element j
+            uint64_t rest = (j_avail ? ~avail : avail) & mask & (~static_cast<uint64_t>(0) << j);
+            size_t end = rest == 0 ? size : bitmask::count_trailing_zeros(rest);
+            if (j_avail) {
+              char *child_args[2] = {args_loop[0] + j * args_stride[0], args_loop[1] + j * args_stride[1]};
+              child->strided(res + j * res_stride, res_stride, child_args, args_stride, end - j);
+            } else {
+              assign_na->strided(res + j * res_stride, res_stride, no_args(), zero_strides(), end - j);
+            }
+            j = end;
+          }
+        }
+
+        res += size * res_stride;
+        args_loop[0] += size * args_stride[0];
+        args_loop[1] += size * args_stride[1];
+      }
     }
   };
 
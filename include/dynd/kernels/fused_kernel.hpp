@@ -0,0 +1,122 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <dynd/kernels/base_strided_kernel.hpp>
+
+namespace dynd {
+namespace nd {
+  namespace functional {
+
+    /**
+     * A kernel that evaluates a sequence of child kernels, the steps of an
+     * expression, in chunks small enough for the intermediate results to stay
+     * in cache. Every step reads sources of the kernel or results of earlier
+     * steps, and the last step writes the destination.
+     *
+     * The intermediate results are builtin types, so their buffers need no
+     * arrmeta or destruction. They are allocated once, with the kernel.
+     */
+    // All methods are inlined, so this does not need to be declared DYND_API.
+    struct fused_kernel : base_strided_kernel<fused_kernel> {
+      // The total size of the intermediate buffers that a chunk aims for
+      static const size_t buffer_size = 16384;
+
+      size_t m_nsrc;
+      size_t m_chunk_size;
+      // For every step, the offset of its kernel and of its buffer
+      std::vector<intptr_t> m_offsets;
+      std::vector<intptr_t> m_buffer_offsets;
+      std::vector<intptr_t> m_buffer_strides;
+      // For every step, the range of its arguments in m_args, which index the
+      // sources of the kernel followed by the results of the steps
+      std::vector<size_t> m_args_begin;
+      std::vector<size_t> m_args;
+      std::unique_ptr<char[]> m_buffers;
+      std::vector<char *> m_src;
+      std::vector<intptr_t> m_src_stride;
+      // The source pointers of a call, and the zero strides of a single call
+      std::vector<char *> m_call_src;
+      std::vector<intptr_t> m_zero_stride;
+
+      fused_kernel(size_t nsrc, const std::vector<intptr_t> &data_sizes, const std::vector<size_t> &args_begin,
+                   const std::vector<size_t> &args)
+          : m_nsrc(nsrc), m_offsets(data_sizes.size()), m_buffer_offsets(data_sizes.size()),
+            m_buffer_strides(data_sizes), m_args_begin(args_begin), m_args(args), m_src(args.size()),
+            m_src_stride(args.size()), m_call_src(nsrc), m_zero_stride(nsrc) {
+        intptr_t element_size = 0;
+        for (size_t i = 0; i + 1 < data_sizes.size(); ++i) {
+          element_size += data_sizes[i];
+        }
+        m_chunk_size =
+            std::max<size_t>(buffer_size / std::max<intptr_t>(element_size, 1), DYND_BUFFER_CHUNK_SIZE);
+
+        // Every buffer starts on a cache line
+        intptr_t size = 0;
+        for (size_t i = 0; i + 1 < data_sizes.size(); ++i) {
+          m_buffer_offsets[i] = size;
+          size += (m_chunk_size * data_sizes[i] + 63) & ~static_cast<intptr_t>(63);
+        }
+        m_buffers.reset(new char[size + 63]);
+      }
+
+      ~fused_kernel() {
+        for (intptr_t offset : m_offsets) {
+          get_child(offset)->destroy();
+        }
+      }
+
+      char *get_buffer(size_t i) {
+        char *buffers = reinterpret_cast<char *>((reinterpret_cast<uintptr_t>(m_buffers.get()) + 63) &
+                                                 ~static_cast<uintptr_t>(63));
+        return buffers + m_buffer_offsets[i];
+      }
+
+      void call(array *dst, const array *src) {
+        for (size_t i = 0; i < m_nsrc; ++i) {
+          m_call_src[i] = const_cast<char *>(src[i].cdata());
+        }
+        single(const_cast<char *>(dst->cdata()), m_call_src.data());
+      }
+
+      void single(char *dst, char *const *src) { strided(dst, 0, src, m_zero_stride.data(), 1); }
+
+      void strided(char *dst, intptr_t dst_stride, char *const *src, const intptr_t *src_stride, size_t count) {
+        size_t nstep = m_offsets.size();
+        for (size_t i = 0; i < count; i += m_chunk_size) {
+          size_t chunk_size = std::min(count - i, m_chunk_size);
+          for (size_t j = 0; j < nstep; ++j) {
+            for (size_t k = m_args_begin[j]; k < m_args_begin[j + 1]; ++k) {
+              size_t arg = m_args[k];
+              if (arg < m_nsrc) {
+                m_src[k] = src[arg] + i * src_stride[arg];
+                m_src_stride[k] = src_stride[arg];
+              } else {
+                m_src[k] = get_buffer(arg - m_nsrc);
+                m_src_stride[k] = m_buffer_strides[arg - m_nsrc];
+              }
+            }
+
+            kernel_prefix *child = get_child(m_offsets[j]);
+            kernel_strided_t child_fn = child->get_function<kernel_strided_t>();
+            if (j + 1 == nstep) {
+              child_fn(child, dst + i * dst_stride, dst_stride, m_src.data() + m_args_begin[j],
+                       m_src_stride.data() + m_args_begin[j], chunk_size);
+            } else {
+              child_fn(child, get_buffer(j), m_buffer_strides[j], m_src.data() + m_args_begin[j],
+                       m_src_stride.data() + m_args_begin[j], chunk_size);
+            }
+          }
+        }
+      }
+    };
+
+  } // namespace dynd::nd::functional
+} // namespace dynd::nd
+} // namespace dynd
@@ -79,12 +79,15 @@ namespace nd {
     }
   };
 
+  // The strings that are too long for SSO are built in the arena of the array
   template <>
   struct init_kernel<std::string> {
-    init_kernel(const ndt::type &DYND_UNUSED(tp), const char *DYND_UNUSED(metadata)) {}
+    const char *metadata;
+
+    init_kernel(const ndt::type &DYND_UNUSED(tp), const char *metadata) : metadata(metadata) {}
 
     void single(char *data, const std::string &value) {
-      reinterpret_cast<string *>(data)->assign(value.data(), value.size());
+      ndt::string_type::arena_assign(metadata, data, value.data(), value.size());
     }
 
     void contiguous(char *data, const std::string *values, size_t size) {
@@ -97,9 +100,13 @@ namespace nd {
 
   template <>
   struct init_kernel<const char *> {
-    init_kernel(const ndt::type &DYND_UNUSED(tp), const char *DYND_UNUSED(metadata)) {}
+    const char *metadata;
 
-    void single(char *data, const char *value) { reinterpret_cast<string *>(data)->assign(value, strlen(value)); }
+    init_kernel(const ndt::type &DYND_UNUSED(tp), const char *metadata) : metadata(metadata) {}
+
+    void single(char *data, const char *value) {
+      ndt::string_type::arena_assign(metadata, data, value, strlen(value));
+    }
 
     void contiguous(char *data, const char *const *values, size_t size) {
       for (size_t i = 0; i < size; ++i) {
@@ -111,9 +118,11 @@ namespace nd {
 
   template <size_t N>
   struct init_kernel<char[N]> {
-    init_kernel(const ndt::type &DYND_UNUSED(tp), const char *DYND_UNUSED(metadata)) {}
+    const char *metadata;
 
-    void single(char *data, const char *value) { reinterpret_cast<string *>(data)->assign(value, N - 1); }
+    init_kernel(const ndt::type &DYND_UNUSED(tp), const char *metadata) : metadata(metadata) {}
+
+    void single(char *data, const char *value) { ndt::string_type::arena_assign(metadata, data, value, N - 1); }
 
     void contiguous(char *data, const char *const *values, size_t size) {
       for (size_t i = 0; i < size; ++i) {
@@ -125,9 +134,11 @@ namespace nd {
 
   template <size_t N>
   struct init_kernel<const char[N]> {
-    init_kernel(const ndt::type &DYND_UNUSED(tp), const char *DYND_UNUSED(metadata)) {}
+    const char *metadata;
+
+    init_kernel(const ndt::type &DYND_UNUSED(tp), const char *metadata) : metadata(metadata) {}
 
-    void single(char *data, const char *value) { reinterpret_cast<string *>(data)->assign(value, N - 1); }
+    void single(char *data, const char *value) { ndt::string_type::arena_assign(metadata, data, value, N - 1); }
 
     void contiguous(char *data, const char *const *values, size_t size) {
       for (size_t i = 0; i < size; ++i) {
@@ -214,10 +225,12 @@ namespace nd {
       typedef value_type_t<ContainerType> value_type;
 
       memory_block memblock;
+      intptr_t stride;
       nd::init_kernel<value_type> child;
 
       init_kernel(const ndt::type &tp, const char *metadata)
           : memblock(reinterpret_cast<const ndt::var_dim_type::metadata_type *>(metadata)->blockref),
+            stride(reinterpret_cast<const ndt::var_dim_type::metadata_type *>(metadata)->stride),
             child(tp.extended<ndt::base_dim_type>()->get_element_type(),
                   metadata + sizeof(ndt::var_dim_type::metadata_type)) {}
 
@@ -228,8 +241,26 @@ namespace nd {
       }
 
       void contiguous(char *data, const ContainerType *values, size_t size) {
+        // The rows are allocated together, packed one after another
+        size_t total_size = 0;
         for (size_t i = 0; i < size; ++i) {
-          single(data, values[i]);
+          total_size += values[i].size();
+        }
+
+        if (total_size == 0) {
+          for (size_t i = 0; i < size; ++i) {
+            single(data, values[i]);
+            data += sizeof(ndt::var_dim_type::data_type);
+          }
+          return;
+        }
+
+        char *begin = memblock->alloc(total_size);
+        for (size_t i = 0; i < size; ++i) {
+          reinterpret_cast<ndt::var_dim_type::data_type *>(data)->begin = begin;
+          reinterpret_cast<ndt::var_dim_type::data_type *>(data)->size = values[i].size();
+          child.contiguous(begin, values[i].begin(), values[i].size());
+          begin += values[i].size() * stride;
           data += sizeof(ndt::var_dim_type::data_type);
         }
       }
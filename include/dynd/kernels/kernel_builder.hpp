@@ -41,6 +41,11 @@ namespace nd {
 
     void emplace_back(size_t size) { storagebuf<kernel_prefix, kernel_builder>::emplace_back(size); }
 
+    /**
+     * The call node that the next kernel is instantiated from.
+     */
+    call_node *get_call() const { return m_call; }
+
     void pass() { m_call = reinterpret_cast<call_node *>(reinterpret_cast<char *>(m_call) + m_call->data_size); }
 
     void operator()(kernel_request_t kr, char *data, const char *res_metadata, size_t narg,
@@ -0,0 +1,45 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/kernels/sort_kernel.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * Reorders a dimension in place with std::nth_element, so that the element
+   * at ``kth`` is the one a sort would put there, none before it is greater
+   * and none after it is less.
+   */
+  template <typename LessType>
+  struct partition_kernel : base_strided_kernel<partition_kernel<LessType>, 1> {
+    const intptr_t src0_size;
+    const intptr_t src0_stride;
+    const intptr_t src0_element_data_size;
+    const intptr_t m_kth;
+
+    partition_kernel(intptr_t src0_size, intptr_t src0_stride, size_t src0_element_data_size, intptr_t kth)
+        : src0_size(src0_size), src0_stride(src0_stride), src0_element_data_size(src0_element_data_size),
+          m_kth(kth) {}
+
+    ~partition_kernel() {
+      if (LessType::nchild != 0) {
+        this->get_child()->destroy();
+      }
+    }
+
+    void single(char *DYND_UNUSED(dst), char *const *src) {
+      LessType less(this->get_child());
+      std::nth_element(strided_iterator(src[0], src0_element_data_size, src0_stride),
+                       strided_iterator(src[0] + m_kth * src0_stride, src0_element_data_size, src0_stride),
+                       strided_iterator(src[0] + src0_size * src0_stride, src0_element_data_size, src0_stride),
+                       [&less](char *lhs, char *rhs) { return less(lhs, rhs); });
+    }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
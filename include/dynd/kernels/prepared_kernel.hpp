@@ -0,0 +1,102 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <dynd/callable.hpp>
+#include <dynd/kernels/kernel_prefix.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * A kernel that has been resolved and instantiated once for a fixed set of
+   * destination and source types and arrmeta, and can then be executed any
+   * number of times on new data pointers.
+   *
+   * The kernel may keep pointers into the arrmeta it was prepared with (e.g.
+   * to allocate into a destination memory block), so that arrmeta must
+   * outlive the prepared kernel. Executing the kernel does not touch the
+   * callable again, so a prepared kernel is as cheap to call as the kernel
+   * itself. It is not safe to execute one prepared kernel concurrently from
+   * several threads, prepare one per thread instead.
+   */
+  class DYND_API prepared_kernel {
+    ndt::type m_dst_tp;
+    std::vector<ndt::type> m_src_tp;
+    kernel_request_t m_kernreq;
+    std::vector<array> m_arrays;
+    std::shared_ptr<call_graph> m_cg;
+    std::unique_ptr<kernel_builder> m_kb;
+
+    void prepare(const callable &f, const char *dst_arrmeta, const char *const *src_arrmeta,
+                 std::initializer_list<std::pair<const char *, array>> kwds);
+
+  public:
+    /**
+     * Prepares the kernel of ``f`` for the given types and arrmeta.
+     *
+     * \param f  The callable whose kernel is prepared.
+     * \param dst_tp  The destination type, which must be concrete.
+     * \param dst_arrmeta  The destination arrmeta.
+     * \param nsrc  The number of source arrays.
+     * \param src_tp  The source types.
+     * \param src_arrmeta  The source arrmeta.
+     * \param kernreq  Either kernel_request_single or kernel_request_strided.
+     * \param kwds  The keyword arguments, by name. Optional keywords that are
+     *              not provided are passed as missing values.
+     */
+    prepared_kernel(const callable &f, const ndt::type &dst_tp, const char *dst_arrmeta, size_t nsrc,
+                    const ndt::type *src_tp, const char *const *src_arrmeta,
+                    kernel_request_t kernreq = kernel_request_single,
+                    std::initializer_list<std::pair<const char *, array>> kwds = {});
+
+    /**
+     * Prepares the kernel of ``f`` for arrays with the same types and arrmeta
+     * as ``dst`` and ``src``. The arrays are kept alive with the kernel, but
+     * their data is never read or written by preparing it.
+     */
+    prepared_kernel(const callable &f, const array &dst, std::initializer_list<array> src,
+                    kernel_request_t kernreq = kernel_request_single,
+                    std::initializer_list<std::pair<const char *, array>> kwds = {});
+
+    // non-copyable
+    prepared_kernel(const prepared_kernel &) = delete;
+
+    prepared_kernel(prepared_kernel &&) = default;
+
+    const ndt::type &get_dst_type() const { return m_dst_tp; }
+
+    const std::vector<ndt::type> &get_src_types() const { return m_src_tp; }
+
+    kernel_request_t get_kernel_request() const { return m_kernreq; }
+
+    /**
+     * The root of the instantiated kernel.
+     */
+    kernel_prefix *get() const { return m_kb->get(); }
+
+    /**
+     * Executes a kernel prepared with kernel_request_single.
+     */
+    void single(char *dst, char *const *src) const {
+      get()->single(dst, src);
+    }
+
+    /**
+     * Executes a kernel prepared with kernel_request_strided over ``count``
+     * elements.
+     */
+    void strided(char *dst, intptr_t dst_stride, char *const *src, const intptr_t *src_stride, size_t count) const {
+      get()->strided(dst, dst_stride, src, src_stride, count);
+    }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
@@ -5,12 +5,17 @@
 
 #pragma once
 
+#include <cstring>
+#include <memory>
+#include <vector>
+
 #include <dynd/assignment.hpp>
 #include <dynd/callable.hpp>
 #include <dynd/functional.hpp>
 #include <dynd/kernels/base_kernel.hpp>
 #include <dynd/kernels/constant_kernel.hpp>
 #include <dynd/kernels/reduction_kernel_prefix.hpp>
+#include <dynd/thread_pool.hpp>
 
 namespace dynd {
 namespace nd {
@@ -361,6 +366,30 @@ namespace nd {
         kernel_prefix *child = this->get_child();
 
         char *src0 = src[0];
+        if (dst_stride == 0) {
+          // All the rows reduce into the same element, so rows packed one
+          // after another in memory are reduced in one call
+          char *run_begin = NULL;
+          size_t run_size = 0;
+          for (size_t i = 0; i != size; ++i) {
+            ndt::var_dim_type::data_type *vddd = reinterpret_cast<ndt::var_dim_type::data_type *>(src0);
+            if (run_size != 0 && vddd->begin == run_begin + run_size * src0_inner_stride) {
+              run_size += vddd->size;
+            } else {
+              if (run_size != 0) {
+                child->strided(dst, 0, &run_begin, &src0_inner_stride, run_size);
+              }
+              run_begin = vddd->begin;
+              run_size = vddd->size;
+            }
+            src0 += src_stride[0];
+          }
+          if (run_size != 0) {
+            child->strided(dst, 0, &run_begin, &src0_inner_stride, run_size);
+          }
+          return;
+        }
+
         for (size_t i = 0; i != size; ++i) {
           child->strided(dst, 0, &reinterpret_cast<ndt::var_dim_type::data_type *>(src0)->begin, &src0_inner_stride,
                          reinterpret_cast<ndt::var_dim_type::data_type *>(src0)->size);
@@ -623,6 +652,148 @@ namespace nd {
       }
     };
 
+    template <typename SelfType>
+    struct base_parallel_reduction_kernel : base_strided_kernel<SelfType, 1> {
+      intptr_t m_size;
+      intptr_t m_src_stride;
+      size_t m_grain_size;
+      std::shared_ptr<thread_pool> m_pool;
+      // The children of every worker but the first, which runs the children
+      // following this kernel
+      std::vector<std::unique_ptr<kernel_builder>> m_workers;
+
+      base_parallel_reduction_kernel(intptr_t size, intptr_t src_stride, size_t grain_size,
+                                     const std::shared_ptr<thread_pool> &pool)
+          : m_size(size), m_src_stride(src_stride), m_grain_size(grain_size), m_pool(pool) {}
+
+      kernel_prefix *get_worker_child(size_t worker) {
+        return (worker == 0) ? this->get_child() : m_workers[worker - 1]->get();
+      }
+    };
+
+    /**
+     * PARALLEL OUTERMOST DIMENSION
+     * This ckernel splits the outermost dimension of a single argument
+     * reduction across the threads of a pool. It always is the root of the
+     * kernel, so it is called once per reduction.
+     */
+    template <bool Broadcast, bool Inner>
+    struct parallel_reduction_kernel;
+
+    /**
+     * PARALLEL OUTERMOST BROADCAST DIMENSION
+     * Every thread reduces its own range of the dimension into the matching
+     * range of dst, so no combining is needed.
+     *
+     * Requirements:
+     *  - The child first_call function must be *strided*.
+     */
+    template <>
+    struct parallel_reduction_kernel<true, false>
+        : base_parallel_reduction_kernel<parallel_reduction_kernel<true, false>> {
+      intptr_t m_dst_stride;
+
+      parallel_reduction_kernel(intptr_t size, intptr_t dst_stride, intptr_t src_stride, size_t grain_size,
+                                const std::shared_ptr<thread_pool> &pool)
+          : base_parallel_reduction_kernel(size, src_stride, grain_size, pool), m_dst_stride(dst_stride) {}
+
+      ~parallel_reduction_kernel() { this->get_child()->destroy(); }
+
+      void single(char *dst, char *const *src) {
+        m_pool->parallel_for(m_size, m_grain_size, [&](size_t worker, size_t begin, size_t end) {
+          reduction_kernel_prefix *child = reinterpret_cast<reduction_kernel_prefix *>(get_worker_child(worker));
+
+          char *child_src = src[0] + begin * m_src_stride;
+          child->strided_first(dst + begin * m_dst_stride, m_dst_stride, &child_src, &m_src_stride, end - begin);
+        });
+      }
+    };
+
+    /**
+     * PARALLEL OUTERMOST REDUCTION DIMENSION
+     * The dimension is cut into a fixed number of partitions, each reduced
+     * into a partial result of its own, seeded from the identity. The
+     * partials are then combined into dst in partition order with the
+     * combine kernel, so the reduction has to be associative. Which worker
+     * runs a partition does not change the result, so floating point
+     * reductions give the same result on every run.
+     * The result must be a single builtin value.
+     *
+     * Requirements (not Inner):
+     *  - The child first_call function must be *single*.
+     *  - The child followup_call function must be *strided*.
+     *
+     * Requirements (Inner):
+     *  - The child reduction kernel must be *strided*.
+     *  - The child destination initialization kernel must be *single*.
+     *
+     *  - The combine kernel must be *single*.
+     */
+    template <bool Inner>
+    struct parallel_reduction_kernel<false, Inner>
+        : base_parallel_reduction_kernel<parallel_reduction_kernel<false, Inner>> {
+      size_t m_data_size;
+      std::unique_ptr<kernel_builder> m_combine;
+      // The offsets of the initialization kernels when Inner, relative to this
+      // kernel and to the root of a worker
+      size_t init_offset;
+      size_t worker_init_offset;
+
+      parallel_reduction_kernel(intptr_t size, intptr_t src_stride, size_t grain_size,
+                                const std::shared_ptr<thread_pool> &pool, size_t data_size)
+          : base_parallel_reduction_kernel<parallel_reduction_kernel<false, Inner>>(size, src_stride, grain_size, pool),
+            m_data_size(data_size), init_offset(0), worker_init_offset(0) {}
+
+      ~parallel_reduction_kernel() {
+        this->get_child()->destroy();
+        if (Inner) {
+          this->get_child(init_offset)->destroy();
+        }
+      }
+
+      kernel_prefix *get_worker_init_child(size_t worker) {
+        return (worker == 0) ? this->get_child(init_offset)
+                             : this->m_workers[worker - 1]->get()->get_child(worker_init_offset);
+      }
+
+      void single(char *dst, char *const *src) {
+        // A few partitions per worker, each of at least one grain, balance
+        // the load without depending on the schedule
+        size_t size = this->m_size;
+        size_t npartitions = std::min<size_t>(size / this->m_grain_size, 4 * this->m_pool->get_nthreads());
+        // Every partial gets a cache line of its own, they are written to on
+        // every accumulation
+        size_t partial_stride = (m_data_size + 63) & ~static_cast<size_t>(63);
+        std::unique_ptr<char[]> partials(new char[npartitions * partial_stride]);
+
+        this->m_pool->parallel_for(npartitions, 1, [&](size_t worker, size_t pbegin, size_t pend) {
+          for (size_t p = pbegin; p < pend; ++p) {
+            size_t begin = p * size / npartitions, end = (p + 1) * size / npartitions;
+            char *partial = partials.get() + p * partial_stride;
+            char *child_src = src[0] + begin * this->m_src_stride;
+
+            if (Inner) {
+              get_worker_init_child(worker)->single(partial, &child_src);
+              this->get_worker_child(worker)->strided(partial, 0, &child_src, &this->m_src_stride, end - begin);
+            } else {
+              reduction_kernel_prefix *child =
+                  reinterpret_cast<reduction_kernel_prefix *>(this->get_worker_child(worker));
+              child->single_first(partial, &child_src);
+              child_src += this->m_src_stride;
+              child->strided_followup(partial, 0, &child_src, &this->m_src_stride, end - begin - 1);
+            }
+          }
+        });
+
+        memcpy(dst, partials.get(), m_data_size);
+        kernel_prefix *combine = m_combine->get();
+        for (size_t p = 1; p < npartitions; ++p) {
+          char *partial = partials.get() + p * partial_stride;
+          combine->single(dst, &partial);
+        }
+      }
+    };
+
   } // namespace dynd::nd::functional
 } // namespace dynd::nd
 } // namespace dynd
@@ -0,0 +1,91 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <type_traits>
+
+#include <dynd/kernels/base_strided_kernel.hpp>
+#include <dynd/types/type_id.hpp>
+
+namespace dynd {
+namespace detail {
+
+  enum simd_binary_op_t { simd_add, simd_subtract, simd_multiply, simd_divide };
+
+  /**
+   * Whether get_simd_binary may have loops for a binary operation on
+   * ``Arg0Type`` and ``Arg1Type``.
+   */
+  template <typename Arg0Type, typename Arg1Type>
+  struct has_simd_binary
+      : std::integral_constant<bool, std::is_same<Arg0Type, Arg1Type>::value &&
+                                         (std::is_same<Arg0Type, int32_t>::value ||
+                                          std::is_same<Arg0Type, int64_t>::value ||
+                                          std::is_same<Arg0Type, float>::value || std::is_same<Arg0Type, double>::value)> {
+  };
+
+  /**
+   * A loop computing ``dst[i] = src0[i] op src1[i]`` over ``count`` contiguous
+   * elements. The source strides are either the element size or zero, for a
+   * scalar that is broadcast, but not both zero.
+   */
+  typedef void (*simd_binary_t)(char *dst, const char *src0, intptr_t src0_stride, const char *src1,
+                                intptr_t src1_stride, size_t count);
+
+  /**
+   * Returns the loop for ``op`` on the builtin type ``id``, using the widest
+   * instruction set the CPU supports, or NULL if there is none.
+   */
+  DYND_API simd_binary_t get_simd_binary(simd_binary_op_t op, type_id_t id);
+
+  /**
+   * The name of the instruction set the loops of get_simd_binary use, one of
+   * "avx512f", "avx2", "sse2" or "none".
+   */
+  DYND_API const char *get_simd_isa();
+
+} // namespace dynd::detail
+
+namespace nd {
+
+  /**
+   * A binary arithmetic kernel on one builtin type that runs the loop of
+   * get_simd_binary whenever the destination is contiguous and every source
+   * is either contiguous or a broadcast scalar.
+   */
+  template <template <typename, typename> class InlineType, dynd::detail::simd_binary_op_t Op, typename T>
+  struct simd_binary_kernel : base_strided_kernel<simd_binary_kernel<InlineType, Op, T>, 2> {
+    dynd::detail::simd_binary_t m_loop;
+
+    simd_binary_kernel() : m_loop(dynd::detail::get_simd_binary(Op, ndt::id_of<T>::value)) {}
+
+    void single(char *dst, char *const *src) {
+      *reinterpret_cast<T *>(dst) =
+          InlineType<T, T>::f(*reinterpret_cast<T *>(src[0]), *reinterpret_cast<T *>(src[1]));
+    }
+
+    void strided(char *dst, intptr_t dst_stride, char *const *src, const intptr_t *src_stride, size_t count) {
+      if (src_stride[0] == 0 && src_stride[1] == 0) {
+        // Both sources are broadcast, so every element is the same
+        T res = InlineType<T, T>::f(*reinterpret_cast<T *>(src[0]), *reinterpret_cast<T *>(src[1]));
+        for (size_t i = 0; i != count; ++i, dst += dst_stride) {
+          *reinterpret_cast<T *>(dst) = res;
+        }
+        return;
+      }
+
+      if (m_loop != NULL && dst_stride == sizeof(T) && (src_stride[0] == sizeof(T) || src_stride[0] == 0) &&
+          (src_stride[1] == sizeof(T) || src_stride[1] == 0)) {
+        m_loop(dst, src[0], src_stride[0], src[1], src_stride[1], count);
+        return;
+      }
+
+      base_strided_kernel<simd_binary_kernel, 2>::strided(dst, dst_stride, src, src_stride, count);
+    }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
@@ -5,10 +5,163 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
 #include <dynd/bytes.hpp>
 #include <dynd/kernels/base_strided_kernel.hpp>
+#include <dynd/thread_pool.hpp>
 
 namespace dynd {
+namespace detail {
+
+  /**
+   * Maps a primitive value to an unsigned key whose order is the sort order
+   * of the value. Negative floats have all their bits flipped and positive
+   * ones their sign bit, and every NaN maps to the largest key, so NaNs sort
+   * last whatever their sign or payload. Both zeros map to the key of +0.0,
+   * so values that compare equal always have equal keys.
+   */
+  template <typename T, typename Enable = void>
+  struct radix_key;
+
+  template <typename T>
+  struct radix_key<T, std::enable_if_t<std::is_unsigned<T>::value>> {
+    typedef T type;
+
+    static type get(T value) { return value; }
+  };
+
+  template <>
+  struct radix_key<bool1> {
+    typedef uint8_t type;
+
+    static type get(bool1 value) { return static_cast<type>(static_cast<bool>(value)); }
+  };
+
+  template <typename T>
+  struct radix_key<T, std::enable_if_t<std::is_signed<T>::value && std::is_integral<T>::value>> {
+    typedef std::make_unsigned_t<T> type;
+
+    static type get(T value) { return static_cast<type>(value) ^ (static_cast<type>(1) << (8 * sizeof(T) - 1)); }
+  };
+
+  template <typename T>
+  struct radix_key<T, std::enable_if_t<std::is_floating_point<T>::value>> {
+    typedef std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t> type;
+
+    static type get(T value) {
+      const type sign = static_cast<type>(1) << (8 * sizeof(T) - 1);
+      if (value != value) {
+        return ~static_cast<type>(0);
+      }
+      // -0.0 and +0.0 compare equal, so they share the key of +0.0
+      if (value == 0) {
+        return sign;
+      }
+
+      type bits;
+      std::memcpy(&bits, &value, sizeof(T));
+      return (bits & sign) ? ~bits : (bits | sign);
+    }
+  };
+
+  template <typename T>
+  bool radix_less(T lhs, T rhs) {
+    return radix_key<T>::get(lhs) < radix_key<T>::get(rhs);
+  }
+
+  /**
+   * Sorts ``size`` contiguous values in place with a least significant digit
+   * radix sort of one byte per pass, using ``tmp`` for ``size`` values of
+   * scratch. Passes where every key has the same digit are skipped. Short
+   * runs fall back to a comparison sort on the keys. Values with equal keys
+   * keep their order.
+   */
+  template <typename T>
+  void radix_sort(T *data, T *tmp, size_t size) {
+    typedef typename radix_key<T>::type key_type;
+    const size_t npass = sizeof(key_type);
+
+    if (size < 256) {
+      std::stable_sort(data, data + size, radix_less<T>);
+      return;
+    }
+
+    std::vector<size_t> counts(npass * 256);
+    for (size_t i = 0; i < size; ++i) {
+      key_type key = radix_key<T>::get(data[i]);
+      for (size_t pass = 0; pass < npass; ++pass) {
+        ++counts[pass * 256 + ((key >> (8 * pass)) & 0xFF)];
+      }
+    }
+
+    T *src = data;
+    T *dst = tmp;
+    for (size_t pass = 0; pass < npass; ++pass) {
+      size_t *count = &counts[pass * 256];
+      key_type digit = (radix_key<T>::get(src[0]) >> (8 * pass)) & 0xFF;
+      if (count[digit] == size) {
+        continue;
+      }
+
+      size_t offset = 0;
+      for (size_t j = 0; j < 256; ++j) {
+        size_t n = count[j];
+        count[j] = offset;
+        offset += n;
+      }
+
+      for (size_t i = 0; i < size; ++i) {
+        dst[count[(radix_key<T>::get(src[i]) >> (8 * pass)) & 0xFF]++] = src[i];
+      }
+      std::swap(src, dst);
+    }
+
+    if (src != data) {
+      std::memcpy(data, src, size * sizeof(T));
+    }
+  }
+
+  /**
+   * Compares two elements of a primitive type in the order of radix_key.
+   * Like kernel_less, it is constructed from the comparison child of the
+   * kernel using it, which it has none of.
+   */
+  template <typename T>
+  struct typed_less {
+    static const size_t nchild = 0;
+
+    typed_less(nd::kernel_prefix *DYND_UNUSED(child)) {}
+
+    bool operator()(const char *lhs, const char *rhs) const {
+      return radix_less(*reinterpret_cast<const T *>(lhs), *reinterpret_cast<const T *>(rhs));
+    }
+  };
+
+  /**
+   * Compares two elements of any type with a ``less`` child kernel.
+   */
+  struct kernel_less {
+    static const size_t nchild = 1;
+
+    nd::kernel_prefix *child;
+
+    kernel_less(nd::kernel_prefix *child) : child(child) {}
+
+    bool operator()(const char *lhs, const char *rhs) const {
+      bool1 dst;
+      char *src[2] = {const_cast<char *>(lhs), const_cast<char *>(rhs)};
+      child->single(reinterpret_cast<char *>(&dst), src);
+      return dst;
+    }
+  };
+
+} // namespace dynd::detail
+
 namespace nd {
 
   struct sort_kernel : base_strided_kernel<sort_kernel, 1> {
@@ -37,5 +190,119 @@ namespace nd {
     }
   };
 
+  /**
+   * Sorts a dimension of any type stably, by sorting the indices of its
+   * elements with std::stable_sort and then moving the element bytes into
+   * place, which is how std::sort moves them too.
+   */
+  struct stable_sort_kernel : base_strided_kernel<stable_sort_kernel, 1> {
+    const intptr_t src0_size;
+    const intptr_t src0_stride;
+    const intptr_t src0_element_data_size;
+
+    stable_sort_kernel(intptr_t src0_size, intptr_t src0_stride, size_t src0_element_data_size)
+        : src0_size(src0_size), src0_stride(src0_stride), src0_element_data_size(src0_element_data_size) {}
+
+    ~stable_sort_kernel() { get_child()->destroy(); }
+
+    void single(char *DYND_UNUSED(dst), char *const *src) {
+      dynd::detail::kernel_less less(get_child());
+      char *data = src[0];
+      intptr_t stride = src0_stride;
+
+      std::vector<intptr_t> indices(src0_size);
+      for (intptr_t i = 0; i < src0_size; ++i) {
+        indices[i] = i;
+      }
+      std::stable_sort(indices.begin(), indices.end(),
+                       [&](intptr_t lhs, intptr_t rhs) { return less(data + lhs * stride, data + rhs * stride); });
+
+      std::unique_ptr<char[]> buffer(new char[src0_size * src0_element_data_size]);
+      for (intptr_t i = 0; i < src0_size; ++i) {
+        std::memcpy(buffer.get() + i * src0_element_data_size, data + indices[i] * stride, src0_element_data_size);
+      }
+      for (intptr_t i = 0; i < src0_size; ++i) {
+        std::memcpy(data + i * stride, buffer.get() + i * src0_element_data_size, src0_element_data_size);
+      }
+    }
+  };
+
+  /**
+   * Sorts a dimension of a primitive type without calling a comparison
+   * kernel. The sort is stable. The values are radix sorted in place when contiguous, otherwise
+   * through a contiguous copy. Given a pool, the dimension is cut into one
+   * run per thread, the runs are radix sorted in parallel and then merged
+   * pairwise, also in parallel.
+   */
+  template <typename T>
+  struct radix_sort_kernel : base_strided_kernel<radix_sort_kernel<T>, 1> {
+    const intptr_t src0_size;
+    const intptr_t src0_stride;
+    std::shared_ptr<thread_pool> m_pool;
+
+    radix_sort_kernel(intptr_t src0_size, intptr_t src0_stride, const std::shared_ptr<thread_pool> &pool)
+        : src0_size(src0_size), src0_stride(src0_stride), m_pool(pool) {}
+
+    void sort(T *data, T *tmp, size_t size) {
+      if (!m_pool) {
+        dynd::detail::radix_sort(data, tmp, size);
+        return;
+      }
+
+      size_t nrun = m_pool->get_nthreads();
+      std::vector<size_t> bounds(nrun + 1);
+      for (size_t i = 0; i <= nrun; ++i) {
+        bounds[i] = size * i / nrun;
+      }
+
+      m_pool->parallel_for(nrun, 1, [&](size_t DYND_UNUSED(worker), size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          dynd::detail::radix_sort(data + bounds[i], tmp + bounds[i], bounds[i + 1] - bounds[i]);
+        }
+      });
+
+      T *src = data;
+      T *dst = tmp;
+      for (size_t width = 1; width < nrun; width *= 2) {
+        size_t npair = (nrun + 2 * width - 1) / (2 * width);
+        m_pool->parallel_for(npair, 1, [&](size_t DYND_UNUSED(worker), size_t begin, size_t end) {
+          for (size_t i = begin; i < end; ++i) {
+            size_t first = bounds[2 * i * width];
+            size_t middle = bounds[std::min((2 * i + 1) * width, nrun)];
+            size_t last = bounds[std::min((2 * i + 2) * width, nrun)];
+            std::merge(src + first, src + middle, src + middle, src + last, dst + first, dynd::detail::radix_less<T>);
+          }
+        });
+        std::swap(src, dst);
+      }
+
+      if (src != data) {
+        std::memcpy(data, src, size * sizeof(T));
+      }
+    }
+
+    void single(char *DYND_UNUSED(dst), char *const *src) {
+      size_t size = src0_size;
+      if (size < 2) {
+        return;
+      }
+
+      std::unique_ptr<T[]> tmp(new T[size]);
+      if (src0_stride == sizeof(T)) {
+        sort(reinterpret_cast<T *>(src[0]), tmp.get(), size);
+        return;
+      }
+
+      std::unique_ptr<T[]> data(new T[size]);
+      for (size_t i = 0; i < size; ++i) {
+        std::memcpy(&data[i], src[0] + i * src0_stride, sizeof(T));
+      }
+      sort(data.get(), tmp.get(), size);
+      for (size_t i = 0; i < size; ++i) {
+        std::memcpy(src[0] + i * src0_stride, &data[i], sizeof(T));
+      }
+    }
+  };
+
 } // namespace dynd::nd
 } // namespace dynd
@@ -29,5 +29,13 @@ namespace nd {
     }
   };
 
+  /**
+   * Writes the zero of ``ResType``, which seeds a sum.
+   */
+  template <typename ResType>
+  struct sum_identity_kernel : base_strided_kernel<sum_identity_kernel<ResType>, 0> {
+    void single(char *dst, char *const *DYND_UNUSED(src)) { *reinterpret_cast<ResType *>(dst) = ResType(0); }
+  };
+
 } // namespace dynd::nd
 } // namespace dynd
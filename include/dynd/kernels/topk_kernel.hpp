@@ -0,0 +1,87 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <vector>
+
+#include <dynd/kernels/sort_kernel.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * Selects the ``k`` smallest, or largest, elements of a dimension in sorted
+   * order without sorting or copying the rest of it. A heap holds the indices
+   * of the best ``k`` elements seen so far, and equal elements are taken in
+   * the order they appear. The selected elements are then copied with the
+   * assignment child at ``m_copy_offset``.
+   */
+  template <typename LessType>
+  struct topk_kernel : base_strided_kernel<topk_kernel<LessType>, 1> {
+    const intptr_t src0_size;
+    const intptr_t src0_stride;
+    const size_t m_k;
+    const intptr_t m_dst_stride;
+    const bool m_largest;
+    intptr_t m_copy_offset;
+    std::vector<intptr_t> m_heap;
+
+    topk_kernel(intptr_t src0_size, intptr_t src0_stride, intptr_t k, intptr_t dst_stride, bool largest)
+        : src0_size(src0_size), src0_stride(src0_stride), m_k(k), m_dst_stride(dst_stride), m_largest(largest),
+          m_copy_offset(0) {
+      m_heap.reserve(k);
+    }
+
+    ~topk_kernel() {
+      if (LessType::nchild != 0) {
+        this->get_child()->destroy();
+      }
+      this->get_child(m_copy_offset)->destroy();
+    }
+
+    void single(char *dst, char *const *src) {
+      LessType less(this->get_child());
+      char *src0 = src[0];
+      intptr_t stride = src0_stride;
+      bool largest = m_largest;
+
+      // Whether the element at ``lhs`` ranks ahead of the one at ``rhs``
+      auto ahead = [&](intptr_t lhs, intptr_t rhs) {
+        char *lhs_data = src0 + lhs * stride;
+        char *rhs_data = src0 + rhs * stride;
+        if (largest ? less(rhs_data, lhs_data) : less(lhs_data, rhs_data)) {
+          return true;
+        }
+        if (largest ? less(lhs_data, rhs_data) : less(rhs_data, lhs_data)) {
+          return false;
+        }
+        return lhs < rhs;
+      };
+
+      size_t k = m_k;
+      m_heap.clear();
+      for (intptr_t i = 0; i < src0_size; ++i) {
+        if (m_heap.size() < k) {
+          m_heap.push_back(i);
+          std::push_heap(m_heap.begin(), m_heap.end(), ahead);
+        } else if (k != 0 && ahead(i, m_heap.front())) {
+          std::pop_heap(m_heap.begin(), m_heap.end(), ahead);
+          m_heap.back() = i;
+          std::push_heap(m_heap.begin(), m_heap.end(), ahead);
+        }
+      }
+      std::sort_heap(m_heap.begin(), m_heap.end(), ahead);
+
+      kernel_prefix *copy = this->get_child(m_copy_offset);
+      for (size_t i = 0; i < m_heap.size(); ++i) {
+        char *child_src = src0 + m_heap[i] * stride;
+        copy->single(dst + i * m_dst_stride, &child_src);
+      }
+    }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
@@ -5,39 +5,189 @@
 
 #pragma once
 
-#include <dynd/bytes.hpp>
-#include <dynd/kernels/base_kernel.hpp>
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <dynd/hash.hpp>
+#include <dynd/kernels/base_strided_kernel.hpp>
+#include <dynd/thread_pool.hpp>
+#include <dynd/types/var_dim_type.hpp>
 
 namespace dynd {
+namespace detail {
+
+  /**
+   * An open addressing hash table of the distinct elements of a strided
+   * dimension, each with the index of its first occurrence and its count.
+   * Elements must be added in increasing index order.
+   */
+  template <typename HashType>
+  class distinct_table {
+    struct slot {
+      uint64_t hash;
+      intptr_t entry;
+    };
+
+    std::vector<slot> m_slots;
+    size_t m_mask;
+
+    void insert(uint64_t hash, intptr_t entry) {
+      size_t i = hash & m_mask;
+      while (m_slots[i].entry >= 0) {
+        i = (i + 1) & m_mask;
+      }
+      m_slots[i].hash = hash;
+      m_slots[i].entry = entry;
+    }
+
+    void grow() {
+      std::vector<slot> slots(2 * m_slots.size(), slot{0, -1});
+      m_slots.swap(slots);
+      m_mask = m_slots.size() - 1;
+      for (const slot &s : slots) {
+        if (s.entry >= 0) {
+          insert(s.hash, s.entry);
+        }
+      }
+    }
+
+  public:
+    std::vector<intptr_t> first;
+    std::vector<int64_t> counts;
+
+    distinct_table() : m_slots(64, slot{0, -1}), m_mask(63) {}
+
+    void add(const HashType &h, const char *src0, intptr_t src0_stride, intptr_t index, uint64_t hash) {
+      const char *data = src0 + index * src0_stride;
+      size_t i = hash & m_mask;
+      for (; m_slots[i].entry >= 0; i = (i + 1) & m_mask) {
+        if (m_slots[i].hash == hash && h.equal(src0 + first[m_slots[i].entry] * src0_stride, data)) {
+          ++counts[m_slots[i].entry];
+          return;
+        }
+      }
+
+      m_slots[i].hash = hash;
+      m_slots[i].entry = first.size();
+      first.push_back(index);
+      counts.push_back(1);
+      if (2 * first.size() > m_slots.size()) {
+        grow();
+      }
+    }
+  };
+
+} // namespace dynd::detail
+
 namespace nd {
 
-  struct unique_kernel : base_kernel<unique_kernel> {
+  /**
+   * Writes the distinct elements of a dimension, in the order they first
+   * appear, to a var dimension. The element at ``m_value_offset`` of every
+   * destination element is copied with the assignment child, and if
+   * ``m_count_offset`` is not negative, the int64 there is set to the number
+   * of occurrences.
+   *
+   * Given a pool, the elements are hashed in parallel chunks and scattered
+   * by hash into one partition per thread, then each partition is counted
+   * by its own thread and the results are put back in first occurrence
+   * order.
+   */
+  template <typename HashType>
+  struct unique_kernel : base_strided_kernel<unique_kernel<HashType>, 1> {
     const intptr_t src0_size;
     const intptr_t src0_stride;
-    const intptr_t src0_element_data_size;
-
-    unique_kernel(intptr_t src0_size, intptr_t src0_stride, size_t src0_element_data_size)
-        : src0_size(src0_size), src0_stride(src0_stride), src0_element_data_size(src0_element_data_size) {}
-
-    ~unique_kernel() { get_child()->destroy(); }
-
-    void call(array *DYND_UNUSED(dst), const array *src) {
-      kernel_prefix *child = get_child();
-      size_t new_size =
-          (std::unique(strided_iterator(src[0].data(), src0_element_data_size, src0_stride),
-                       strided_iterator(src[0].data() + src0_size * src0_stride, src0_element_data_size, src0_stride),
-                       [child](char *lhs, char *rhs) {
-                         bool1 dst;
-                         char *src[2] = {lhs, rhs};
-                         child->single(reinterpret_cast<char *>(&dst), src);
-                         return dst;
-                       }) -
-           src[0].data()) /
-          src0_stride;
-
-//      src[0]->set_type(
-  //        ndt::make_fixed_dim(new_size, src[0]->get_type().extended<ndt::fixed_dim_type>()->get_element_type()));
-      reinterpret_cast<size_stride_t *>(src[0]->metadata())->dim_size = new_size;
+    const HashType m_hash;
+    const char *m_dst_arrmeta;
+    intptr_t m_value_offset;
+    intptr_t m_count_offset;
+    std::shared_ptr<thread_pool> m_pool;
+
+    unique_kernel(intptr_t src0_size, intptr_t src0_stride, size_t src0_element_data_size, const char *dst_arrmeta,
+                  intptr_t value_offset, intptr_t count_offset, const std::shared_ptr<thread_pool> &pool)
+        : src0_size(src0_size), src0_stride(src0_stride), m_hash(src0_element_data_size), m_dst_arrmeta(dst_arrmeta),
+          m_value_offset(value_offset), m_count_offset(count_offset), m_pool(pool) {}
+
+    ~unique_kernel() { this->get_child()->destroy(); }
+
+    void count_parallel(const char *src0, std::vector<intptr_t> &first, std::vector<int64_t> &counts) {
+      size_t nparts = m_pool->get_nthreads();
+      std::vector<intptr_t> bounds(nparts + 1);
+      for (size_t i = 0; i <= nparts; ++i) {
+        bounds[i] = src0_size * i / nparts;
+      }
+
+      // The indices of every chunk that fall in every partition
+      std::vector<uint64_t> hashes(src0_size);
+      std::vector<std::vector<intptr_t>> scattered(nparts * nparts);
+      m_pool->parallel_for(nparts, 1, [&](size_t DYND_UNUSED(worker), size_t begin, size_t end) {
+        for (size_t chunk = begin; chunk < end; ++chunk) {
+          for (intptr_t i = bounds[chunk]; i < bounds[chunk + 1]; ++i) {
+            uint64_t hash = m_hash.hash(src0 + i * src0_stride);
+            hashes[i] = hash;
+            scattered[chunk * nparts + (hash >> 40) % nparts].push_back(i);
+          }
+        }
+      });
+
+      std::vector<dynd::detail::distinct_table<HashType>> tables(nparts);
+      m_pool->parallel_for(nparts, 1, [&](size_t DYND_UNUSED(worker), size_t begin, size_t end) {
+        for (size_t part = begin; part < end; ++part) {
+          for (size_t chunk = 0; chunk < nparts; ++chunk) {
+            for (intptr_t i : scattered[chunk * nparts + part]) {
+              tables[part].add(m_hash, src0, src0_stride, i, hashes[i]);
+            }
+          }
+        }
+      });
+
+      std::vector<std::pair<intptr_t, int64_t>> entries;
+      for (const dynd::detail::distinct_table<HashType> &table : tables) {
+        for (size_t j = 0; j < table.first.size(); ++j) {
+          entries.emplace_back(table.first[j], table.counts[j]);
+        }
+      }
+      std::sort(entries.begin(), entries.end());
+
+      for (const std::pair<intptr_t, int64_t> &entry : entries) {
+        first.push_back(entry.first);
+        counts.push_back(entry.second);
+      }
+    }
+
+    void single(char *dst, char *const *src) {
+      const char *src0 = src[0];
+
+      std::vector<intptr_t> first;
+      std::vector<int64_t> counts;
+      if (m_pool) {
+        count_parallel(src0, first, counts);
+      } else {
+        dynd::detail::distinct_table<HashType> table;
+        for (intptr_t i = 0; i < src0_size; ++i) {
+          table.add(m_hash, src0, src0_stride, i, m_hash.hash(src0 + i * src0_stride));
+        }
+        first.swap(table.first);
+        counts.swap(table.counts);
+      }
+
+      const ndt::var_dim_type::metadata_type *dst_md =
+          reinterpret_cast<const ndt::var_dim_type::metadata_type *>(m_dst_arrmeta);
+      ndt::var_dim_type::data_type *dst_d = reinterpret_cast<ndt::var_dim_type::data_type *>(dst);
+      dst_d->begin = dst_md->blockref->alloc(first.size());
+      dst_d->size = first.size();
+
+      kernel_prefix *copy = this->get_child();
+      for (size_t j = 0; j < first.size(); ++j) {
+        char *dst_element = dst_d->begin + j * dst_md->stride;
+        char *child_src = const_cast<char *>(src0) + first[j] * src0_stride;
+        copy->single(dst_element + m_value_offset, &child_src);
+        if (m_count_offset >= 0) {
+          *reinterpret_cast<int64_t *>(dst_element + m_count_offset) = counts[j];
+        }
+      }
     }
   };
 
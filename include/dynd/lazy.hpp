@@ -0,0 +1,93 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <dynd/callable.hpp>
+
+namespace dynd {
+namespace nd {
+  namespace lazy {
+
+    /**
+     * An expression on arrays that is evaluated only when asked for. The
+     * operators and math functions of this namespace build a graph of calls,
+     * which may share subexpressions, and ``eval`` computes it with one kernel
+     * that streams through the inputs in cache-sized chunks, so that
+     * ``a * b + c`` allocates only its result.
+     */
+    class DYND_API expr {
+    public:
+      struct node;
+
+    private:
+      std::shared_ptr<const node> m_node;
+
+    public:
+      /**
+       * An expression that is the value of an array.
+       */
+      expr(const array &value);
+
+      template <typename ValueType, typename = std::enable_if_t<std::is_convertible<ValueType, array>::value &&
+                                                                !std::is_same<std::decay_t<ValueType>, array>::value &&
+                                                                !std::is_same<std::decay_t<ValueType>, expr>::value>>
+      expr(ValueType &&value)
+          : expr(array(std::forward<ValueType>(value))) {}
+
+      /**
+       * An expression that calls ``func``, which takes no keyword arguments,
+       * with the values of ``args``.
+       */
+      expr(const callable &func, const std::vector<expr> &args);
+
+      expr(const callable &func, std::initializer_list<expr> args) : expr(func, std::vector<expr>(args)) {}
+
+      const node *get() const { return m_node.get(); }
+
+      /**
+       * Evaluates the expression into a new array. The calls are fused into
+       * one kernel when every intermediate result has a builtin type and the
+       * expression reads at most seven distinct arrays, otherwise they are
+       * evaluated one by one.
+       */
+      array eval() const;
+    };
+
+    DYND_API expr operator+(const expr &a0);
+    DYND_API expr operator-(const expr &a0);
+    DYND_API expr operator!(const expr &a0);
+
+    DYND_API expr operator+(const expr &a0, const expr &a1);
+    DYND_API expr operator-(const expr &a0, const expr &a1);
+    DYND_API expr operator*(const expr &a0, const expr &a1);
+    DYND_API expr operator/(const expr &a0, const expr &a1);
+    DYND_API expr operator%(const expr &a0, const expr &a1);
+
+    DYND_API expr operator&&(const expr &a0, const expr &a1);
+    DYND_API expr operator||(const expr &a0, const expr &a1);
+
+    DYND_API expr operator<(const expr &a0, const expr &a1);
+    DYND_API expr operator<=(const expr &a0, const expr &a1);
+    DYND_API expr operator==(const expr &a0, const expr &a1);
+    DYND_API expr operator!=(const expr &a0, const expr &a1);
+    DYND_API expr operator>=(const expr &a0, const expr &a1);
+    DYND_API expr operator>(const expr &a0, const expr &a1);
+
+    DYND_API expr sqrt(const expr &a0);
+    DYND_API expr cbrt(const expr &a0);
+    DYND_API expr exp(const expr &a0);
+    DYND_API expr sin(const expr &a0);
+    DYND_API expr cos(const expr &a0);
+    DYND_API expr tan(const expr &a0);
+    DYND_API expr pow(const expr &a0, const expr &a1);
+
+  } // namespace dynd::nd::lazy
+} // namespace dynd::nd
+} // namespace dynd
@@ -58,6 +58,15 @@ namespace nd {
      */
     virtual void reset() { throw std::runtime_error("reset is not implemented"); }
 
+    /**
+     * Takes over all the memory allocated from ``other``, a memory block of
+     * the same kind, leaving it empty. This lets variable-sized data built up
+     * separately, e.g. by different threads, end up owned by one block.
+     */
+    virtual void absorb(base_memory_block &DYND_UNUSED(other)) {
+      throw std::runtime_error("absorb is not implemented");
+    }
+
     /**
      * Does a debug dump of the memory block.
      */
@@ -6,6 +6,9 @@
 #pragma once
 
 #include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 
 #ifdef _WIN32
@@ -21,6 +24,7 @@
 #endif
 
 #include <dynd/memblock/base_memory_block.hpp>
+#include <dynd/memblock/memmap_mode.hpp>
 
 namespace dynd {
 
@@ -66,7 +70,8 @@ namespace nd {
    * Creates a memory block of a memory-mapped file.
    *
    * \param filename  The filename of the file to memory map.
-   * \param access  A combination of write_access_flag, read_access_flag, immutable_access_flag.
+   * \param mode  Whether the mapping is read-only, writes to the file, or
+   *              writes to private copies of its pages.
    * \param out_pointer  This is the pointer to the mapped memory.
    * \param out_size  This is the size of the mapped memory. Note that the size may be different
    *                  than requested by begin/end, because this function uses Python semantics to
@@ -97,10 +102,11 @@ namespace nd {
     intptr_t m_mapOffset;
 
   public:
-    memmap_memory_block(const std::string &filename, uint32_t DYND_UNUSED(access), char **out_pointer,
-                        intptr_t *out_size, intptr_t begin = 0, intptr_t end = std::numeric_limits<intptr_t>::max())
+    memmap_memory_block(const std::string &filename, memmap_mode_t mode, char **out_pointer, intptr_t *out_size,
+                        intptr_t begin = 0, intptr_t end = std::numeric_limits<intptr_t>::max())
         : m_filename(filename), m_begin(begin), m_end(end) {
-      bool readwrite = false; // ((access & nd::write_access_flag) == nd::write_access_flag);
+      bool readwrite = mode == memmap_readwrite;
+      bool copy_on_write = mode == memmap_copy_on_write;
 #ifdef WIN32
       // TODO: This function isn't quite exception-safe, use a smart pointer for the handles to fix.
 
@@ -132,7 +138,8 @@ namespace nd {
       m_mapOffset = begin - mapbegin;
       intptr_t mapsize = end - mapbegin;
 
-      m_hMapFile = CreateFileMapping(m_hFile, NULL, readwrite ? PAGE_READWRITE : PAGE_READONLY,
+      m_hMapFile = CreateFileMapping(m_hFile, NULL,
+                                     readwrite ? PAGE_READWRITE : (copy_on_write ? PAGE_WRITECOPY : PAGE_READONLY),
 #ifdef _WIN64
                                      (uint32_t)(((uint64_t)end) >> 32),
 #else
@@ -147,7 +154,8 @@ namespace nd {
       }
 
       // Create the mapped memory
-      m_mapPointer = (char *)MapViewOfFile(m_hMapFile, FILE_MAP_READ | (readwrite ? FILE_MAP_WRITE : 0),
+      m_mapPointer = (char *)MapViewOfFile(m_hMapFile, readwrite ? (FILE_MAP_READ | FILE_MAP_WRITE)
+                                                                 : (copy_on_write ? FILE_MAP_COPY : FILE_MAP_READ),
 #ifdef _WIN64
                                            (uint32_t)(((uint64_t)mapbegin) >> 32),
 #else
@@ -179,6 +187,7 @@ namespace nd {
 #endif
       struct stat st;
       if (fstat(m_fd, &st) == -1) {
+        close(m_fd);
         std::stringstream ss;
         ss << "failed to stat file \"" << m_filename << "\" for memory mapping";
         throw std::runtime_error(ss.str());
@@ -196,7 +205,16 @@ namespace nd {
       m_mapOffset = begin - mapbegin;
       intptr_t mapsize = end - mapbegin;
 
-      m_mapPointer = (char *)mmap(NULL, mapsize, PROT_READ | (readwrite ? PROT_WRITE : 0), MAP_SHARED, m_fd, mapbegin);
+      // An empty range has nothing to map
+      if (mapsize == 0) {
+        m_mapPointer = NULL;
+        *out_pointer = NULL;
+        *out_size = 0;
+        return;
+      }
+
+      m_mapPointer = (char *)mmap(NULL, mapsize, PROT_READ | ((readwrite || copy_on_write) ? PROT_WRITE : 0),
+                                  copy_on_write ? MAP_PRIVATE : MAP_SHARED, m_fd, mapbegin);
       if (m_mapPointer == (char *)MAP_FAILED) {
         close(m_fd);
         std::stringstream ss;
@@ -215,12 +233,45 @@ namespace nd {
       CloseHandle(m_hMapFile);
       CloseHandle(m_hFile);
 #else
-      intptr_t mapsize = m_end - m_begin + m_mapOffset;
-      munmap((void *)m_mapPointer, mapsize);
+      if (m_mapPointer != NULL) {
+        intptr_t mapsize = m_end - m_begin + m_mapOffset;
+        munmap((void *)m_mapPointer, mapsize);
+      }
       close(m_fd);
 #endif
     }
 
+    /**
+     * Tells the operating system how the mapped pages will be accessed. On
+     * Windows, this does nothing.
+     */
+    void advise(memmap_advice_t advice) {
+#ifndef WIN32
+      if (m_mapPointer == NULL) {
+        return;
+      }
+
+      int posix_advice;
+      switch (advice) {
+      case memmap_advice_sequential:
+        posix_advice = POSIX_MADV_SEQUENTIAL;
+        break;
+      case memmap_advice_random:
+        posix_advice = POSIX_MADV_RANDOM;
+        break;
+      case memmap_advice_willneed:
+        posix_advice = POSIX_MADV_WILLNEED;
+        break;
+      default:
+        posix_advice = POSIX_MADV_NORMAL;
+        break;
+      }
+      posix_madvise(m_mapPointer, m_end - m_begin + m_mapOffset, posix_advice);
+#else
+      (void)advice;
+#endif
+    }
+
     void debug_print(std::ostream &o, const std::string &indent) {
       o << indent << "------ memory_block at " << static_cast<const void *>(this) << "\n";
       o << indent << " reference count: " << static_cast<long>(m_use_count) << "\n";
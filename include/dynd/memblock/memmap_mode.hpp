@@ -0,0 +1,30 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * How a memory-mapped file may be written.
+   */
+  enum memmap_mode_t {
+    /** The array is read-only */
+    memmap_readonly,
+    /** Writes to the array go to the file */
+    memmap_readwrite,
+    /** Writes to the array go to private copies of the pages, the file is unchanged */
+    memmap_copy_on_write
+  };
+
+  /**
+   * How the elements of a memory-mapped file will be accessed, passed on to
+   * the operating system as a hint.
+   */
+  enum memmap_advice_t { memmap_advice_normal, memmap_advice_sequential, memmap_advice_random, memmap_advice_willneed };
+
+} // namespace dynd::nd
+} // namespace dynd
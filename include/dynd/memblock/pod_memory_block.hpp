@@ -25,8 +25,12 @@ namespace nd {
     char *m_memory_begin, *m_memory_current, *m_memory_end;
 
     pod_memory_block(size_t data_size, intptr_t data_alignment, intptr_t initial_capacity_bytes = 2048)
-        : data_size(data_size), data_alignment(data_alignment), m_total_allocated_capacity(0), m_memory_handles() {
-      append_memory(initial_capacity_bytes);
+        : data_size(data_size), data_alignment(data_alignment), m_total_allocated_capacity(0), m_memory_handles(),
+          m_memory_begin(NULL), m_memory_current(NULL), m_memory_end(NULL) {
+      // With no initial capacity, memory is only allocated on the first alloc()
+      if (initial_capacity_bytes > 0) {
+        append_memory(initial_capacity_bytes);
+      }
     }
 
     pod_memory_block(const ndt::type &tp, intptr_t initial_capacity_bytes = 2048)
@@ -140,6 +144,19 @@ namespace nd {
       m_total_allocated_capacity = m_memory_end - m_memory_begin;
     }
 
+    void absorb(base_memory_block &other) {
+      pod_memory_block &src = dynamic_cast<pod_memory_block &>(other);
+      // The chunks go in front, as the current chunk has to stay last
+      m_memory_handles.insert(m_memory_handles.begin(), src.m_memory_handles.begin(), src.m_memory_handles.end());
+      m_total_allocated_capacity += src.m_total_allocated_capacity;
+
+      src.m_memory_handles.clear();
+      src.m_total_allocated_capacity = 0;
+      src.m_memory_begin = NULL;
+      src.m_memory_current = NULL;
+      src.m_memory_end = NULL;
+    }
+
     void debug_print(std::ostream &o, const std::string &indent) {
       o << indent << "------ memory_block at " << static_cast<const void *>(this) << "\n";
       o << indent << " reference count: " << static_cast<long>(m_use_count) << "\n";
@@ -151,6 +151,19 @@ namespace nd {
       m_total_allocated_capacity = m_memory_end - m_memory_begin;
     }
 
+    void absorb(base_memory_block &other) {
+      zeroinit_memory_block &src = dynamic_cast<zeroinit_memory_block &>(other);
+      // The chunks go in front, as the current chunk has to stay last
+      m_memory_handles.insert(m_memory_handles.begin(), src.m_memory_handles.begin(), src.m_memory_handles.end());
+      m_total_allocated_capacity += src.m_total_allocated_capacity;
+
+      src.m_memory_handles.clear();
+      src.m_total_allocated_capacity = 0;
+      src.m_memory_begin = NULL;
+      src.m_memory_current = NULL;
+      src.m_memory_end = NULL;
+    }
+
     void debug_print(std::ostream &o, const std::string &indent) {
       o << indent << "------ memory_block at " << static_cast<const void *>(this) << "\n";
       o << indent << " reference count: " << static_cast<long>(m_use_count) << "\n";
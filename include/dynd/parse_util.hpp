@@ -812,6 +812,18 @@ std::enable_if_t<is_signed<T>::value && is_integral<T>::value, T> parse(const ch
   return 0;
 }
 
+/**
+ * Converts the decimal number in [begin, end), matching
+ * [+-]?(d+\.?d*|\.d+)([eE][+-]?d+)?, to the nearest float or double, with
+ * ties rounded to even. Returns false if the range is not such a number.
+ *
+ * This neither allocates nor depends on the C locale. Most inputs are
+ * converted by the Eisel-Lemire algorithm, with an exact big decimal
+ * conversion as the fallback.
+ */
+DYNDT_API bool parse_decimal_float(const char *begin, const char *end, float &out);
+DYNDT_API bool parse_decimal_float(const char *begin, const char *end, double &out);
+
 /**
  * Converts a string containing only a floating point number into
  * a float64/C double.
@@ -821,8 +833,8 @@ std::enable_if_t<is_floating_point<T>::value, T> parse(const char *begin, const
                                                        nocheck_t DYND_UNUSED(nocheck)) {
   bool negative = false;
   const char *pos = begin;
-  if (pos < end && *pos == '-') {
-    negative = true;
+  if (pos < end && (*pos == '-' || *pos == '+')) {
+    negative = *pos == '-';
     ++pos;
   }
   // First check for various NaN/Inf inputs
@@ -856,10 +868,12 @@ std::enable_if_t<is_floating_point<T>::value, T> parse(const char *begin, const
     }
   }
 
-  // TODO: use http://www.netlib.org/fp/dtoa.c
-  char *end_ptr;
-  std::string s(begin, end);
-  return strtod(s.c_str(), &end_ptr);
+  T value;
+  if (!parse_decimal_float(begin, end, value)) {
+    return 0;
+  }
+
+  return value;
 }
 
 template <typename T>
@@ -1034,8 +1048,8 @@ template <typename T>
 std::enable_if_t<is_floating_point<T>::value, T> parse(const char *begin, const char *end) {
   bool negative = false;
   const char *pos = begin;
-  if (pos < end && *pos == '-') {
-    negative = true;
+  if (pos < end && (*pos == '-' || *pos == '+')) {
+    negative = *pos == '-';
     ++pos;
   }
   // First check for various NaN/Inf inputs
@@ -1069,14 +1083,12 @@ std::enable_if_t<is_floating_point<T>::value, T> parse(const char *begin, const
     }
   }
 
-  // TODO: use http://www.netlib.org/fp/dtoa.c
-  char *end_ptr;
-  T value = strto<T>(begin, &end_ptr);
-  if (end_ptr - begin != end - begin) {
+  T value;
+  if (!parse_decimal_float(begin, end, value)) {
     std::stringstream ss;
     ss << "parse error converting string ";
     ss.write(begin, end - begin);
-    ss << " to float64";
+    ss << (sizeof(T) == sizeof(float) ? " to float32" : " to float64");
     throw std::invalid_argument(ss.str());
   }
 
@@ -0,0 +1,59 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/array.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * Ragged arrays in the offsets + values layout.
+   *
+   * An array of type "N * var * T" is packed when the data of its rows follow
+   * each other in one buffer of values, so that it is fully described by
+   * that buffer and the N + 1 offsets of where each row starts. This is the
+   * layout Arrow uses for its list arrays. The var dimension keeps its
+   * (begin, size) pairs, but kernels join up the rows of packed arrays into
+   * one flat loop over the values, and arrays built in bulk or by assignment
+   * come out packed.
+   */
+
+  /**
+   * Creates an array of type "N * var * T" whose row ``i`` is the values
+   * from ``offsets[i]`` up to ``offsets[i + 1]``. The result is a view of
+   * ``values``, which is not copied.
+   *
+   * \param offsets  A one-dimensional array of N + 1 nondecreasing integers.
+   * \param values  A one-dimensional array of type "M * T", where T has no
+   *                arrmeta.
+   */
+  DYND_API array make_ragged(const array &offsets, const array &values);
+
+  /**
+   * Returns true if ``a``, of type "N * var * T", has its rows packed one
+   * after another in a single buffer of values.
+   */
+  DYND_API bool is_packed_ragged(const array &a);
+
+  /**
+   * Returns ``a`` if it is packed, otherwise a packed copy of it.
+   */
+  DYND_API array pack_ragged(const array &a);
+
+  /**
+   * Returns the N + 1 offsets, as "N + 1 * int64", of the rows of the packed
+   * array ``a`` into its values.
+   */
+  DYND_API array ragged_offsets(const array &a);
+
+  /**
+   * Returns a view of the values of the packed array ``a`` as "M * T".
+   */
+  DYND_API array ragged_values(const array &a);
+
+} // namespace dynd::nd
+} // namespace dynd
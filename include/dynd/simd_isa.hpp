@@ -0,0 +1,47 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/config.hpp>
+
+// The vectorized loops are GCC vector extensions in functions with target
+// attributes, picked at runtime by the instruction sets the CPU supports
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DYND_SIMD_X86
+#endif
+
+namespace dynd {
+namespace detail {
+
+  /**
+   * The x86 instruction sets with vectorized loops, each a superset of the
+   * ones before it.
+   */
+  enum simd_isa_t { simd_isa_none, simd_isa_sse2, simd_isa_avx2, simd_isa_avx512f };
+
+  /**
+   * Returns the widest instruction set the CPU supports, detected on the
+   * first call. This is always simd_isa_none without DYND_SIMD_X86.
+   */
+  DYNDT_API simd_isa_t get_cpu_simd_isa();
+
+  /**
+   * Returns the widest instruction set the CPU supports up to ``max_isa``,
+   * for code with loops written for the instruction sets up to that one.
+   */
+  inline simd_isa_t get_cpu_simd_isa(simd_isa_t max_isa) {
+    simd_isa_t isa = get_cpu_simd_isa();
+    return isa < max_isa ? isa : max_isa;
+  }
+
+  /**
+   * The name of an instruction set, one of "avx512f", "avx2", "sse2" or
+   * "none".
+   */
+  DYNDT_API const char *get_simd_isa_name(simd_isa_t isa);
+
+} // namespace dynd::detail
+} // namespace dynd
@@ -10,8 +10,50 @@
 namespace dynd {
 namespace nd {
 
+  /**
+   * Sorts a one-dimensional array in place. Primitive types are radix
+   * sorted, and floating point NaNs sort last.
+   */
   extern DYND_API callable sort;
+
+  /**
+   * Sorts a one-dimensional array in place, keeping equal elements in the
+   * order they appear.
+   */
+  extern DYND_API callable stable_sort;
+
+  /**
+   * Returns the int64 indices that stably sort an array along the keyword
+   * ``axis``, the last one by default.
+   */
+  extern DYND_API callable argsort;
+
+  /**
+   * Reorders a one-dimensional array in place so that the element at the
+   * keyword index ``kth`` is in its sorted position, with none greater
+   * before it and none less after it.
+   */
+  extern DYND_API callable partition;
+
+  /**
+   * Returns the keyword ``k`` smallest elements of a one-dimensional array
+   * in sorted order, or the largest in reverse order if the keyword
+   * ``largest`` is true, without sorting the whole array.
+   */
+  extern DYND_API callable topk;
+
+  /**
+   * Returns the distinct elements of a one-dimensional array of a primitive,
+   * ``string`` or ``fixed_string`` type in the order they first appear. The
+   * array does not need to be sorted.
+   */
   extern DYND_API callable unique;
 
+  /**
+   * Like ``unique``, but returns a ``{value, count}`` struct for every
+   * distinct element with its number of occurrences.
+   */
+  extern DYND_API callable value_counts;
+
 } // namespace dynd::nd
 } // namespace dynd
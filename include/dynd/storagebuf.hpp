@@ -6,6 +6,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <map>
 #include <new>
@@ -14,6 +15,42 @@
 
 namespace dynd {
 
+/**
+ * Counts of the blocks that storagebuf has allocated on the calling thread.
+ * Only storagebuf blocks are counted, the other heap allocations made while
+ * building or calling a kernel, like those of arrays, memory blocks and
+ * standard containers, are not.
+ */
+struct storage_stats {
+  // Every block handed out
+  size_t allocs;
+  // The blocks that were not in the cache of the thread, and came from the heap
+  size_t heap_allocs;
+};
+
+/**
+ * Returns the counts of the calling thread.
+ */
+DYND_API storage_stats get_storage_stats();
+
+namespace detail {
+
+  /**
+   * Allocates a block of at least ``size`` bytes, setting ``size`` to its
+   * actual capacity. Blocks come from a cache of the calling thread that holds
+   * the blocks freed on it, so a thread that keeps building kernels of the
+   * same shape stops touching the heap.
+   */
+  DYND_API void *storage_alloc(size_t &size);
+
+  /**
+   * Frees a block of ``size`` bytes, as returned by storage_alloc, into the
+   * cache of the calling thread.
+   */
+  DYND_API void storage_free(void *ptr, size_t size);
+
+} // namespace dynd::detail
+
 template <typename PrefixType, typename DerivedType>
 class storagebuf {
 protected:
@@ -35,7 +72,7 @@ public:
 
   ~storagebuf() {
     if (!using_static_data() && m_data != NULL) {
-      free(m_data);
+      free(m_data, m_capacity);
     }
   }
 
@@ -57,39 +94,36 @@ public:
       if (requested_capacity < grown_capacity) {
         requested_capacity = grown_capacity;
       }
-      // Do a realloc
-      char *new_data = reinterpret_cast<char *>(realloc(m_data, m_capacity, requested_capacity));
+      // Do a realloc, which may round the capacity up
+      size_t new_capacity = requested_capacity;
+      char *new_data = reinterpret_cast<char *>(realloc(m_data, m_capacity, new_capacity));
       if (new_data == NULL) {
         reinterpret_cast<DerivedType *>(this)->destroy();
         m_data = NULL;
         throw std::bad_alloc();
       }
       // Zero out the newly allocated capacity
-      set(reinterpret_cast<char *>(new_data) + m_capacity, 0, requested_capacity - m_capacity);
+      set(reinterpret_cast<char *>(new_data) + m_capacity, 0, new_capacity - m_capacity);
       m_data = new_data;
-      m_capacity = requested_capacity;
+      m_capacity = new_capacity;
     }
   }
 
-  void *alloc(size_t size) { return std::malloc(size); }
+  void *alloc(size_t &size) { return detail::storage_alloc(size); }
 
-  void *realloc(void *ptr, size_t old_size, size_t new_size) {
-    if (using_static_data()) {
-      // If we were previously using the static data, do a malloc
-      void *new_data = alloc(new_size);
-      // If the allocation succeeded, copy the old data as the realloc would
-      if (new_data != NULL) {
-        copy(new_data, ptr, old_size);
-      }
-      return new_data;
-    } else {
-      return std::realloc(ptr, new_size);
+  void *realloc(void *ptr, size_t old_size, size_t &new_size) {
+    void *new_data = alloc(new_size);
+    // If the allocation succeeded, copy the old data as the realloc would
+    if (new_data != NULL) {
+      copy(new_data, ptr, old_size);
+      free(ptr, old_size);
     }
+    return new_data;
   }
 
-  void free(void *ptr) {
+  void free(void *ptr, size_t size) {
     if (!using_static_data()) {
-      std::free(ptr);
+      detail::storage_free(ptr, size);
     }
   }
 
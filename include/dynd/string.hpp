@@ -38,29 +38,41 @@ void string_concat(size_t nop, StringType &d, const StringType *const *s)
   Returns the number of times needle appears in haystack.
 */
 template <class StringType>
-intptr_t string_count(const StringType &haystack, const StringType &needle)
+intptr_t string_count(const StringType &haystack, const detail::string_searcher &needle)
 {
   detail::string_counter f;
 
-  detail::string_search(haystack, needle, f);
+  needle(haystack.begin(), haystack.size(), f);
 
   return f.finish();
 }
 
+template <class StringType>
+intptr_t string_count(const StringType &haystack, const StringType &needle)
+{
+  return string_count(haystack, detail::string_searcher(needle));
+}
+
 /*
   Returns byte index of the first occurrence of needle in haystack.
   Returns -1 if not found.
 */
 template <class StringType>
-intptr_t string_find(const StringType &haystack, const StringType &needle)
+intptr_t string_find(const StringType &haystack, const detail::string_searcher &needle)
 {
   detail::string_finder f;
 
-  detail::string_search(haystack, needle, f);
+  needle(haystack.begin(), haystack.size(), f);
 
   return f.finish();
 }
 
+template <class StringType>
+intptr_t string_find(const StringType &haystack, const StringType &needle)
+{
+  return string_find(haystack, detail::string_searcher(needle));
+}
+
 /*
   Returns byte index of the last occurrence of needle in haystack.
   Returns -1 if not found.
@@ -76,13 +88,13 @@ intptr_t string_rfind(const StringType &haystack, const StringType &needle)
 }
 
 /*
-  In string `src`, replace all non-overlapping appearances of
-  `old_str` with `new_str`, storing the result in `dst`.
+  In string `src`, replace all non-overlapping appearances of the
+  prepared needle `old_str` with `new_str`, storing the result in `dst`.
 */
 template <class StringType>
-void string_replace(StringType &dst, const StringType &src, const StringType &old_str, const StringType &new_str)
+void string_replace(StringType &dst, const StringType &src, const detail::string_searcher &old_str,
+                    const StringType &new_str)
 {
-
   if (old_str.size() == 0 || old_str.size() > src.size()) {
     /* Just copy -- there's nothing to replace */
     dst = src;
@@ -92,20 +104,8 @@ void string_replace(StringType &dst, const StringType &src, const StringType &ol
        we copy src to dst and the replace in-place. */
     dst = src;
 
-    if (old_str.size() == 1) {
-      /* Special case when old_str and new_str are both 1 character */
-      char old_chr = old_str.begin()[0];
-      char new_chr = new_str.begin()[0];
-      for (auto p = dst.begin(); p != dst.end(); ++p) {
-        if (*p == old_chr) {
-          *p = new_chr;
-        }
-      }
-    }
-    else {
-      detail::string_inplace_replacer<StringType> replacer(dst, new_str);
-      detail::string_search(src, old_str, replacer);
-    }
+    detail::string_inplace_replacer<StringType> replacer(dst, new_str);
+    old_str(src.begin(), src.size(), replacer);
   }
   else {
     /* Most general case, where old_str and new_str are different
@@ -116,12 +116,36 @@ void string_replace(StringType &dst, const StringType &src, const StringType &ol
 
     dst.resize((intptr_t)src.size() + delta);
 
-    detail::string_copy_replacer<StringType> replacer(dst, src, old_str, new_str);
-    detail::string_search(src, old_str, replacer);
+    detail::string_copy_replacer<StringType> replacer(dst, src, old_str.size(), new_str);
+    old_str(src.begin(), src.size(), replacer);
     replacer.finish();
   }
 }
 
+/*
+  In string `src`, replace all non-overlapping appearances of
+  `old_str` with `new_str`, storing the result in `dst`.
+*/
+template <class StringType>
+void string_replace(StringType &dst, const StringType &src, const StringType &old_str, const StringType &new_str)
+{
+  if (old_str.size() == 1 && new_str.size() == 1) {
+    /* Special case when old_str and new_str are both 1 character */
+    dst = src;
+
+    char old_chr = old_str.begin()[0];
+    char new_chr = new_str.begin()[0];
+    for (auto p = dst.begin(); p != dst.end(); ++p) {
+      if (*p == old_chr) {
+        *p = new_chr;
+      }
+    }
+    return;
+  }
+
+  string_replace(dst, src, detail::string_searcher(old_str), new_str);
+}
+
 /*
   Returns `true` if `str` starts with `sub`.
 */
@@ -152,15 +176,21 @@ bool string_endswith(const StringType &str, const StringType &sub)
   Returns `true` if `str` contains `sub`.
 */
 template <class StringType>
-bool string_contains(const StringType &str, const StringType &sub)
+bool string_contains(const StringType &str, const detail::string_searcher &sub)
 {
   detail::string_contains f;
 
-  detail::string_search(str, sub, f);
+  sub(str.begin(), str.size(), f);
 
   return f.finish();
 }
 
+template <class StringType>
+bool string_contains(const StringType &str, const StringType &sub)
+{
+  return string_contains(str, detail::string_searcher(sub));
+}
+
 namespace nd {
 
   extern DYND_API callable string_concatenation;
@@ -98,6 +98,50 @@ get_next_unicode_codepoint_function(string_encoding_t encoding, assign_error_mod
 DYNDT_API append_unicode_codepoint_t
 get_append_unicode_codepoint_function(string_encoding_t encoding, assign_error_mode errmode);
 
+/**
+ * Returns a pointer to the first byte of [begin, end) that does not start a
+ * valid UTF-8 sequence, or ``end`` if the whole range is valid. Runs of ASCII
+ * are skipped a vector at a time, and multi-byte sequences are checked inline.
+ */
+DYNDT_API const char *validate_utf8(const char *begin, const char *end);
+
+/**
+ * Converts whole buffers of text from one encoding to another.
+ *
+ * ASCII characters are the same code unit in every encoding, so runs of them
+ * are found a vector at a time (with SSE2 or AVX2 where the CPU supports it)
+ * and copied, widened or narrowed in bulk. Between UTF-8 and UTF-8, UTF-16 or
+ * UTF-32, runs of valid multi-byte characters are decoded and encoded inline.
+ * The other characters go one code point at a time through the next and append
+ * functions of the encodings, which do the validation according to the error
+ * mode.
+ */
+class DYNDT_API string_transcoder {
+  typedef size_t (*ascii_run_t)(const char *src, size_t count, bool stop_at_null);
+  typedef void (*copy_units_t)(char *dst, const char *src, size_t count);
+  typedef void (*multibyte_t)(char *&dst, char *dst_end, const char *&src, const char *src_end);
+
+  string_encoding_t m_dst_encoding;
+  intptr_t m_dst_unit_size, m_src_unit_size;
+  next_unicode_codepoint_t m_next_fn;
+  append_unicode_codepoint_t m_append_fn;
+  ascii_run_t m_ascii_run;
+  copy_units_t m_copy_units;
+  multibyte_t m_multibyte;
+
+public:
+  string_transcoder(string_encoding_t dst_encoding, string_encoding_t src_encoding, assign_error_mode errmode);
+
+  /**
+   * Converts the characters of [src, src_end) into [dst, dst_end), advancing
+   * ``src`` and ``dst`` past what was converted. This stops at the end of the
+   * source, before a character that does not fit in the destination or, if
+   * ``stop_at_null`` is set, before a null character, in which case it
+   * returns true.
+   */
+  bool operator()(char *&dst, char *dst_end, const char *&src, const char *src_end, bool stop_at_null) const;
+};
+
 /**
  * Converts a string buffer provided as a range of bytes into a std::string as UTF8.
  */
@@ -5,6 +5,10 @@
 
 #pragma once
 
+#include <cstring>
+
+#include <dynd/config.hpp>
+
 ////////////////////////////////////////////////////////////
 // String algorithms
 
@@ -43,7 +47,7 @@ namespace detail {
     else {
       const char *s = haystack;
       while (s < haystack + n) {
-        void *candidate = memchr((void *)s, needle, n);
+        void *candidate = memchr((void *)s, needle, haystack + n - s);
         if (candidate == NULL) {
           return;
         }
@@ -59,7 +63,7 @@ namespace detail {
   template <class match_handler>
   void string_search_1char_reverse(const char *haystack, size_t n, char needle, match_handler &handle_match)
   {
-    for (size_t i = n - 1; i <= 0; --i) {
+    for (size_t i = n; i-- > 0;) {
       if (haystack[i] == needle) {
         if (handle_match(i)) {
           return;
@@ -68,103 +72,75 @@ namespace detail {
     }
   }
 
-  template <class StringType, class match_handler>
-  void string_search(const StringType &haystack, const StringType &needle, match_handler &handle_match)
-  {
-    /*
-      This is a mostly direct copy of the algorithm by Fredrik Lundh in
-      CPython, as found here:
-
-      http://hg.python.org/cpython/file/3.5/Objects/stringlib/fastsearch.h
-
-      and described here:
-
-      http://effbot.org/zone/stringlib.htm
+  /**
+   * Returns the first pointer ``p`` in [begin, end) with ``p[0] == first`` and
+   * ``p[offset] == last``, or NULL if there is none. The bytes up to
+   * ``end + offset`` must be readable. This compares a vector of candidate
+   * first bytes and a vector of candidate last bytes at once, using the
+   * widest instruction set the CPU supports.
+   */
+  DYND_API const char *find_first_last(const char *begin, const char *end, char first, char last, size_t offset);
+
+  /**
+   * A needle prepared for searching, which is done once so that the same
+   * needle can be searched for in many haystacks.
+   *
+   * A needle of one byte is searched for with ``memchr``. A longer needle is
+   * searched for by its first and last bytes with ``find_first_last``, which
+   * only leaves candidates whose middle bytes need to be compared. Matches
+   * are reported in order and do not overlap.
+   */
+  class string_searcher {
+    const char *m_needle;
+    size_t m_size;
 
-      The main differences are a result of handling UTF-8 only, and not
-      three different char widths as in Python.
-
-      There are probably further optimizations possible here, given that
-      this is UTF-8. For example, we could skip over multi-byte
-      sequences when a match fails, but this doesn't currently do that.
-    */
-    const char *s = haystack.begin();
-    const char *p = needle.begin();
-    size_t n = haystack.size();
-    size_t m = needle.size();
+  public:
+    string_searcher(const char *needle, size_t size) : m_needle(needle), m_size(size) {}
 
-    intptr_t w = n - m;
-    if (w < 0) {
-      return;
+    template <class StringType>
+    explicit string_searcher(const StringType &needle) : m_needle(needle.begin()), m_size(needle.size())
+    {
     }
 
-    /* look for special cases */
-    if (m <= 1) {
-      if (m == 0) {
+    size_t size() const { return m_size; }
+
+    template <class match_handler>
+    void operator()(const char *haystack, size_t n, match_handler &handle_match) const
+    {
+      size_t m = m_size;
+      if (m == 0 || m > n) {
         return;
       }
 
-      string_search_1char(haystack.begin(), n, needle.begin()[0], handle_match);
-      return;
-    }
-
-    intptr_t mlast = m - 1;
-    intptr_t skip = mlast - 1;
-
-    const char *ss = s + m - 1;
-    const char *pp = p + m - 1;
-
-    intptr_t i;
-    intptr_t j;
-
-    bloom_filter_t bloom;
-
-    /* create compressed boyer-moore delta 1 table */
-
-    /* process pattern[:-1] */
-    for (i = 0; i < mlast; i++) {
-      bloom.add(p[i]);
-      if (p[i] == p[mlast]) {
-        skip = mlast - i - 1;
+      if (m == 1) {
+        string_search_1char(haystack, n, m_needle[0], handle_match);
+        return;
       }
-    }
 
-    /* process pattern[-1] outside the loop */
-    bloom.add(p[mlast]);
-
-    for (i = 0; i <= w; i++) {
-      /* note: using mlast in the skip path slows things down on x86 */
-      if (ss[i] == pp[0]) {
-        /* candidate match */
-        for (j = 0; j < mlast; j++) {
-          if (s[i + j] != p[j]) {
-            break;
-          }
+      const char *last_start = haystack + (n - m) + 1;
+      for (const char *s = haystack; s < last_start;) {
+        s = find_first_last(s, last_start, m_needle[0], m_needle[m - 1], m - 1);
+        if (s == NULL) {
+          return;
         }
-        if (j == mlast) {
-          /* got a match! */
-          if (handle_match(i)) {
+        if (memcmp(s + 1, m_needle + 1, m - 2) == 0) {
+          if (handle_match(s - haystack)) {
             return;
           }
-          i = i + mlast;
-        }
-        /* miss: check if next character is part of pattern */
-        if (i < w && !bloom.has_char(ss[i + 1])) {
-          i = i + m;
+          s += m;
         }
         else {
-          i = i + skip;
-        }
-      }
-      else {
-        /* skip: check if next character is part of pattern */
-        if (i < w && !bloom.has_char(ss[i + 1])) {
-          i = i + m;
+          ++s;
         }
       }
     }
+  };
 
-    return;
+  template <class StringType, class match_handler>
+  void string_search(const StringType &haystack, const StringType &needle, match_handler &handle_match)
+  {
+    string_searcher searcher(needle);
+    searcher(haystack.begin(), haystack.size(), handle_match);
   }
 
   template <class StringType, class match_handler>
@@ -309,9 +285,9 @@ namespace detail {
     const char *m_new_str;
     size_t m_new_str_size;
 
-    string_copy_replacer(StringType &dst, const StringType &src, const StringType &old_str, const StringType &new_str)
+    string_copy_replacer(StringType &dst, const StringType &src, size_t old_str_size, const StringType &new_str)
         : m_dst(dst.begin()), m_src(src.begin()), m_src_size(src.size()), m_last_src_start(0),
-          m_old_str_size(old_str.size()), m_new_str(new_str.begin()), m_new_str_size(new_str.size())
+          m_old_str_size(old_str_size), m_new_str(new_str.begin()), m_new_str_size(new_str.size())
     {
     }
 
@@ -0,0 +1,105 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <dynd/config.hpp>
+
+namespace dynd {
+
+/**
+ * A fixed set of worker threads that execute parallel loops.
+ *
+ * A loop over [0, size) is cut into chunks of at least ``grain_size``
+ * iterations. Every worker starts with a contiguous run of chunks, takes them
+ * one at a time from the front, and once it runs out steals the back half of
+ * the largest run that is left. The calling thread takes part as worker 0, so
+ * a pool of N threads runs N - 1 threads of its own.
+ *
+ * A loop started from inside another loop, or while the pool is busy with a
+ * loop from another thread, runs serially on the calling thread as worker 0.
+ */
+class DYND_API thread_pool {
+public:
+  /**
+   * The body of a loop, called with the index of the worker running it and
+   * the half-open range of iterations to execute.
+   */
+  typedef std::function<void(size_t worker, size_t begin, size_t end)> task_type;
+
+private:
+  struct run_type {
+    std::mutex mutex;
+    size_t begin;
+    size_t end;
+  };
+
+  std::vector<std::thread> m_threads;
+  std::unique_ptr<run_type[]> m_runs;
+
+  std::mutex m_busy;
+  std::mutex m_mutex;
+  std::condition_variable m_start;
+  std::condition_variable m_finish;
+  size_t m_generation;
+  size_t m_running;
+  bool m_stop;
+
+  // The loop being executed
+  const task_type *m_task;
+  size_t m_size;
+  size_t m_grain_size;
+  std::exception_ptr m_error;
+  std::atomic<bool> m_failed;
+
+  bool next(size_t worker, size_t &chunk);
+  bool steal(size_t worker, size_t &chunk);
+  void work(size_t worker);
+  void main(size_t worker);
+
+public:
+  /**
+   * Creates a pool of ``nthreads`` workers, including the calling thread. A
+   * count of zero uses one worker per hardware thread.
+   */
+  explicit thread_pool(size_t nthreads);
+
+  // non-copyable
+  thread_pool(const thread_pool &) = delete;
+
+  ~thread_pool();
+
+  size_t get_nthreads() const { return m_threads.size() + 1; }
+
+  /**
+   * Executes ``task`` over [0, size) and returns once every iteration is
+   * done. If a task throws, the remaining chunks are skipped and the first
+   * exception is rethrown here.
+   */
+  void parallel_for(size_t size, size_t grain_size, const task_type &task);
+
+  /**
+   * Whether the calling thread is executing a loop of some pool.
+   */
+  static bool in_parallel_region();
+};
+
+/**
+ * Returns the process-wide pool with ``nthreads`` workers, replacing the
+ * previous one if it had a different count. A count of zero uses one
+ * worker per hardware thread.
+ */
+DYND_API std::shared_ptr<thread_pool> get_thread_pool(size_t nthreads);
+
+} // namespace dynd
@@ -22,4 +22,17 @@ namespace dynd {
  */
 DYNDT_API ndt::type promote_types_arithmetic(const ndt::type &tp0, const ndt::type &tp1);
 
+/**
+ * Given two types inferred from data, for example from two records of a
+ * JSON document, this function produces a type that holds the values of
+ * both. Numbers promote like promote_types_arithmetic, dimensions of
+ * different sizes become var_dim, structs take the union of their fields
+ * with the ones missing from either made optional, and an option of
+ * ``Any``, inferred from a null, makes the other type optional.
+ *
+ * Raises a type_error if there is no such type, for example for a string
+ * and a number.
+ */
+DYNDT_API ndt::type promote_types_inferred(const ndt::type &tp0, const ndt::type &tp1);
+
 } // namespace dynd
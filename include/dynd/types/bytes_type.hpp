@@ -6,6 +6,7 @@
 #pragma once
 
 #include <dynd/bytes.hpp>
+#include <dynd/memory_block.hpp>
 #include <dynd/type.hpp>
 #include <dynd/types/base_bytes_type.hpp>
 #include <dynd/types/bytes_kind_type.hpp>
@@ -21,10 +22,20 @@ namespace ndt {
     size_t m_alignment;
 
   public:
+    /**
+     * The same arrmeta as the string type, so that strings and bytes can view each other. A view of strings keeps
+     * their arena alive, but bytes arrays do not make an arena of their own.
+     */
+    struct metadata_type {
+      nd::memory_block blockref;
+      bool owner;
+    };
+
     typedef bytes data_type;
 
     bytes_type(type_id_t id, size_t alignment = 1)
-        : base_bytes_type(id, sizeof(bytes), alignof(bytes), type_flag_zeroinit | type_flag_destructor, 0),
+        : base_bytes_type(id, sizeof(bytes), alignof(bytes), type_flag_zeroinit | type_flag_destructor,
+                          sizeof(metadata_type)),
           m_alignment(alignment) {
       if (alignment != 1 && alignment != 2 && alignment != 4 && alignment != 8 && alignment != 16) {
         std::stringstream ss;
@@ -52,6 +63,10 @@ namespace ndt {
 
     bool operator==(const base_type &rhs) const;
 
+    void arrmeta_copy_construct(char *dst_arrmeta, const char *src_arrmeta,
+                                const nd::memory_block &embedded_reference) const;
+    void arrmeta_destruct(char *arrmeta) const;
+
     void data_destruct(const char *arrmeta, char *data) const;
     void data_destruct_strided(const char *arrmeta, char *data, intptr_t stride, size_t count) const;
 
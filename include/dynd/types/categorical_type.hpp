@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include <dynd/array.hpp>
 #include <dynd/type.hpp>
 #include <dynd/types/fixed_dim_type.hpp>
@@ -31,6 +33,9 @@ namespace ndt {
     nd::array m_category_index_to_value;
     // mapping from values to category indices
     nd::array m_value_to_category_index;
+    // open addressing hash table of category indices plus one, with zero
+    // marking an empty slot, or empty if the category type has no hash
+    std::vector<uint32_t> m_index;
 
   public:
     categorical_type(type_id_t new_id, const nd::array &categories, bool presorted = false);
@@ -56,6 +61,19 @@ namespace ndt {
      */
     const type &get_storage_type() const { return m_storage_type; }
 
+    /**
+     * Returns the value of the category whose data, of the category type,
+     * is ``category_data``, or -1 if it is not a category.
+     */
+    intptr_t find_value(const char *category_data) const;
+
+    /**
+     * Writes the values of ``count`` strided elements of the category type
+     * as the storage type, looking them up in the hash index of the
+     * categories. Throws if one of them is not a category.
+     */
+    void encode(char *dst, intptr_t dst_stride, const char *src, intptr_t src_stride, size_t count) const;
+
     uint32_t get_value_from_category(const char *category_arrmeta, const char *category_data) const;
     uint32_t get_value_from_category(const nd::array &category) const;
 
@@ -95,7 +113,7 @@ namespace ndt {
   };
 
   template <>
-  struct id_of<categorical_type> : std::integral_constant<type_id_t, categorical_kind_id> {};
+  struct id_of<categorical_type> : std::integral_constant<type_id_t, categorical_id> {};
 
   DYND_API type factor_categorical(const nd::array &values);
 
@@ -16,6 +16,11 @@ namespace dynd {
  * The overall strategy of the implementation is to provide an internal `is_sso()` function to identify whether storage
  * is using SSO, then have code paths that use the `sso_*` and `heap_*` functions to do their things with no additional
  * checking for whether SSO is active.
+ *
+ * Memory that is not SSO is either allocated with new[] and owned by the bytestring, or taken from an arena with
+ * `arena_resize()`, in which case the lowest bit of the pointer is set and the bytestring never frees it. The arena
+ * frees all of it at once, so it has to outlive the bytestrings using it. Moves keep pointing into the arena, copies
+ * get memory of their own.
  */
 template <size_t NulPadding>
 class sso_bytestring {
@@ -40,10 +45,19 @@ protected:
       memset(sso_data() + size, 0, 15u - size);
   }
 
+  /** When SSO is not used, whether the memory is from an arena */
+  bool is_arena() const { return (m_pointer & 1) != 0; }
+
   /** When SSO is not used, the size is stored in m_size */
   size_t heap_size() const { return static_cast<size_t>(~m_size); }
-  char *heap_buffer() { return reinterpret_cast<char *>(static_cast<intptr_t>(m_pointer)); }
-  const char *heap_buffer() const { return reinterpret_cast<const char *>(static_cast<intptr_t>(m_pointer)); }
+  char *heap_buffer() { return reinterpret_cast<char *>(static_cast<intptr_t>(m_pointer & ~1)); }
+  const char *heap_buffer() const { return reinterpret_cast<const char *>(static_cast<intptr_t>(m_pointer & ~1)); }
+  /** When SSO is not used, frees the memory unless it is from an arena */
+  void heap_free() {
+    if (!is_arena()) {
+      delete[] heap_buffer();
+    }
+  }
   /** When SSO is not used, the data pointer after a size_t in the data buffer */
   char *heap_data() { return heap_buffer() + sizeof(size_t); }
   const char *heap_data() const { return heap_buffer() + sizeof(size_t); }
@@ -93,7 +107,7 @@ public:
 
   ~sso_bytestring() {
     if (!is_sso()) {
-      delete[] heap_buffer();
+      heap_free();
     }
   }
 
@@ -123,8 +137,11 @@ public:
       m_size = ~static_cast<int64_t>(size);
     } else {
       char *buffer = heap_buffer();
+      bool arena = is_arena();
       heap_assign(bytestr, size);
-      delete[] buffer;
+      if (!arena) {
+        delete[] buffer;
+      }
     }
   }
 
@@ -135,7 +152,7 @@ public:
 
   sso_bytestring &operator=(sso_bytestring &&rhs) {
     if (!is_sso()) {
-      delete[] heap_buffer();
+      heap_free();
     }
     m_pointer = rhs.m_pointer;
     m_size = rhs.m_size;
@@ -152,7 +169,7 @@ public:
 
   void clear() {
     if (!is_sso()) {
-      delete[] heap_buffer();
+      heap_free();
     }
     m_pointer = 0;
     m_size = 0;
@@ -166,7 +183,7 @@ public:
       *reinterpret_cast<size_t *>(new_data) = new_capacity;
       DYND_MEMCPY(new_data + sizeof(size_t), data(), current_size + NulPadding);
       if (!is_sso()) {
-        delete[] heap_buffer();
+        heap_free();
       }
       m_size = ~static_cast<int64_t>(current_size);
       m_pointer = reinterpret_cast<intptr_t>(new_data);
@@ -180,7 +197,8 @@ public:
   void resize(size_t new_size) {
     reserve(new_size);
     if (is_sso()) {
-      m_size = static_cast<int64_t>(static_cast<uint64_t>(m_size) | (static_cast<uint64_t>(new_size) << 56));
+      m_size = static_cast<int64_t>((static_cast<uint64_t>(m_size) & 0x00ffffffffffffffULL) |
+                                    (static_cast<uint64_t>(new_size) << 56));
       // Always keep the unused SSO bytes as 0 for unique representation and NUL-padding when that is enabled
       memset(sso_data() + new_size, 0, 15u - new_size);
     } else {
@@ -191,6 +209,33 @@ public:
     }
   }
 
+  /**
+   * Whether resizing to `new_size` bytes would take memory from an arena. Only a bytestring that is still SSO does, one
+   * that has memory regrows on the heap, so rewriting ever longer values in place does not keep abandoning arena
+   * memory.
+   */
+  bool needs_arena(size_t new_size) const { return is_sso() && new_size > sso_capacity(); }
+
+  /**
+   * Resizes the bytestring to the specified number of bytes, leaving its contents unspecified. If it needs_arena(),
+   * the memory comes from `alloc(n)`, which returns `n` bytes aligned for a size_t from an arena.
+   */
+  template <typename AllocFunc>
+  void arena_resize(size_t new_size, AllocFunc &&alloc) {
+    if (!needs_arena(new_size)) {
+      resize(new_size);
+      return;
+    }
+
+    char *buffer = alloc(sizeof(size_t) + new_size + NulPadding);
+    *reinterpret_cast<size_t *>(buffer) = new_size;
+    if (NulPadding) {
+      buffer[sizeof(size_t) + new_size] = 0;
+    }
+    m_pointer = reinterpret_cast<intptr_t>(buffer) | 1;
+    m_size = ~static_cast<int64_t>(new_size);
+  }
+
   /** Resizes the bytestring to the specified number of bytes, using exponential growth if it grows */
   void resize_grow(size_t new_size) {
     reserve_grow(new_size);
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <dynd/bytes.hpp>
+#include <dynd/memory_block.hpp>
 #include <dynd/string_encodings.hpp>
 #include <dynd/type.hpp>
 #include <dynd/types/sso_bytestring.hpp>
@@ -80,10 +81,24 @@ namespace ndt {
     const std::string m_encoding_repr{encoding_as_string(string_encoding_utf_8)};
 
   public:
+    struct metadata_type {
+      /**
+       * The arena that the strings of the array which are too long for SSO are built in, or NULL. The strings only
+       * point into it, so destroying them frees nothing and the whole arena is freed at once with the array.
+       */
+      nd::memory_block blockref;
+      /**
+       * Whether this is the arrmeta of the array that owns the data, which makes the arena on its first long string.
+       * Views keep that array alive, but only share an arena made before them, and otherwise build on the heap.
+       */
+      bool owner;
+    };
+
     typedef string data_type;
 
     string_type(type_id_t id)
-        : base_string_type(id, sizeof(string), alignof(string), type_flag_zeroinit | type_flag_destructor, 0) {}
+        : base_string_type(id, sizeof(string), alignof(string),
+                           type_flag_zeroinit | type_flag_blockref | type_flag_destructor, sizeof(metadata_type)) {}
 
     string_encoding_t get_encoding() const { return m_encoding; }
 
@@ -109,10 +124,43 @@ namespace ndt {
 
     bool operator==(const base_type &rhs) const;
 
+    void arrmeta_default_construct(char *arrmeta, bool blockref_alloc) const;
+    void arrmeta_copy_construct(char *dst_arrmeta, const char *src_arrmeta,
+                                const nd::memory_block &embedded_reference) const;
+    void arrmeta_destruct(char *arrmeta) const;
     void arrmeta_debug_print(const char *arrmeta, std::ostream &o, const std::string &indent) const;
 
     void data_destruct(const char *arrmeta, char *data) const;
     void data_destruct_strided(const char *arrmeta, char *data, intptr_t stride, size_t count) const;
+
+    /**
+     * Returns the arena of the strings with ``arrmeta``, making it if this is the arrmeta of the owner of the data,
+     * or NULL. Strings are never built by several threads at once, so neither making nor using it takes a lock.
+     */
+    static nd::base_memory_block *get_arena(const char *arrmeta);
+
+    /**
+     * Resizes the string at ``data``, leaving its contents unspecified. If it needs more memory, it comes from the
+     * arena for ``arrmeta`` when there is one.
+     */
+    static void arena_resize(const char *arrmeta, char *data, size_t size) {
+      string *str = reinterpret_cast<string *>(data);
+      nd::base_memory_block *arena;
+      if (str->needs_arena(size) && arrmeta != NULL && (arena = get_arena(arrmeta)) != NULL) {
+        str->arena_resize(size, [arena](size_t n) { return arena->alloc(n); });
+      } else {
+        str->resize(size);
+      }
+    }
+
+    /**
+     * Assigns ``size`` bytes from ``value`` to the string at ``data``, in memory from the arena in ``arrmeta`` when
+     * there is one.
+     */
+    static void arena_assign(const char *arrmeta, char *data, const char *value, size_t size) {
+      arena_resize(arrmeta, data, size);
+      DYND_MEMCPY(reinterpret_cast<string *>(data)->data(), value, size);
+    }
   };
 
   template <>
@@ -143,7 +191,7 @@ namespace ndt {
 
   template <>
   struct traits<const char *> {
-    static const size_t metadata_size = 0;
+    static const size_t metadata_size = sizeof(string_type::metadata_type);
     static const size_t ndim = 0;
 
     static const bool is_same_layout = false;
@@ -886,37 +886,80 @@ nd::array nd::reshape(const nd::array &a, const nd::array &shape) {
                                       NULL);
 }
 
-nd::array nd::memmap(const std::string &DYND_UNUSED(filename), intptr_t DYND_UNUSED(begin), intptr_t DYND_UNUSED(end),
-                     uint32_t DYND_UNUSED(access)) {
-  throw std::runtime_error("nd::memmap is not yet implemented");
+namespace {
 
-  /*
-    // ToDo: This was based on the variable-sized bytes type, which changed.
+nd::array make_memmap_array(const ndt::type &tp, char *data, const nd::memory_block &mm, uint64_t flags) {
+  nd::array result = nd::make_array(tp, data, mm, flags);
+  if (tp.get_arrmeta_size() > 0) {
+    tp.extended()->arrmeta_default_construct(result->metadata(), false);
+  }
 
-    if (access == 0) {
-      access = nd::default_access_flags;
-    }
+  return result;
+}
 
-    char *mm_ptr = NULL;
-    intptr_t mm_size = 0;
-    // Create a memory mapped memblock of the file
-    intrusive_ptr<memory_block_data> mm = make_memmap_memory_block(filename, access, &mm_ptr, &mm_size, begin, end);
-    // Create a bytes array referring to the data.
-    ndt::type dt = ndt::make_type<ndt::bytes_type>(1);
-    char *data_ptr = 0;
-    nd::array result(make_array(dt.extended()->get_arrmeta_size(), dt.get_data_size(),
-                                             dt.get_data_alignment(), &data_ptr));
-    // Set the bytes extents
-    reinterpret_cast<bytes *>(data_ptr)->assign(mm_ptr, mm_size);
-    // Set the array arrmeta
-    array_preamble *ndo = result.get();
-    ndo->set_type(dt);
-    ndo->flags = access;
-    // Set the bytes arrmeta, telling the system
-    // about the memmapped memblock
-    ndo_meta->blockref = mm.release();
-    return result;
-  */
+} // anonymous namespace
+
+nd::array nd::memmap(const std::string &filename, intptr_t begin, intptr_t end, uint32_t access) {
+  if (access == 0) {
+    access = default_access_flags;
+  }
+
+  char *data = NULL;
+  intptr_t size = 0;
+  memory_block mm = make_memory_block<memmap_memory_block>(
+      filename, (access & write_access_flag) ? memmap_readwrite : memmap_readonly, &data, &size, begin, end);
+
+  return make_memmap_array(ndt::make_fixed_dim(size, ndt::make_type<uint8_t>()), data, mm, access);
+}
+
+nd::array nd::memmap(const std::string &filename, const ndt::type &tp, intptr_t offset, memmap_mode_t mode,
+                     memmap_advice_t advice) {
+  if (offset < 0) {
+    throw invalid_argument("nd::memmap requires a nonnegative offset");
+  }
+
+  // A leading Fixed dimension is sized from the file
+  bool sized_from_file = tp.get_id() == fixed_dim_kind_id;
+  const ndt::type &data_tp = sized_from_file ? tp.extended<ndt::base_dim_type>()->get_element_type() : tp;
+  if (data_tp.is_symbolic() || (data_tp.get_flags() & (type_flag_blockref | type_flag_destructor)) ||
+      data_tp.get_id() == pointer_id) {
+    stringstream ss;
+    ss << "nd::memmap requires a concrete type of plain data, not " << tp;
+    throw invalid_argument(ss.str());
+  }
+
+  intptr_t data_size = data_tp.get_default_data_size();
+  intptr_t end = sized_from_file ? std::numeric_limits<intptr_t>::max() : offset + data_size;
+
+  char *data = NULL;
+  intptr_t size = 0;
+  memmap_memory_block *mmb = new memmap_memory_block(filename, mode, &data, &size, offset, end);
+  memory_block mm(mmb, false);
+
+  ndt::type res_tp = data_tp;
+  if (sized_from_file) {
+    res_tp = ndt::make_fixed_dim(size / std::max<intptr_t>(data_size, 1), data_tp);
+  } else if (size < data_size) {
+    stringstream ss;
+    ss << "nd::memmap of " << tp << " needs " << data_size << " bytes from offset " << offset << ", but the file \""
+       << filename << "\" has " << size;
+    throw runtime_error(ss.str());
+  }
+
+  if (data != NULL && reinterpret_cast<uintptr_t>(data) % res_tp.get_data_alignment() != 0) {
+    stringstream ss;
+    ss << "nd::memmap offset " << offset << " is not aligned for " << res_tp;
+    throw invalid_argument(ss.str());
+  }
+
+  mmb->advise(advice);
+
+  uint64_t flags = read_access_flag;
+  if (mode != memmap_readonly) {
+    flags |= write_access_flag;
+  }
+
+  return make_memmap_array(res_tp, data, mm, flags);
 }
 
 nd::array nd::combine_into_tuple(size_t field_count, const array *field_values) {
@@ -44,6 +44,8 @@ nd::callable make_assign() {
   dispatcher.insert(nd::make_callable<nd::assign_callable<ndt::fixed_string_type, ndt::fixed_string_type>>());
   dispatcher.insert(nd::make_callable<nd::assign_callable<ndt::fixed_string_type, ndt::fixed_string_type>>());
   dispatcher.insert(nd::make_callable<nd::assign_callable<ndt::char_type, dynd::string>>());
+  dispatcher.insert(nd::make_callable<nd::assign_callable<ndt::categorical_type, dynd::string>>());
+  dispatcher.insert(nd::make_callable<nd::assign_callable<ndt::categorical_type, ndt::fixed_string_type>>());
 
   //  dispatcher.insert(
   //    {{{adapt_id, ndt::make_type<ndt::any_kind_type>()}, nd::make_callable<nd::adapt_assign_to_callable>()},
@@ -0,0 +1,440 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+#include <cstring>
+
+#include <dynd/bitmask.hpp>
+#include <dynd/exceptions.hpp>
+#include <dynd/simd_isa.hpp>
+#include <dynd/type_promotion.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+void check_one_dimensional(const nd::array &a) {
+  if (a.get_type().get_id() != fixed_dim_id || a.get_ndim() != 1) {
+    stringstream ss;
+    ss << "Expected a one-dimensional array, not " << a.get_type();
+    throw invalid_argument(ss.str());
+  }
+}
+
+void check_same_size(size_t lhs, size_t rhs) {
+  if (lhs != rhs) {
+    stringstream ss;
+    ss << "Cannot combine masks of " << lhs << " and " << rhs << " elements";
+    throw invalid_argument(ss.str());
+  }
+}
+
+/**
+ * Returns ``a`` if its elements are ``tp`` and contiguous, otherwise a
+ * contiguous copy of it cast to ``tp``, as a static_cast would.
+ */
+nd::array as_contiguous(const nd::array &a, const ndt::type &tp) {
+  if (a.get_dtype() == tp &&
+      reinterpret_cast<const fixed_dim_type_arrmeta *>(a.get()->metadata())->stride ==
+          static_cast<intptr_t>(tp.get_data_size())) {
+    return a;
+  }
+
+  nd::array res = nd::empty(ndt::make_fixed_dim(a.get_dim_size(), tp));
+  res.assign(a, assign_error_nocheck);
+  return res;
+}
+
+/**
+ * Returns the scalar ``b`` cast to ``tp`` if that loses nothing, otherwise a
+ * null array. Comparing with the cast value gives the same result as
+ * comparing in the promoted type, without widening the elements.
+ */
+nd::array exact_scalar(const nd::array &b, const ndt::type &tp) {
+  const ndt::type &b_tp = b.get_type();
+  if (!b_tp.is_builtin() || !tp.is_builtin()) {
+    return nd::array();
+  }
+
+  nd::array res = nd::empty(tp);
+  res.assign(b, assign_error_nocheck);
+  nd::array back = nd::empty(b_tp);
+  back.assign(res, assign_error_nocheck);
+  if (memcmp(back.cdata(), b.cdata(), b_tp.get_data_size()) != 0) {
+    return nd::array();
+  }
+
+  return res;
+}
+
+template <comparison_type_t Comp, typename T>
+bool compare_values(T x, T y) {
+  switch (Comp) {
+  case comparison_type_less:
+    return x < y;
+  case comparison_type_less_equal:
+    return x <= y;
+  case comparison_type_equal:
+    return x == y;
+  case comparison_type_not_equal:
+    return x != y;
+  case comparison_type_greater_equal:
+    return x >= y;
+  default:
+    return x > y;
+  }
+}
+
+typedef void (*compare_t)(const char *a, const char *b, bool b_scalar, size_t size, uint64_t *words);
+
+template <typename T, comparison_type_t Comp>
+void compare_scalar(const char *a, const char *b, bool b_scalar, size_t size, uint64_t *words) {
+  T y;
+  memcpy(&y, b, sizeof(T));
+  for (size_t offset = 0; offset < size; offset += 64) {
+    size_t count = min<size_t>(64, size - offset);
+    uint64_t word = 0;
+    for (size_t j = 0; j < count; ++j) {
+      T x;
+      memcpy(&x, a + (offset + j) * sizeof(T), sizeof(T));
+      if (!b_scalar) {
+        memcpy(&y, b + (offset + j) * sizeof(T), sizeof(T));
+      }
+      word |= static_cast<uint64_t>(compare_values<Comp>(x, y)) << j;
+    }
+    words[offset / 64] = word;
+  }
+}
+
+#ifdef DYND_SIMD_X86
+
+// 16-bit comparison results are packed to bytes, two vectors at a time. In
+// AVX2 the pack works within each 128-bit lane, so the 64-bit quarters are
+// put back in order afterwards.
+#define DYND_PACK16_SSE2(X, Y) __builtin_ia32_packsswb128(X, Y)
+#define DYND_PACK16_AVX2(X, Y)                                                                                         \
+  (byte_vector_type) __builtin_ia32_permdi256(                                                                         \
+      (long long __attribute__((vector_size(32))))__builtin_ia32_packsswb256(X, Y), 0xD8)
+
+// Each comparison gives a vector of all ones or all zeros per element, whose
+// sign bits are taken with the movemask for the size of the elements, so
+// there is one bit per element
+#define DYND_DEF_COMPARE(ISA, TARGET, WIDTH, MOVEMASK8, PACK16, MOVEMASK32, MOVEMASK64)                                \
+  template <typename T, comparison_type_t Comp>                                                                        \
+  __attribute__((target(TARGET))) void compare_##ISA(const char *a, const char *b, bool b_scalar, size_t size,         \
+                                                     uint64_t *words) {                                                \
+    typedef T vector_type __attribute__((vector_size(WIDTH)));                                                         \
+    typedef char byte_vector_type __attribute__((vector_size(WIDTH)));                                                 \
+    typedef short short_vector_type __attribute__((vector_size(WIDTH)));                                               \
+    typedef float float_vector_type __attribute__((vector_size(WIDTH)));                                               \
+    typedef double double_vector_type __attribute__((vector_size(WIDTH)));                                             \
+    const size_t lanes = WIDTH / sizeof(T);                                                                            \
+    const size_t nvectors = sizeof(T) == 2 ? 2 : 1;                                                                    \
+    T y;                                                                                                               \
+    memcpy(&y, b, sizeof(T));                                                                                          \
+    vector_type vb = vector_type{} + y;                                                                                \
+    size_t full_size = size - size % 64;                                                                               \
+    for (size_t offset = 0; offset < full_size; offset += 64) {                                                        \
+      uint64_t word = 0;                                                                                               \
+      for (size_t j = 0; j < 64; j += nvectors * lanes) {                                                              \
+        vector_type m[2];                                                                                              \
+        for (size_t k = 0; k < nvectors; ++k) {                                                                        \
+          vector_type va;                                                                                              \
+          memcpy(&va, a + (offset + j + k * lanes) * sizeof(T), WIDTH);                                                \
+          if (!b_scalar) {                                                                                             \
+            memcpy(&vb, b + (offset + j + k * lanes) * sizeof(T), WIDTH);                                              \
+          }                                                                                                            \
+          switch (Comp) {                                                                                              \
+          case comparison_type_less:                                                                                   \
+            m[k] = (vector_type)(va < vb);                                                                             \
+            break;                                                                                                     \
+          case comparison_type_less_equal:                                                                             \
+            m[k] = (vector_type)(va <= vb);                                                                            \
+            break;                                                                                                     \
+          case comparison_type_equal:                                                                                  \
+            m[k] = (vector_type)(va == vb);                                                                            \
+            break;                                                                                                     \
+          case comparison_type_not_equal:                                                                              \
+            m[k] = (vector_type)(va != vb);                                                                            \
+            break;                                                                                                     \
+          case comparison_type_greater_equal:                                                                          \
+            m[k] = (vector_type)(va >= vb);                                                                            \
+            break;                                                                                                     \
+          default:                                                                                                     \
+            m[k] = (vector_type)(va > vb);                                                                             \
+            break;                                                                                                     \
+          }                                                                                                            \
+        }                                                                                                              \
+        uint32_t bits;                                                                                                 \
+        if (sizeof(T) == 1) {                                                                                          \
+          bits = static_cast<uint32_t>(MOVEMASK8((byte_vector_type)m[0]));                                             \
+        } else if (sizeof(T) == 2) {                                                                                   \
+          bits = static_cast<uint32_t>(MOVEMASK8(PACK16((short_vector_type)m[0], (short_vector_type)m[1])));           \
+        } else if (sizeof(T) == 4) {                                                                                   \
+          bits = static_cast<uint32_t>(MOVEMASK32((float_vector_type)m[0]));                                           \
+        } else {                                                                                                       \
+          bits = static_cast<uint32_t>(MOVEMASK64((double_vector_type)m[0]));                                          \
+        }                                                                                                              \
+        word |= static_cast<uint64_t>(bits) << j;                                                                      \
+      }                                                                                                                \
+      words[offset / 64] = word;                                                                                       \
+    }                                                                                                                  \
+    compare_scalar<T, Comp>(a + full_size * sizeof(T), b_scalar ? b : b + full_size * sizeof(T), b_scalar,            \
+                            size - full_size, words + full_size / 64);                                                 \
+  }
+
+DYND_DEF_COMPARE(sse2, "sse2", 16, __builtin_ia32_pmovmskb128, DYND_PACK16_SSE2, __builtin_ia32_movmskps,
+                 __builtin_ia32_movmskpd)
+DYND_DEF_COMPARE(avx2, "avx2", 32, __builtin_ia32_pmovmskb256, DYND_PACK16_AVX2, __builtin_ia32_movmskps256,
+                 __builtin_ia32_movmskpd256)
+
+#undef DYND_DEF_COMPARE
+#undef DYND_PACK16_SSE2
+#undef DYND_PACK16_AVX2
+
+template <typename T, comparison_type_t Comp>
+compare_t get_compare() {
+  switch (detail::get_cpu_simd_isa(detail::simd_isa_avx2)) {
+  case detail::simd_isa_avx2:
+    return &compare_avx2<T, Comp>;
+  case detail::simd_isa_sse2:
+    return &compare_sse2<T, Comp>;
+  default:
+    return &compare_scalar<T, Comp>;
+  }
+}
+
+#else
+
+template <typename T, comparison_type_t Comp>
+compare_t get_compare() {
+  return &compare_scalar<T, Comp>;
+}
+
+#endif
+
+template <typename T>
+compare_t get_compare(comparison_type_t comptype) {
+  switch (comptype) {
+  case comparison_type_less:
+    return get_compare<T, comparison_type_less>();
+  case comparison_type_less_equal:
+    return get_compare<T, comparison_type_less_equal>();
+  case comparison_type_equal:
+    return get_compare<T, comparison_type_equal>();
+  case comparison_type_not_equal:
+    return get_compare<T, comparison_type_not_equal>();
+  case comparison_type_greater_equal:
+    return get_compare<T, comparison_type_greater_equal>();
+  case comparison_type_greater:
+    return get_compare<T, comparison_type_greater>();
+  default:
+    throw invalid_argument("compare: unsupported comparison");
+  }
+}
+
+} // anonymous namespace
+
+size_t nd::bitmask::count() const {
+  size_t res = 0;
+  for (uint64_t word : m_words) {
+    res += popcount(word);
+  }
+
+  return res;
+}
+
+bool nd::bitmask::any() const {
+  for (uint64_t word : m_words) {
+    if (word != 0) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+nd::bitmask &nd::bitmask::operator&=(const bitmask &rhs) {
+  check_same_size(m_size, rhs.m_size);
+  for (size_t i = 0; i < m_words.size(); ++i) {
+    m_words[i] &= rhs.m_words[i];
+  }
+
+  return *this;
+}
+
+nd::bitmask &nd::bitmask::operator|=(const bitmask &rhs) {
+  check_same_size(m_size, rhs.m_size);
+  for (size_t i = 0; i < m_words.size(); ++i) {
+    m_words[i] |= rhs.m_words[i];
+  }
+
+  return *this;
+}
+
+nd::bitmask &nd::bitmask::operator^=(const bitmask &rhs) {
+  check_same_size(m_size, rhs.m_size);
+  for (size_t i = 0; i < m_words.size(); ++i) {
+    m_words[i] ^= rhs.m_words[i];
+  }
+
+  return *this;
+}
+
+nd::bitmask nd::bitmask::operator~() const {
+  bitmask res(*this);
+  for (uint64_t &word : res.m_words) {
+    word = ~word;
+  }
+  res.clear_padding();
+
+  return res;
+}
+
+nd::bitmask nd::make_bitmask(const array &a) {
+  check_one_dimensional(a);
+  if (a.get_dtype().get_id() != bool_id) {
+    stringstream ss;
+    ss << "Expected an array of booleans, not " << a.get_type();
+    throw invalid_argument(ss.str());
+  }
+
+  size_t size = a.get_dim_size();
+  const char *data = a.cdata();
+  intptr_t stride = reinterpret_cast<const fixed_dim_type_arrmeta *>(a.get()->metadata())->stride;
+
+  bitmask res(size);
+  uint64_t *words = res.words();
+  char buffer[64];
+  for (size_t offset = 0; offset < size; offset += 64) {
+    size_t count = min<size_t>(64, size - offset);
+    const char *bytes = data + offset * stride;
+    if (stride != 1) {
+      for (size_t i = 0; i < count; ++i) {
+        buffer[i] = bytes[i * stride];
+      }
+      bytes = buffer;
+    }
+    words[offset / 64] = bitmask::pack_bytes(bytes, count);
+  }
+
+  return res;
+}
+
+nd::array nd::unpack_bitmask(const bitmask &mask) {
+  array res = empty(ndt::make_fixed_dim(mask.size(), ndt::make_type<bool1>()));
+
+  char *data = res.data();
+  const uint64_t *words = mask.words();
+  for (size_t i = 0; i < mask.size(); ++i) {
+    data[i] = static_cast<char>((words[i / 64] >> (i % 64)) & 1);
+  }
+
+  return res;
+}
+
+nd::bitmask nd::compare(comparison_type_t comptype, const array &a, const array &b) {
+  check_one_dimensional(a);
+
+  // Elements of one type compare the same way in it as in their promotion
+  ndt::type tp = a.get_dtype();
+  if (b.get_dtype() != tp) {
+    tp = promote_types_arithmetic(tp, b.get_dtype());
+  }
+  size_t size = a.get_dim_size();
+
+  bool b_scalar = b.get_ndim() == 0;
+  array b_contig;
+  if (b_scalar) {
+    b_contig = exact_scalar(b, a.get_dtype());
+    if (!b_contig.is_null()) {
+      tp = a.get_dtype();
+    } else {
+      b_contig = empty(tp);
+      b_contig.assign(b, assign_error_nocheck);
+    }
+  } else {
+    check_one_dimensional(b);
+    check_same_size(size, b.get_dim_size());
+    b_contig = as_contiguous(b, tp);
+  }
+  array a_contig = as_contiguous(a, tp);
+
+  compare_t f;
+  switch (tp.get_id()) {
+  case int8_id:
+    f = get_compare<int8_t>(comptype);
+    break;
+  case int16_id:
+    f = get_compare<int16_t>(comptype);
+    break;
+  case int32_id:
+    f = get_compare<int32_t>(comptype);
+    break;
+  case int64_id:
+    f = get_compare<int64_t>(comptype);
+    break;
+  case uint8_id:
+    f = get_compare<uint8_t>(comptype);
+    break;
+  case uint16_id:
+    f = get_compare<uint16_t>(comptype);
+    break;
+  case uint32_id:
+    f = get_compare<uint32_t>(comptype);
+    break;
+  case uint64_id:
+    f = get_compare<uint64_t>(comptype);
+    break;
+  case float32_id:
+    f = get_compare<float>(comptype);
+    break;
+  case float64_id:
+    f = get_compare<double>(comptype);
+    break;
+  default:
+    throw not_comparable_error(tp, tp, comptype);
+  }
+
+  bitmask res(size);
+  f(a_contig.cdata(), b_contig.cdata(), b_scalar, size, res.words());
+
+  return res;
+}
+
+nd::array nd::masked_take(const array &a, const bitmask &mask) {
+  check_one_dimensional(a);
+  check_same_size(a.get_dim_size(), mask.size());
+
+  const ndt::type &tp = a.get_dtype();
+  array res = empty(ndt::make_fixed_dim(mask.count(), tp));
+
+  size_t res_size = 0;
+  if (tp.is_pod() && tp.get_arrmeta_size() == 0) {
+    const char *src = a.cdata();
+    intptr_t src_stride = reinterpret_cast<const fixed_dim_type_arrmeta *>(a.get()->metadata())->stride;
+    char *dst = res.data();
+    size_t data_size = tp.get_data_size();
+    mask.for_each_set_run([&](size_t begin, size_t end) {
+      if (src_stride == static_cast<intptr_t>(data_size)) {
+        memcpy(dst + res_size * data_size, src + begin * data_size, (end - begin) * data_size);
+      } else {
+        for (size_t i = begin; i < end; ++i) {
+          memcpy(dst + (res_size + i - begin) * data_size, src + i * src_stride, data_size);
+        }
+      }
+      res_size += end - begin;
+    });
+  } else {
+    mask.for_each_set_run([&](size_t begin, size_t end) {
+      res(irange(res_size, res_size + end - begin)).assign(a(irange(begin, end)));
+      res_size += end - begin;
+    });
+  }
+
+  return res;
+}
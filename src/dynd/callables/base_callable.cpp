@@ -11,17 +11,41 @@ using namespace dynd;
 
 nd::base_callable::~base_callable() {}
 
+std::shared_ptr<nd::call_graph> nd::base_callable::resolve_cached(ndt::type &dst_tp, size_t nsrc,
+                                                                  const ndt::type *src_tp, size_t nkwd,
+                                                                  const array *kwds,
+                                                                  const std::map<std::string, ndt::type> &tp_vars) {
+  std::shared_ptr<call_graph> cg;
+
+  // The keyword count passed in may include special keywords, like "dst",
+  // that are not stored in ``kwds``
+  resolve_cache::key_type key;
+  bool cacheable = m_resolve_cache.get_capacity() != 0 && !is_kwd_variadic() &&
+                   resolve_cache::make_key(key, dst_tp, nsrc, src_tp, get_nkwd(), kwds, tp_vars);
+  if (cacheable && m_resolve_cache.find(key, dst_tp, cg)) {
+    return cg;
+  }
+
+  cg = std::make_shared<call_graph>();
+  dst_tp = resolve(nullptr, nullptr, *cg, dst_tp, nsrc, src_tp, nkwd, kwds, tp_vars);
+
+  if (cacheable) {
+    m_resolve_cache.insert(std::move(key), dst_tp, cg);
+  }
+
+  return cg;
+}
+
 nd::array nd::base_callable::call(ndt::type &dst_tp, size_t nsrc, const ndt::type *src_tp,
                                   const char *const *src_arrmeta, char *const *src_data, size_t nkwd, const array *kwds,
                                   const std::map<std::string, ndt::type> &tp_vars) {
-  call_graph cg;
-  dst_tp = resolve(nullptr, nullptr, cg, dst_tp, nsrc, src_tp, nkwd, kwds, tp_vars);
+  std::shared_ptr<call_graph> cg = resolve_cached(dst_tp, nsrc, src_tp, nkwd, kwds, tp_vars);
 
   // Allocate the destination array
   array dst = alloc(&dst_tp);
 
   // Generate and evaluate the ckernel
-  kernel_builder kb(cg.get());
+  kernel_builder kb(cg->get());
   kb(kernel_request_single, nullptr, dst->metadata(), nsrc, src_arrmeta);
 
   kernel_single_t fn = kb.get()->get_function<kernel_single_t>();
@@ -33,14 +57,13 @@ nd::array nd::base_callable::call(ndt::type &dst_tp, size_t nsrc, const ndt::typ
 nd::array nd::base_callable::call(ndt::type &dst_tp, size_t nsrc, const ndt::type *src_tp,
                                   const char *const *src_arrmeta, const array *src_data, size_t nkwd, const array *kwds,
                                   const std::map<std::string, ndt::type> &tp_vars) {
-  call_graph cg;
-  dst_tp = resolve(nullptr, nullptr, cg, dst_tp, nsrc, src_tp, nkwd, kwds, tp_vars);
+  std::shared_ptr<call_graph> cg = resolve_cached(dst_tp, nsrc, src_tp, nkwd, kwds, tp_vars);
 
   // Allocate the destination array
   array dst = empty(dst_tp);
 
   // Generate and evaluate the kernel
-  kernel_builder kb(cg.get());
+  kernel_builder kb(cg->get());
   kb(kernel_request_call, nullptr, dst->metadata(), nsrc, src_arrmeta);
 
   kernel_call_t fn = kb.get()->get_function<kernel_call_t>();
@@ -52,11 +75,11 @@ nd::array nd::base_callable::call(ndt::type &dst_tp, size_t nsrc, const ndt::typ
 void nd::base_callable::call(const ndt::type &dst_tp, const char *dst_arrmeta, char *dst_data, size_t nsrc,
                              const ndt::type *src_tp, const char *const *src_arrmeta, char *const *src_data,
                              size_t nkwd, const array *kwds, const std::map<std::string, ndt::type> &tp_vars) {
-  call_graph cg;
-  resolve(nullptr, nullptr, cg, dst_tp, nsrc, src_tp, nkwd, kwds, tp_vars);
+  ndt::type res_tp = dst_tp;
+  std::shared_ptr<call_graph> cg = resolve_cached(res_tp, nsrc, src_tp, nkwd, kwds, tp_vars);
 
   // Generate and evaluate the ckernel
-  kernel_builder kb(cg.get());
+  kernel_builder kb(cg->get());
   kb(kernel_request_single, nullptr, dst_arrmeta, nsrc, src_arrmeta);
 
   kernel_single_t fn = kb.get()->get_function<kernel_single_t>();
@@ -66,11 +89,11 @@ void nd::base_callable::call(const ndt::type &dst_tp, const char *dst_arrmeta, c
 void nd::base_callable::call(const ndt::type &dst_tp, const char *dst_arrmeta, array *dst, size_t nsrc,
                              const ndt::type *src_tp, const char *const *src_arrmeta, const array *src, size_t nkwd,
                              const array *kwds, const std::map<std::string, ndt::type> &tp_vars) {
-  call_graph cg;
-  resolve(nullptr, nullptr, cg, dst_tp, nsrc, src_tp, nkwd, kwds, tp_vars);
+  ndt::type res_tp = dst_tp;
+  std::shared_ptr<call_graph> cg = resolve_cached(res_tp, nsrc, src_tp, nkwd, kwds, tp_vars);
 
   // Generate and evaluate the ckernel
-  kernel_builder kb(cg.get());
+  kernel_builder kb(cg->get());
   kb(kernel_request_call, nullptr, dst_arrmeta, nsrc, src_arrmeta);
 
   kernel_call_t fn = kb.get()->get_function<kernel_call_t>();
@@ -0,0 +1,232 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <dynd/callables/resolve_cache.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/types/option_type.hpp>
+#include <dynd/types/pointer_type.hpp>
+#include <dynd/types/string_type.hpp>
+#include <dynd/types/struct_type.hpp>
+#include <dynd/types/tuple_type.hpp>
+#include <dynd/types/var_dim_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+size_t hash_combine(size_t seed, size_t value) { return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2)); }
+
+size_t hash_string(size_t seed, const std::string &s) {
+  for (char c : s) {
+    seed = hash_combine(seed, static_cast<unsigned char>(c));
+  }
+
+  return seed;
+}
+
+/**
+ * Hashes the whole structure of a type, so that the types of one key rarely
+ * share a hash.
+ */
+size_t hash_type(const ndt::type &tp) {
+  if (tp.is_null()) {
+    return 0;
+  }
+
+  size_t seed = static_cast<size_t>(tp.get_id());
+  if (tp.is_builtin()) {
+    return seed;
+  }
+
+  switch (tp.get_id()) {
+  case fixed_dim_id:
+    seed = hash_combine(seed, static_cast<size_t>(tp.extended<ndt::fixed_dim_type>()->get_fixed_dim_size()));
+    return hash_combine(seed, hash_type(tp.extended<ndt::base_dim_type>()->get_element_type()));
+  case var_dim_id:
+    return hash_combine(seed, hash_type(tp.extended<ndt::base_dim_type>()->get_element_type()));
+  case option_id:
+    return hash_combine(seed, hash_type(tp.extended<ndt::option_type>()->get_value_type()));
+  case pointer_id:
+    return hash_combine(seed, hash_type(tp.extended<ndt::pointer_type>()->get_target_type()));
+  case tuple_id:
+    for (const ndt::type &field_tp : tp.extended<ndt::tuple_type>()->get_field_types()) {
+      seed = hash_combine(seed, hash_type(field_tp));
+    }
+    return seed;
+  case struct_id:
+    for (const std::string &name : tp.extended<ndt::struct_type>()->get_field_names()) {
+      seed = hash_string(seed, name);
+    }
+    for (const ndt::type &field_tp : tp.extended<ndt::struct_type>()->get_field_types()) {
+      seed = hash_combine(seed, hash_type(field_tp));
+    }
+    return seed;
+  default:
+    break;
+  }
+
+  // Other types are told apart by their layout
+  seed = hash_combine(seed, static_cast<size_t>(tp.get_ndim()));
+  seed = hash_combine(seed, tp.get_data_size());
+  seed = hash_combine(seed, tp.get_data_alignment());
+  return hash_combine(seed, tp.get_arrmeta_size());
+}
+
+void push_type(nd::resolve_cache::key_type &key, const ndt::type &tp) {
+  key.hash = hash_combine(key.hash, hash_type(tp));
+  key.types.push_back(tp);
+}
+
+void push_bytes(nd::resolve_cache::key_type &key, const char *data, size_t size) {
+  key.bytes.insert(key.bytes.end(), data, data + size);
+  for (size_t i = 0; i < size; ++i) {
+    key.hash = hash_combine(key.hash, static_cast<unsigned char>(data[i]));
+  }
+}
+
+bool push_kwd(nd::resolve_cache::key_type &key, const nd::array &value) {
+  if (value.is_null()) {
+    push_type(key, ndt::type());
+    return true;
+  }
+
+  const ndt::type &tp = value.get_type();
+  push_type(key, tp);
+
+  switch (tp.get_id()) {
+  case type_id:
+    push_type(key, value.as<ndt::type>());
+    return true;
+  case string_id: {
+    const dynd::string &s = *reinterpret_cast<const dynd::string *>(value.cdata());
+    size_t size = s.size();
+    push_bytes(key, reinterpret_cast<const char *>(&size), sizeof(size));
+    push_bytes(key, s.data(), size);
+    return true;
+  }
+  default:
+    break;
+  }
+
+  // Any other value must be plain old data laid out contiguously, so that
+  // its bytes identify it
+  if ((tp.get_flags() & (type_flag_blockref | type_flag_destructor)) != 0 || tp.is_symbolic() ||
+      !tp.is_c_contiguous(value->metadata())) {
+    return false;
+  }
+
+  push_bytes(key, value.cdata(), tp.get_data_size());
+  return true;
+}
+
+} // anonymous namespace
+
+std::atomic<size_t> nd::resolve_cache::s_generation(0);
+
+bool nd::resolve_cache::make_key(key_type &key, const ndt::type &dst_tp, size_t narg, const ndt::type *arg_tp,
+                                 size_t nkwd, const array *kwds, const std::map<std::string, ndt::type> &tp_vars) {
+  key.generation = s_generation;
+  key.types.reserve(1 + narg + nkwd + tp_vars.size());
+
+  push_type(key, dst_tp);
+  for (size_t i = 0; i < narg; ++i) {
+    push_type(key, arg_tp[i]);
+  }
+
+  for (size_t i = 0; i < nkwd; ++i) {
+    if (!push_kwd(key, kwds[i])) {
+      return false;
+    }
+  }
+
+  for (const auto &pair : tp_vars) {
+    push_bytes(key, pair.first.c_str(), pair.first.size() + 1);
+    push_type(key, pair.second);
+  }
+
+  return true;
+}
+
+bool nd::resolve_cache::find(const key_type &key, ndt::type &dst_tp, std::shared_ptr<call_graph> &cg) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  if (m_generation != s_generation) {
+    m_entries.clear();
+    m_index.clear();
+    m_generation = s_generation;
+  }
+
+  auto range = m_index.equal_range(key.hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second->key == key) {
+      // Move the entry to the front, marking it most recently used
+      m_entries.splice(m_entries.begin(), m_entries, it->second);
+
+      dst_tp = it->second->dst_tp;
+      cg = it->second->cg;
+      ++m_hit_count;
+      return true;
+    }
+  }
+
+  ++m_miss_count;
+  return false;
+}
+
+void nd::resolve_cache::insert(key_type &&key, const ndt::type &dst_tp, const std::shared_ptr<call_graph> &cg) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  // A callable may have been overloaded while this one was resolving
+  if (m_capacity == 0 || key.generation != s_generation || m_generation != s_generation) {
+    return;
+  }
+
+  // Another thread may have resolved the same key in the meantime
+  auto range = m_index.equal_range(key.hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second->key == key) {
+      return;
+    }
+  }
+
+  size_t hash = key.hash;
+  m_entries.push_front(entry_type{std::move(key), dst_tp, cg});
+  m_index.emplace(hash, m_entries.begin());
+  evict();
+}
+
+void nd::resolve_cache::evict() {
+  while (m_entries.size() > m_capacity) {
+    auto range = m_index.equal_range(m_entries.back().key.hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == std::prev(m_entries.end())) {
+        m_index.erase(it);
+        break;
+      }
+    }
+    m_entries.pop_back();
+  }
+}
+
+void nd::resolve_cache::clear() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  m_entries.clear();
+  m_index.clear();
+}
+
+size_t nd::resolve_cache::size() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  return m_entries.size();
+}
+
+void nd::resolve_cache::set_capacity(size_t capacity) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  m_capacity = capacity;
+  evict();
+}
@@ -5,6 +5,7 @@
 
 #include <dynd/json_formatter.hpp>
 #include <dynd/callable.hpp>
+#include <dynd/format_util.hpp>
 #include <dynd/option.hpp>
 #include <dynd/types/string_type.hpp>
 #include <dynd/types/struct_type.hpp>
@@ -82,6 +83,43 @@ static void format_json_bool(output_data &out, const ndt::type &dt, const char *
 }
 
 static void format_json_number(output_data &out, const ndt::type &dt, const char *arrmeta, const char *data) {
+  // The common types are written straight into the output
+  out.ensure_capacity(max_number_format_size);
+  switch (dt.get_id()) {
+  case int8_id:
+    out.out_end = format_int(*reinterpret_cast<const int8_t *>(data), out.out_end);
+    return;
+  case int16_id:
+    out.out_end = format_int(*reinterpret_cast<const int16_t *>(data), out.out_end);
+    return;
+  case int32_id:
+    out.out_end = format_int(*reinterpret_cast<const int32_t *>(data), out.out_end);
+    return;
+  case int64_id:
+    out.out_end = format_int(*reinterpret_cast<const int64_t *>(data), out.out_end);
+    return;
+  case uint8_id:
+    out.out_end = format_uint(*reinterpret_cast<const uint8_t *>(data), out.out_end);
+    return;
+  case uint16_id:
+    out.out_end = format_uint(*reinterpret_cast<const uint16_t *>(data), out.out_end);
+    return;
+  case uint32_id:
+    out.out_end = format_uint(*reinterpret_cast<const uint32_t *>(data), out.out_end);
+    return;
+  case uint64_id:
+    out.out_end = format_uint(*reinterpret_cast<const uint64_t *>(data), out.out_end);
+    return;
+  case float32_id:
+    out.out_end = format_float(*reinterpret_cast<const float *>(data), out.out_end);
+    return;
+  case float64_id:
+    out.out_end = format_float(*reinterpret_cast<const double *>(data), out.out_end);
+    return;
+  default:
+    break;
+  }
+
   stringstream ss;
   dt.print_data(ss, arrmeta, data);
   out.write(ss.str());
@@ -3,14 +3,23 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
 #include <dynd/callable.hpp>
 #include <dynd/json_parser.hpp>
+#include <dynd/json_structural_index.hpp>
 #include <dynd/kernels/parse_kernel.hpp>
 #include <dynd/parse.hpp>
+#include <dynd/thread_pool.hpp>
+#include <dynd/type_promotion.hpp>
 #include <dynd/types/base_bytes_type.hpp>
 #include <dynd/types/fixed_dim_type.hpp>
 #include <dynd/types/option_type.hpp>
 #include <dynd/types/string_type.hpp>
+#include <dynd/types/struct_type.hpp>
+#include <dynd/types/tuple_type.hpp>
 #include <dynd/types/var_dim_type.hpp>
 
 using namespace std;
@@ -75,13 +84,60 @@ nd::array dynd::parse_json(const ndt::type &tp, const nd::array &json, const eva
 }
 
 static void parse_json(const ndt::type &tp, const char *arrmeta, char *out_data, const char *&json_begin,
-                       const char *json_end, const eval::eval_context *ectx);
+                       const char *json_end, json::structural_index *index, const eval::eval_context *ectx);
+
+/**
+ * Returns the structural index of the JSON in ``[begin, end)``, or NULL if it
+ * is too short for the index to pay for itself.
+ */
+static std::unique_ptr<json::structural_index> make_structural_index(const char *begin, const char *end) {
+  std::unique_ptr<json::structural_index> index;
+  if (end - begin >= 256) {
+    index.reset(new json::structural_index(begin, end));
+  }
 
-static void skip_json_value(const char *&begin, const char *end) {
+  return index;
+}
+
+/**
+ * Parses a double-quoted string like parse_doublequote_string_no_ws, but
+ * takes the end of the string and whether it has escapes from the
+ * structural index instead of scanning for them. The escapes were checked
+ * when the index was built.
+ */
+static bool parse_json_string_no_ws(const char *&begin, const char *end, const char *&out_strbegin,
+                                    const char *&out_strend, bool &out_escaped, json::structural_index *index) {
+  if (index != NULL && begin < end && *begin == '"') {
+    const char *close = index->find_close(begin, &out_escaped);
+    if (close != NULL) {
+      out_strbegin = begin + 1;
+      out_strend = close;
+      begin = close + 1;
+      return true;
+    }
+  }
+
+  return parse_doublequote_string_no_ws(begin, end, out_strbegin, out_strend, out_escaped);
+}
+
+/**
+ * Skips a JSON value. With a valid structural index, which has already
+ * validated the document, a string, array or object is skipped in O(1) by
+ * jumping to its closing character. Without one, the value is validated as
+ * it is skipped.
+ */
+static void skip_json_value(const char *&begin, const char *end, json::structural_index *index) {
   skip_whitespace(begin, end);
   if (begin == end) {
     throw parse_error(begin, "malformed JSON, expecting an element");
   }
+  if (index != NULL) {
+    const char *close = index->find_close(begin);
+    if (close != NULL) {
+      begin = close + 1;
+      return;
+    }
+  }
   char c = *begin;
   switch (c) {
   // Object
@@ -92,13 +148,13 @@ static void skip_json_value(const char *&begin, const char *end) {
         const char *strbegin, *strend;
         bool escaped;
         skip_whitespace(begin, end);
-        if (!parse_doublequote_string_no_ws(begin, end, strbegin, strend, escaped)) {
+        if (!parse_json_string_no_ws(begin, end, strbegin, strend, escaped, index)) {
           throw parse_error(begin, "expected string for name in object dict");
         }
         if (!parse_token(begin, end, ":")) {
           throw parse_error(begin, "expected ':' separating name from value in object dict");
         }
-        skip_json_value(begin, end);
+        skip_json_value(begin, end, index);
         if (!parse_token(begin, end, ",")) {
           break;
         }
@@ -113,7 +169,7 @@ static void skip_json_value(const char *&begin, const char *end) {
     ++begin;
     if (!parse_token(begin, end, "]")) {
       for (;;) {
-        skip_json_value(begin, end);
+        skip_json_value(begin, end, index);
         if (!parse_token(begin, end, ",")) {
           break;
         }
@@ -126,7 +182,7 @@ static void skip_json_value(const char *&begin, const char *end) {
   case '"': {
     const char *strbegin, *strend;
     bool escaped;
-    if (!parse_doublequote_string_no_ws(begin, end, strbegin, strend, escaped)) {
+    if (!parse_json_string_no_ws(begin, end, strbegin, strend, escaped, index)) {
       throw parse_error(begin, "invalid string");
     }
     break;
@@ -159,7 +215,7 @@ static void skip_json_value(const char *&begin, const char *end) {
 }
 
 static void parse_strided_dim_json(const ndt::type &tp, const char *arrmeta, char *out_data, const char *&begin,
-                                   const char *end, const eval::eval_context *ectx) {
+                                   const char *end, json::structural_index *index, const eval::eval_context *ectx) {
   intptr_t dim_size, stride;
   ndt::type el_tp;
   const char *el_arrmeta;
@@ -171,7 +227,7 @@ static void parse_strided_dim_json(const ndt::type &tp, const char *arrmeta, cha
     throw json_parse_error(begin, "expected list starting with '['", tp);
   }
   for (intptr_t i = 0; i < dim_size; ++i) {
-    parse_json(el_tp, el_arrmeta, out_data + i * stride, begin, end, ectx);
+    parse_json(el_tp, el_arrmeta, out_data + i * stride, begin, end, index, ectx);
     if (i < dim_size - 1 && !parse_token(begin, end, ",")) {
       throw json_parse_error(begin, "array is too short, expected ',' list item separator", tp);
     }
@@ -182,7 +238,7 @@ static void parse_strided_dim_json(const ndt::type &tp, const char *arrmeta, cha
 }
 
 static void parse_var_dim_json(const ndt::type &tp, const char *arrmeta, char *out_data, const char *&begin,
-                               const char *end, const eval::eval_context *ectx) {
+                               const char *end, json::structural_index *index, const eval::eval_context *ectx) {
   const ndt::var_dim_type *vad = tp.extended<ndt::var_dim_type>();
   const ndt::var_dim_type::metadata_type *md = reinterpret_cast<const ndt::var_dim_type::metadata_type *>(arrmeta);
   intptr_t stride = md->stride;
@@ -207,7 +263,7 @@ static void parse_var_dim_json(const ndt::type &tp, const char *arrmeta, char *o
       ++size;
       out->size = size;
       parse_json(element_tp, arrmeta + sizeof(ndt::var_dim_type::metadata_type), out->begin + (size - 1) * stride,
-                 begin, end, ectx);
+                 begin, end, index, ectx);
       if (!parse_token(begin, end, ",")) {
         break;
       }
@@ -222,8 +278,72 @@ static void parse_var_dim_json(const ndt::type &tp, const char *arrmeta, char *o
   out->size = size;
 }
 
+/**
+ * Whether ``tp`` is made of dimensions or fields, which JSON writes as an
+ * array or an object.
+ */
+static bool is_json_container(const ndt::type &tp) {
+  return tp.get_ndim() > 0 || tp.get_id() == struct_id || tp.get_id() == tuple_id;
+}
+
+static void assign_na_json(const ndt::type &tp, const char *arrmeta, char *out_data);
+
+template <class Type>
+static void assign_na_json_fields(const ndt::type &tp, const char *arrmeta, char *out_data) {
+  auto fsd = tp.extended<Type>();
+  const uintptr_t *data_offsets = reinterpret_cast<const uintptr_t *>(arrmeta);
+  const std::vector<uintptr_t> &arrmeta_offsets = fsd->get_arrmeta_offsets();
+  for (intptr_t i = 0, i_end = fsd->get_field_count(); i != i_end; ++i) {
+    assign_na_json(fsd->get_field_type(i), arrmeta + arrmeta_offsets[i], out_data + data_offsets[i]);
+  }
+}
+
+/**
+ * Assigns NA to the data of ``tp``, an option type or a type within one,
+ * for a null or a missing field. An option of dimensions or fields is NA
+ * throughout, like nd::assign_na makes an option of a fixed dimension: every
+ * scalar value gets the NA of its type, and a var dimension is empty.
+ */
+static void assign_na_json(const ndt::type &tp, const char *arrmeta, char *out_data) {
+  switch (tp.get_id()) {
+  case option_id: {
+    const ndt::type &value_tp = tp.extended<ndt::option_type>()->get_value_type();
+    if (is_json_container(value_tp)) {
+      assign_na_json(value_tp, arrmeta, out_data);
+    } else {
+      nd::old_assign_na(tp, arrmeta, out_data);
+    }
+    break;
+  }
+  case fixed_dim_id: {
+    const fixed_dim_type_arrmeta *md = reinterpret_cast<const fixed_dim_type_arrmeta *>(arrmeta);
+    const ndt::type &el_tp = tp.extended<ndt::fixed_dim_type>()->get_element_type();
+    for (intptr_t i = 0; i < md->dim_size; ++i) {
+      assign_na_json(el_tp, arrmeta + sizeof(fixed_dim_type_arrmeta), out_data + i * md->stride);
+    }
+    break;
+  }
+  case var_dim_id: {
+    ndt::var_dim_type::data_type *out = reinterpret_cast<ndt::var_dim_type::data_type *>(out_data);
+    out->begin = NULL;
+    out->size = 0;
+    break;
+  }
+  case struct_id:
+    assign_na_json_fields<ndt::struct_type>(tp, arrmeta, out_data);
+    break;
+  case tuple_id:
+    assign_na_json_fields<ndt::tuple_type>(tp, arrmeta, out_data);
+    break;
+  default:
+    nd::old_assign_na(ndt::make_type<ndt::option_type>(tp), arrmeta, out_data);
+    break;
+  }
+}
+
 static bool parse_struct_json_from_object(const ndt::type &tp, const char *arrmeta, char *out_data, const char *&begin,
-                                          const char *end, const eval::eval_context *ectx) {
+                                          const char *end, json::structural_index *index,
+                                          const eval::eval_context *ectx) {
   const char *saved_begin = begin;
   if (!parse_token(begin, end, "{")) {
     return false;
@@ -244,7 +364,7 @@ static bool parse_struct_json_from_object(const ndt::type &tp, const char *arrme
       const char *strbegin, *strend;
       bool escaped;
       skip_whitespace(begin, end);
-      if (!parse_doublequote_string_no_ws(begin, end, strbegin, strend, escaped)) {
+      if (!parse_json_string_no_ws(begin, end, strbegin, strend, escaped, index)) {
         throw json_parse_error(begin, "expected string for name in object dict", tp);
       }
       if (!parse_token(begin, end, ":")) {
@@ -261,9 +381,10 @@ static bool parse_struct_json_from_object(const ndt::type &tp, const char *arrme
       if (i == -1) {
         // TODO: Add an error policy to this parser of whether to throw an error
         //       or not. For now, just throw away fields not in the destination.
-        skip_json_value(begin, end);
+        skip_json_value(begin, end, index);
       } else {
-        parse_json(fsd->get_field_type(i), arrmeta + arrmeta_offsets[i], out_data + data_offsets[i], begin, end, ectx);
+        parse_json(fsd->get_field_type(i), arrmeta + arrmeta_offsets[i], out_data + data_offsets[i], begin, end, index,
+                   ectx);
         populated_fields[i] = true;
       }
       if (!parse_token(begin, end, ",")) {
@@ -279,7 +400,7 @@ static bool parse_struct_json_from_object(const ndt::type &tp, const char *arrme
     if (!populated_fields[i]) {
       const ndt::type &field_tp = fsd->get_field_type(i);
       if (field_tp.get_id() == option_id) {
-        nd::old_assign_na(field_tp, arrmeta + arrmeta_offsets[i], out_data + data_offsets[i]);
+        assign_na_json(field_tp, arrmeta + arrmeta_offsets[i], out_data + data_offsets[i]);
       } else {
         stringstream ss;
         ss << "object dict does not contain the field ";
@@ -296,7 +417,7 @@ static bool parse_struct_json_from_object(const ndt::type &tp, const char *arrme
 
 template <class Type>
 static bool parse_tuple_json_from_list(const ndt::type &tp, const char *arrmeta, char *out_data, const char *&begin,
-                                       const char *end, const eval::eval_context *ectx) {
+                                       const char *end, json::structural_index *index, const eval::eval_context *ectx) {
   if (!parse_token(begin, end, "[")) {
     return false;
   }
@@ -309,7 +430,8 @@ static bool parse_tuple_json_from_list(const ndt::type &tp, const char *arrmeta,
   // Loop through all the fields
   for (intptr_t i = 0; i != field_count; ++i) {
     skip_whitespace(begin, end);
-    parse_json(fsd->get_field_type(i), arrmeta + arrmeta_offsets[i], out_data + data_offsets[i], begin, end, ectx);
+    parse_json(fsd->get_field_type(i), arrmeta + arrmeta_offsets[i], out_data + data_offsets[i], begin, end, index,
+               ectx);
     if (i != field_count - 1 && !parse_token(begin, end, ",")) {
       throw json_parse_error(begin, "expected list item separator ','", tp);
     }
@@ -323,17 +445,17 @@ static bool parse_tuple_json_from_list(const ndt::type &tp, const char *arrmeta,
 }
 
 static void parse_struct_json(const ndt::type &tp, const char *arrmeta, char *out_data, const char *&begin,
-                              const char *end, const eval::eval_context *ectx) {
-  if (parse_struct_json_from_object(tp, arrmeta, out_data, begin, end, ectx)) {
-  } else if (parse_tuple_json_from_list<ndt::struct_type>(tp, arrmeta, out_data, begin, end, ectx)) {
+                              const char *end, json::structural_index *index, const eval::eval_context *ectx) {
+  if (parse_struct_json_from_object(tp, arrmeta, out_data, begin, end, index, ectx)) {
+  } else if (parse_tuple_json_from_list<ndt::struct_type>(tp, arrmeta, out_data, begin, end, index, ectx)) {
   } else {
     throw json_parse_error(begin, "expected object dict starting with '{' or list with '['", tp);
   }
 }
 
 static void parse_tuple_json(const ndt::type &tp, const char *arrmeta, char *out_data, const char *&begin,
-                             const char *end, const eval::eval_context *ectx) {
-  if (parse_tuple_json_from_list<ndt::tuple_type>(tp, arrmeta, out_data, begin, end, ectx)) {
+                             const char *end, json::structural_index *index, const eval::eval_context *ectx) {
+  if (parse_tuple_json_from_list<ndt::tuple_type>(tp, arrmeta, out_data, begin, end, index, ectx)) {
   } else {
     throw json_parse_error(begin, "expected object dict starting with '{' or list with '['", tp);
   }
@@ -401,12 +523,12 @@ static void parse_bool_json(const ndt::type &tp, const char *DYND_UNUSED(arrmeta
 }
 
 static void parse_string_json(const ndt::type &tp, const char *arrmeta, char *out_data, const char *&rbegin,
-                              const char *end, const eval::eval_context *ectx) {
+                              const char *end, json::structural_index *index, const eval::eval_context *ectx) {
   const char *begin = rbegin;
   skip_whitespace(begin, end);
   const char *strbegin, *strend;
   bool escaped;
-  if (parse_doublequote_string_no_ws(begin, end, strbegin, strend, escaped)) {
+  if (parse_json_string_no_ws(begin, end, strbegin, strend, escaped, index)) {
     const ndt::base_string_type *bsd = tp.extended<ndt::base_string_type>();
     try {
       if (!escaped) {
@@ -469,13 +591,13 @@ static void parse_type(const ndt::type &tp, const char *DYND_UNUSED(arrmeta), ch
 }
 
 static void parse_dim_json(const ndt::type &tp, const char *arrmeta, char *out_data, const char *&begin,
-                           const char *end, const eval::eval_context *ectx) {
+                           const char *end, json::structural_index *index, const eval::eval_context *ectx) {
   switch (tp.get_id()) {
   case fixed_dim_id:
-    parse_strided_dim_json(tp, arrmeta, out_data, begin, end, ectx);
+    parse_strided_dim_json(tp, arrmeta, out_data, begin, end, index, ectx);
     break;
   case var_dim_id:
-    parse_var_dim_json(tp, arrmeta, out_data, begin, end, ectx);
+    parse_var_dim_json(tp, arrmeta, out_data, begin, end, index, ectx);
     break;
   default: {
     stringstream ss;
@@ -486,15 +608,26 @@ static void parse_dim_json(const ndt::type &tp, const char *arrmeta, char *out_d
 }
 
 static void parse_option_json(const ndt::type &tp, const char *arrmeta, char *out_data, const char *&begin,
-                              const char *end, const eval::eval_context *ectx) {
+                              const char *end, json::structural_index *index, const eval::eval_context *ectx) {
   skip_whitespace(begin, end);
+  const ndt::type &value_tp = tp.extended<ndt::option_type>()->get_value_type();
+  if (is_json_container(value_tp)) {
+    // An option of dimensions or fields, which discovery infers from a null
+    // in place of an array or object
+    if (parse_token(begin, end, "null")) {
+      assign_na_json(tp, arrmeta, out_data);
+    } else {
+      parse_json(value_tp, arrmeta, out_data, begin, end, index, ectx);
+    }
+    return;
+  }
+
   const char *saved_begin = begin;
   if (tp.is_scalar()) {
     if (parse_token(begin, end, "null")) {
       nd::old_assign_na(tp, arrmeta, out_data);
       return;
     } else {
-      const ndt::type &value_tp = tp.extended<ndt::option_type>()->get_value_type();
       const char *strbegin, *strend;
       bool escaped;
       if (parse_doublequote_string_no_ws(begin, end, strbegin, strend, escaped)) {
@@ -549,18 +682,18 @@ static void parse_option_json(const ndt::type &tp, const char *arrmeta, char *ou
 }
 
 static void parse_json(const ndt::type &tp, const char *arrmeta, char *out_data, const char *&begin, const char *end,
-                       const eval::eval_context *ectx) {
+                       json::structural_index *index, const eval::eval_context *ectx) {
   skip_whitespace(begin, end);
   switch (tp.get_id()) {
   case fixed_dim_id:
   case var_dim_id:
-    parse_dim_json(tp, arrmeta, out_data, begin, end, ectx);
+    parse_dim_json(tp, arrmeta, out_data, begin, end, index, ectx);
     return;
   case struct_id:
-    parse_struct_json(tp, arrmeta, out_data, begin, end, ectx);
+    parse_struct_json(tp, arrmeta, out_data, begin, end, index, ectx);
     return;
   case tuple_id:
-    parse_tuple_json(tp, arrmeta, out_data, begin, end, ectx);
+    parse_tuple_json(tp, arrmeta, out_data, begin, end, index, ectx);
     return;
   case bool_id:
     parse_bool_json(tp, arrmeta, out_data, begin, end, false, ectx);
@@ -585,13 +718,13 @@ static void parse_json(const ndt::type &tp, const char *arrmeta, char *out_data,
     return;
   case fixed_string_id:
   case string_id:
-    parse_string_json(tp, arrmeta, out_data, begin, end, ectx);
+    parse_string_json(tp, arrmeta, out_data, begin, end, index, ectx);
     return;
   case type_id:
     parse_type(tp, arrmeta, out_data, begin, end, false, ectx);
     return;
   case option_id:
-    parse_option_json(tp, arrmeta, out_data, begin, end, ectx);
+    parse_option_json(tp, arrmeta, out_data, begin, end, index, ectx);
     return;
   default:
     break;
@@ -602,6 +735,266 @@ static void parse_json(const ndt::type &tp, const char *arrmeta, char *out_data,
   throw runtime_error(ss.str());
 }
 
+/**
+ * The smallest share of a top-level array, in bytes, worth parsing on a
+ * thread of its own.
+ */
+static const intptr_t json_min_partition_size = 64 * 1024;
+
+static bool is_mergeable_arrmeta(const ndt::type &tp, const char *dst_arrmeta, const char *src_arrmeta);
+
+template <class Type>
+static bool is_mergeable_fields(const ndt::type &tp, const char *dst_arrmeta, const char *src_arrmeta) {
+  auto fsd = tp.extended<Type>();
+  intptr_t field_count = fsd->get_field_count();
+  const std::vector<uintptr_t> &arrmeta_offsets = fsd->get_arrmeta_offsets();
+  if (memcmp(dst_arrmeta, src_arrmeta, field_count * sizeof(uintptr_t)) != 0) {
+    return false;
+  }
+  for (intptr_t i = 0; i != field_count; ++i) {
+    if (!is_mergeable_arrmeta(fsd->get_field_type(i), dst_arrmeta + arrmeta_offsets[i],
+                              src_arrmeta + arrmeta_offsets[i])) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Whether two arrmeta of ``tp`` lay out its data the same way, with memory
+ * blocks that merge_arrmeta_blocks knows how to merge, so data parsed with
+ * ``src_arrmeta`` can be handed over to ``dst_arrmeta``.
+ */
+static bool is_mergeable_arrmeta(const ndt::type &tp, const char *dst_arrmeta, const char *src_arrmeta) {
+  if (tp.is_builtin()) {
+    return true;
+  }
+
+  switch (tp.get_id()) {
+  case fixed_string_id:
+  case type_id:
+    return true;
+  case string_id:
+    return reinterpret_cast<const ndt::string_type::metadata_type *>(dst_arrmeta)->owner &&
+           reinterpret_cast<const ndt::string_type::metadata_type *>(src_arrmeta)->owner;
+  case option_id:
+    return is_mergeable_arrmeta(tp.extended<ndt::option_type>()->get_value_type(), dst_arrmeta, src_arrmeta);
+  case fixed_dim_id: {
+    const fixed_dim_type_arrmeta *dst_md = reinterpret_cast<const fixed_dim_type_arrmeta *>(dst_arrmeta);
+    const fixed_dim_type_arrmeta *src_md = reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta);
+    return dst_md->dim_size == src_md->dim_size && dst_md->stride == src_md->stride &&
+           is_mergeable_arrmeta(tp.extended<ndt::fixed_dim_type>()->get_element_type(),
+                                dst_arrmeta + sizeof(fixed_dim_type_arrmeta),
+                                src_arrmeta + sizeof(fixed_dim_type_arrmeta));
+  }
+  case var_dim_id: {
+    typedef ndt::var_dim_type::metadata_type metadata_type;
+    const metadata_type *dst_md = reinterpret_cast<const metadata_type *>(dst_arrmeta);
+    const metadata_type *src_md = reinterpret_cast<const metadata_type *>(src_arrmeta);
+    return dst_md->stride == src_md->stride && dst_md->offset == src_md->offset && dst_md->blockref &&
+           src_md->blockref && is_mergeable_arrmeta(tp.extended<ndt::var_dim_type>()->get_element_type(),
+                                                    dst_arrmeta + sizeof(metadata_type),
+                                                    src_arrmeta + sizeof(metadata_type));
+  }
+  case struct_id:
+    return is_mergeable_fields<ndt::struct_type>(tp, dst_arrmeta, src_arrmeta);
+  case tuple_id:
+    return is_mergeable_fields<ndt::tuple_type>(tp, dst_arrmeta, src_arrmeta);
+  default:
+    return false;
+  }
+}
+
+static void merge_arrmeta_blocks(const ndt::type &tp, const char *dst_arrmeta, const char *src_arrmeta);
+
+template <class Type>
+static void merge_field_blocks(const ndt::type &tp, const char *dst_arrmeta, const char *src_arrmeta) {
+  auto fsd = tp.extended<Type>();
+  const std::vector<uintptr_t> &arrmeta_offsets = fsd->get_arrmeta_offsets();
+  for (intptr_t i = 0, i_end = fsd->get_field_count(); i != i_end; ++i) {
+    merge_arrmeta_blocks(fsd->get_field_type(i), dst_arrmeta + arrmeta_offsets[i], src_arrmeta + arrmeta_offsets[i]);
+  }
+}
+
+/**
+ * Moves the memory of the var_dim dimensions and string arenas in
+ * ``src_arrmeta`` over to the matching memory blocks of ``dst_arrmeta``.
+ */
+static void merge_arrmeta_blocks(const ndt::type &tp, const char *dst_arrmeta, const char *src_arrmeta) {
+  if (tp.is_builtin()) {
+    return;
+  }
+
+  switch (tp.get_id()) {
+  case string_id: {
+    // The arenas are only made by the first long string
+    typedef ndt::string_type::metadata_type metadata_type;
+    const nd::memory_block &src_arena = reinterpret_cast<const metadata_type *>(src_arrmeta)->blockref;
+    if (src_arena) {
+      ndt::string_type::get_arena(dst_arrmeta)->absorb(*src_arena);
+    }
+    break;
+  }
+  case option_id:
+    merge_arrmeta_blocks(tp.extended<ndt::option_type>()->get_value_type(), dst_arrmeta, src_arrmeta);
+    break;
+  case fixed_dim_id:
+    merge_arrmeta_blocks(tp.extended<ndt::fixed_dim_type>()->get_element_type(),
+                         dst_arrmeta + sizeof(fixed_dim_type_arrmeta), src_arrmeta + sizeof(fixed_dim_type_arrmeta));
+    break;
+  case var_dim_id: {
+    typedef ndt::var_dim_type::metadata_type metadata_type;
+    const metadata_type *dst_md = reinterpret_cast<const metadata_type *>(dst_arrmeta);
+    const metadata_type *src_md = reinterpret_cast<const metadata_type *>(src_arrmeta);
+    dst_md->blockref->absorb(*src_md->blockref);
+    merge_arrmeta_blocks(tp.extended<ndt::var_dim_type>()->get_element_type(), dst_arrmeta + sizeof(metadata_type),
+                         src_arrmeta + sizeof(metadata_type));
+    break;
+  }
+  case struct_id:
+    merge_field_blocks<ndt::struct_type>(tp, dst_arrmeta, src_arrmeta);
+    break;
+  case tuple_id:
+    merge_field_blocks<ndt::tuple_type>(tp, dst_arrmeta, src_arrmeta);
+    break;
+  default:
+    break;
+  }
+}
+
+/**
+ * Parses a large top-level JSON array with the threads of ``ectx``.
+ *
+ * A first pass finds where each element starts, which is cheap as the
+ * structural index skips strings, arrays and objects in O(1), and cuts the
+ * array into partitions of whole elements to parse concurrently. If the
+ * elements hold var_dim data or strings, each partition allocates them from
+ * memory blocks of its own, which are merged into those of the output
+ * afterwards.
+ *
+ * Returns false, consuming nothing, when the array should be parsed serially
+ * instead. This includes invalid JSON, which leaves the index invalid, so the
+ * serial parser reports the error.
+ */
+static bool parse_json_array_parallel(const ndt::type &tp, const char *arrmeta, char *out_data, const char *&begin,
+                                      const char *end, json::structural_index *index,
+                                      const eval::eval_context *ectx) {
+  if (ectx->nthreads == 1 || index == NULL || !index->is_valid() || end - begin < 2 * json_min_partition_size ||
+      (tp.get_id() != fixed_dim_id && tp.get_id() != var_dim_id) || thread_pool::in_parallel_region()) {
+    return false;
+  }
+
+  const ndt::base_dim_type *dim_tp = tp.extended<ndt::base_dim_type>();
+  const ndt::type &el_tp = dim_tp->get_element_type();
+  const char *el_arrmeta = arrmeta + dim_tp->get_element_arrmeta_offset();
+
+  // Elements with var_dim data or strings get arrmeta with memory blocks of
+  // their own for each partition
+  bool has_blockrefs = el_tp.get_arrmeta_size() > 0;
+  if (has_blockrefs && !is_mergeable_arrmeta(el_tp, el_arrmeta, nd::empty(el_tp).get()->metadata())) {
+    return false;
+  }
+
+  std::shared_ptr<thread_pool> pool = get_thread_pool(ectx->nthreads);
+  intptr_t partition_size =
+      std::max<intptr_t>((end - begin) / static_cast<intptr_t>(pool->get_nthreads() * 4), json_min_partition_size);
+
+  // Find the start of the first element of each partition
+  std::vector<const char *> starts;
+  std::vector<intptr_t> firsts;
+  intptr_t count = 0;
+  const char *rbegin = begin;
+  try {
+    json::structural_index scan_index(*index);
+    if (!parse_token(rbegin, end, "[")) {
+      return false;
+    }
+    if (!parse_token(rbegin, end, "]")) {
+      const char *partition_end = rbegin;
+      for (;;) {
+        skip_whitespace(rbegin, end);
+        if (rbegin >= partition_end) {
+          starts.push_back(rbegin);
+          firsts.push_back(count);
+          partition_end = rbegin + partition_size;
+        }
+        skip_json_value(rbegin, end, &scan_index);
+        ++count;
+        if (!parse_token(rbegin, end, ",")) {
+          break;
+        }
+      }
+      if (!parse_token(rbegin, end, "]")) {
+        return false;
+      }
+    }
+  } catch (const parse_error &) {
+    return false;
+  }
+  firsts.push_back(count);
+
+  size_t npartitions = starts.size();
+  if (npartitions < 2) {
+    return false;
+  }
+
+  intptr_t stride;
+  char *data;
+  if (tp.get_id() == fixed_dim_id) {
+    const fixed_dim_type_arrmeta *md = reinterpret_cast<const fixed_dim_type_arrmeta *>(arrmeta);
+    if (md->dim_size != count) {
+      return false;
+    }
+    stride = md->stride;
+    data = out_data;
+  } else {
+    const ndt::var_dim_type::metadata_type *md = reinterpret_cast<const ndt::var_dim_type::metadata_type *>(arrmeta);
+    ndt::var_dim_type::data_type *out = reinterpret_cast<ndt::var_dim_type::data_type *>(out_data);
+    out->begin = md->blockref->alloc(count);
+    out->size = count;
+    stride = md->stride;
+    data = out->begin;
+  }
+
+  std::vector<nd::array> partition_arrmeta;
+  if (has_blockrefs) {
+    for (size_t i = 0; i != npartitions; ++i) {
+      partition_arrmeta.push_back(nd::empty(el_tp));
+    }
+  }
+  auto merge = [&] {
+    for (size_t i = 0; i != partition_arrmeta.size(); ++i) {
+      merge_arrmeta_blocks(el_tp, el_arrmeta, partition_arrmeta[i].get()->metadata());
+    }
+  };
+
+  try {
+    pool->parallel_for(npartitions, 1, [&](size_t DYND_UNUSED(worker), size_t i_begin, size_t i_end) {
+      json::structural_index partition_index(*index);
+      for (size_t i = i_begin; i != i_end; ++i) {
+        const char *partition_begin = starts[i];
+        const char *partition_el_arrmeta = has_blockrefs ? partition_arrmeta[i].get()->metadata() : el_arrmeta;
+        partition_index.seek(partition_begin);
+        for (intptr_t j = firsts[i]; j != firsts[i + 1]; ++j) {
+          parse_json(el_tp, partition_el_arrmeta, data + j * stride, partition_begin, end, &partition_index, ectx);
+          if (!parse_token(partition_begin, end, j != count - 1 ? "," : "]")) {
+            throw json_parse_error(partition_begin, "expected array separator ',' or terminator ']'", tp);
+          }
+        }
+      }
+    });
+  } catch (...) {
+    // The elements parsed so far may point into the memory of any partition
+    merge();
+    throw;
+  }
+  merge();
+
+  begin = rbegin;
+  return true;
+}
+
 /**
  * Returns the row/column where the error occured, as well as the current and
  * previous
@@ -669,7 +1062,7 @@ void print_json_parse_error_marker(std::ostream &o, const std::string &line_prev
 void dynd::validate_json(const char *json_begin, const char *json_end) {
   try {
     const char *begin = json_begin, *end = json_end;
-    ::skip_json_value(begin, end);
+    ::skip_json_value(begin, end, NULL);
     skip_whitespace(begin, end);
     if (begin != end) {
       throw parse_error(begin, "unexpected trailing JSON text");
@@ -690,7 +1083,11 @@ void dynd::parse_json(nd::array &out, const char *json_begin, const char *json_e
   try {
     const char *begin = json_begin, *end = json_end;
     ndt::type tp = out.get_type();
-    ::parse_json(tp, out.get()->metadata(), out.data(), begin, end, ectx);
+    std::unique_ptr<json::structural_index> index = make_structural_index(json_begin, json_end);
+    skip_whitespace(begin, end);
+    if (!parse_json_array_parallel(tp, out.get()->metadata(), out.data(), begin, end, index.get(), ectx)) {
+      ::parse_json(tp, out.get()->metadata(), out.data(), begin, end, index.get(), ectx);
+    }
     skip_whitespace(begin, end);
     if (begin != end) {
       throw json_parse_error(begin, "unexpected trailing JSON text", tp);
@@ -728,9 +1125,125 @@ nd::array dynd::parse_json(const ndt::type &tp, const char *json_begin, const ch
   return result;
 }
 
-/*
-static ndt::type discover_type(const char *&begin, const char *end)
-{
+/**
+ * Calls ``f`` with each line completed by the chunk ``[begin, end)``. The
+ * incomplete line at the end of the chunk is kept in ``partial``, to be
+ * completed by the next chunk.
+ */
+template <class F>
+static void split_lines(std::string &partial, const char *begin, const char *end, F f) {
+  // Complete the line left over from the previous chunk
+  if (!partial.empty()) {
+    const char *newline = reinterpret_cast<const char *>(memchr(begin, '\n', end - begin));
+    if (newline == NULL) {
+      partial.append(begin, end);
+      return;
+    }
+    partial.append(begin, newline);
+    f(partial.data(), partial.data() + partial.size());
+    partial.clear();
+    begin = newline + 1;
+  }
+
+  // Pass the complete lines in place
+  for (;;) {
+    const char *newline = reinterpret_cast<const char *>(memchr(begin, '\n', end - begin));
+    if (newline == NULL) {
+      break;
+    }
+    f(begin, newline);
+    begin = newline + 1;
+  }
+
+  partial.assign(begin, end);
+}
+
+nd::json::ndjson_parser::ndjson_parser(const ndt::type &tp, intptr_t batch_size, const eval::eval_context *ectx)
+    : m_tp(tp), m_batch_size(batch_size), m_ectx(ectx), m_count(0), m_line(0) {
+  if (tp.is_symbolic()) {
+    stringstream ss;
+    ss << "cannot parse newline-delimited JSON into the symbolic type " << tp;
+    throw type_error(ss.str());
+  }
+  if (batch_size <= 0) {
+    throw invalid_argument("the batch size of a newline-delimited JSON parser must be positive");
+  }
+}
+
+void nd::json::ndjson_parser::parse_line(const char *line_begin, const char *line_end) {
+  ++m_line;
+  const char *begin = line_begin, *end = line_end;
+  skip_whitespace(begin, end);
+  if (begin == end) {
+    return;
+  }
+
+  if (m_batch.is_null()) {
+    m_batch = nd::empty(m_batch_size, m_tp);
+  }
+  const char *arrmeta = m_batch.get()->metadata();
+  intptr_t stride = reinterpret_cast<const fixed_dim_type_arrmeta *>(arrmeta)->stride;
+
+  try {
+    std::unique_ptr<json::structural_index> index = make_structural_index(begin, end);
+    ::parse_json(m_tp, arrmeta + sizeof(fixed_dim_type_arrmeta), m_batch.data() + m_count * stride, begin, end,
+                 index.get(), m_ectx);
+    skip_whitespace(begin, end);
+    if (begin != end) {
+      throw json_parse_error(begin, "unexpected trailing JSON text", m_tp);
+    }
+  } catch (const parse_error &e) {
+    stringstream ss;
+    std::string line_prev, line_cur;
+    int line, column;
+    get_error_line_column(line_begin, line_end, e.get_position(), line_prev, line_cur, line, column);
+    ss << "Error parsing JSON at line " << m_line << ", column " << column << "\n";
+    ss << "DyND Type: " << m_tp << "\n";
+    ss << "Message: " << e.what() << "\n";
+    print_json_parse_error_marker(ss, line_prev, line_cur, line, column);
+    throw invalid_argument(ss.str());
+  }
+
+  if (++m_count == m_batch_size) {
+    flush();
+  }
+}
+
+void nd::json::ndjson_parser::flush() {
+  if (!m_tp.is_builtin()) {
+    m_tp.extended()->arrmeta_finalize_buffers(m_batch.get()->metadata() + sizeof(fixed_dim_type_arrmeta));
+  }
+  m_batches.push_back(m_count == m_batch_size ? m_batch : m_batch(irange() < m_count));
+  m_batch = array();
+  m_count = 0;
+}
+
+void nd::json::ndjson_parser::feed(const char *begin, const char *end) {
+  split_lines(m_partial, begin, end,
+              [this](const char *line_begin, const char *line_end) { parse_line(line_begin, line_end); });
+}
+
+void nd::json::ndjson_parser::finish() {
+  if (!m_partial.empty()) {
+    parse_line(m_partial.data(), m_partial.data() + m_partial.size());
+    m_partial.clear();
+  }
+  if (m_count != 0) {
+    flush();
+  }
+}
+
+bool nd::json::ndjson_parser::next(array &out) {
+  if (m_batches.empty()) {
+    return false;
+  }
+
+  out = std::move(m_batches.front());
+  m_batches.pop_front();
+  return true;
+}
+
+static ndt::type discover_type(const char *&begin, const char *end) {
   skip_whitespace(begin, end);
   if (begin == end) {
     throw parse_error(begin, "malformed JSON, expecting an element");
@@ -740,56 +1253,67 @@ static ndt::type discover_type(const char *&begin, const char *end)
   // Object
   case '{': {
     ++begin;
-    if (parse_token(begin, end, "}")) {
-      return ndt::struct_type::make();
-    }
     std::vector<std::string> names;
     std::vector<ndt::type> types;
-    for (;;) {
-      const char *strbegin, *strend;
-      bool escaped;
-      skip_whitespace(begin, end);
-      if (!parse_doublequote_string_no_ws(begin, end, strbegin, strend, escaped)) {
-        throw parse_error(begin, "expected string for name in object dict");
-      }
-      names.emplace_back(strbegin, strend - strbegin);
-      if (!parse_token(begin, end, ":")) {
-        throw parse_error(begin, "expected ':' separating name from value in object dict");
+    if (!parse_token(begin, end, "}")) {
+      for (;;) {
+        const char *strbegin, *strend;
+        bool escaped;
+        skip_whitespace(begin, end);
+        if (!parse_doublequote_string_no_ws(begin, end, strbegin, strend, escaped)) {
+          throw parse_error(begin, "expected string for name in object dict");
+        }
+        names.emplace_back();
+        if (escaped) {
+          unescape_string(strbegin, strend, names.back());
+        } else {
+          names.back().assign(strbegin, strend);
+        }
+        if (!parse_token(begin, end, ":")) {
+          throw parse_error(begin, "expected ':' separating name from value in object dict");
+        }
+        types.push_back(discover_type(begin, end));
+        if (!parse_token(begin, end, ",")) {
+          break;
+        }
       }
-      types.push_back(discover_type(begin, end));
-      if (!parse_token(begin, end, ",")) {
-        break;
+      if (!parse_token(begin, end, "}")) {
+        throw parse_error(begin, "expected object separator ',' or terminator '}'");
       }
     }
-    if (!parse_token(begin, end, "}")) {
-      throw parse_error(begin, "expected object separator ',' or terminator '}'");
-    }
-    return ndt::struct_type::make(names, types);
+    return ndt::make_type<ndt::struct_type>(names, types);
   }
   // Array
   case '[': {
     ++begin;
     if (parse_token(begin, end, "]")) {
-      return ndt::tuple_type::make();
+      return ndt::make_type<ndt::tuple_type>();
     }
+    // The types of the elements are kept for a tuple, in case they turn out
+    // to have no common type
     std::vector<ndt::type> types;
-    ndt::type common_tp = discover_type(begin, end);
-    types.push_back(common_tp);
+    ndt::type common_tp;
+    bool has_common_tp = true;
     for (;;) {
+      types.push_back(discover_type(begin, end));
+      if (types.size() == 1) {
+        common_tp = types.back();
+      } else if (has_common_tp) {
+        try {
+          common_tp = promote_types_inferred(common_tp, types.back());
+        } catch (const dynd::type_error &) {
+          has_common_tp = false;
+        }
+      }
       if (!parse_token(begin, end, ",")) {
         break;
       }
-      const ndt::type &tp = discover_type(begin, end);
-      if (!common_tp.is_null()) {
-        common_tp = ndt::common_type(common_tp, tp);
-      }
-      types.push_back(tp);
     }
     if (!parse_token(begin, end, "]")) {
       throw parse_error(begin, "expected array separator ',' or terminator ']'");
     }
-    if (common_tp.is_null()) {
-      return ndt::tuple_type::make(types);
+    if (!has_common_tp) {
+      return ndt::make_type<ndt::tuple_type>(types);
     }
     return ndt::make_fixed_dim(types.size(), common_tp);
   }
@@ -799,25 +1323,21 @@ static ndt::type discover_type(const char *&begin, const char *end)
     if (!parse_doublequote_string_no_ws(begin, end, strbegin, strend, escaped)) {
       throw parse_error(begin, "invalid string");
     }
-    return ndt::type(string_id);
+    return ndt::make_type<ndt::string_type>();
   }
-  case 'T':
   case 't':
-    ++begin;
-    if (parse_token(begin, end, "rue")) {
+    if (parse_token(begin, end, "true")) {
       return ndt::make_type<bool1>();
     }
     throw parse_error(begin, "invalid json value");
-  case 'F':
   case 'f':
-    ++begin;
-    if (parse_token(begin, end, "alse")) {
+    if (parse_token(begin, end, "false")) {
       return ndt::make_type<bool1>();
     }
     throw parse_error(begin, "invalid json value");
   case 'n':
     if (parse_token(begin, end, "null")) {
-      return ndt::make_type<ndt::option_type>(ndt::type("Any"));
+      return ndt::make_type<ndt::option_type>();
     }
     throw parse_error(begin, "invalid json value");
   default:
@@ -826,48 +1346,182 @@ static ndt::type discover_type(const char *&begin, const char *end)
       if (!json::parse_number(begin, end, nbegin, nend)) {
         throw parse_error(begin, "invalid number");
       }
-      int64_t int_val;
-      try {
-        parse_int64(int_val, nbegin, nend);
-        return ndt::make_type<int64>();
-      }
-      catch (...) {
-      }
-      double float_val;
-      if (!parse_double(float_val, nbegin, nend)) {
-        return ndt::make_type<double>();
+      if (std::find_if(nbegin, nend, [](char d) { return d == '.' || d == 'e' || d == 'E'; }) == nend) {
+        try {
+          parse<int64_t>(nbegin, nend);
+          return ndt::make_type<int64>();
+        } catch (const std::overflow_error &) {
+          // Integers too big for int64 are discovered as float64
+        }
       }
+      return ndt::make_type<double>();
+    } else {
       throw parse_error(begin, "invalid json value");
     }
-    else {
-      throw parse_error(begin, "invalid json value");
+  }
+}
+
+/**
+ * Discovers the type of the elements of the JSON array at ``begin`` from a
+ * sample of them, returning ``var * T``, or ``()`` if the array is empty.
+ */
+static ndt::type discover_sampled_array_type(const char *begin, const char *end, json::structural_index *index,
+                                             const ndt::json::discover_options &options) {
+  if (!parse_token(begin, end, "[")) {
+    throw parse_error(begin, "expected array starting with '['");
+  }
+
+  // Find where the sampled elements start
+  std::vector<const char *> sample;
+  if (!parse_token(begin, end, "]")) {
+    std::default_random_engine random(options.seed);
+    for (intptr_t count = 0;; ++count) {
+      skip_whitespace(begin, end);
+      if (count < options.sample_size) {
+        sample.push_back(begin);
+      } else if (!options.random) {
+        break;
+      } else {
+        intptr_t i = std::uniform_int_distribution<intptr_t>(0, count)(random);
+        if (i < options.sample_size) {
+          sample[i] = begin;
+        }
+      }
+      skip_json_value(begin, end, index);
+      if (!parse_token(begin, end, ",")) {
+        if (!parse_token(begin, end, "]")) {
+          throw parse_error(begin, "expected array separator ',' or terminator ']'");
+        }
+        break;
+      }
     }
   }
+  if (sample.empty()) {
+    // Like discover_type, as there is no element type
+    return ndt::make_type<ndt::tuple_type>();
+  }
+
+  // Merge the types in the order of the elements, which fixes the order of
+  // the fields of structs
+  std::sort(sample.begin(), sample.end());
+  ndt::type tp;
+  for (const char *el_begin : sample) {
+    ndt::type el_tp = discover_type(el_begin, end);
+    tp = tp.is_null() ? el_tp : promote_types_inferred(tp, el_tp);
+  }
+
+  return ndt::make_type<ndt::var_dim_type>(tp);
+}
 
-  throw runtime_error("json parsing error");
+void ndt::json::discover(ndt::type &res, const char *json_begin, const char *json_end) {
+  discover(res, json_begin, json_end, discover_options());
 }
-*/
 
-/*
-void ndt::json::discover(ndt::type &res, const char *json_begin, const char *json_end)
-{
+void ndt::json::discover(ndt::type &res, const char *json_begin, const char *json_end,
+                         const discover_options &options) {
   try {
     const char *begin = json_begin, *end = json_end;
+    skip_whitespace(begin, end);
+    if (options.sample_size > 0 && begin != end && *begin == '[') {
+      // Only a random sample needs to skip over all the elements
+      std::unique_ptr<dynd::json::structural_index> index;
+      if (options.random) {
+        index = make_structural_index(begin, end);
+      }
+      res = discover_sampled_array_type(begin, end, index.get(), options);
+      return;
+    }
+
     res = ::discover_type(begin, end);
     skip_whitespace(begin, end);
     if (begin != end) {
       throw parse_error(begin, "unexpected trailing JSON text");
     }
-  }
-  catch (const parse_error &e) {
+  } catch (const parse_error &e) {
     stringstream ss;
     std::string line_prev, line_cur;
     int line, column;
     get_error_line_column(json_begin, json_end, e.get_position(), line_prev, line_cur, line, column);
-    ss << "Error validating JSON at line " << line << ", column " << column << "\n";
+    ss << "Error discovering the type of JSON at line " << line << ", column " << column << "\n";
     ss << "Message: " << e.what() << "\n";
     print_json_parse_error_marker(ss, line_prev, line_cur, line, column);
     throw invalid_argument(ss.str());
   }
 }
-*/
+
+ndt::json::ndjson_discoverer::ndjson_discoverer(const discover_options &options)
+    : m_options(options), m_count(0), m_line(0), m_random(options.seed) {
+  if (options.sample_size < 0) {
+    throw invalid_argument("the sample size of JSON type discovery must not be negative");
+  }
+}
+
+void ndt::json::ndjson_discoverer::discover_record(intptr_t line, const char *begin, const char *end) {
+  const char *rbegin = begin;
+  ndt::type tp;
+  try {
+    tp = ::discover_type(rbegin, end);
+    skip_whitespace(rbegin, end);
+    if (rbegin != end) {
+      throw parse_error(rbegin, "unexpected trailing JSON text");
+    }
+  } catch (const parse_error &e) {
+    stringstream ss;
+    std::string line_prev, line_cur;
+    int error_line, column;
+    get_error_line_column(begin, end, e.get_position(), line_prev, line_cur, error_line, column);
+    ss << "Error discovering the type of JSON at line " << line << ", column " << column << "\n";
+    ss << "Message: " << e.what() << "\n";
+    print_json_parse_error_marker(ss, line_prev, line_cur, error_line, column);
+    throw invalid_argument(ss.str());
+  }
+
+  m_tp = m_tp.is_null() ? tp : promote_types_inferred(m_tp, tp);
+}
+
+void ndt::json::ndjson_discoverer::discover_line(const char *begin, const char *end) {
+  ++m_line;
+  skip_whitespace(begin, end);
+  if (begin == end || is_done()) {
+    return;
+  }
+
+  if (!m_options.random || m_options.sample_size == 0) {
+    discover_record(m_line, begin, end);
+  } else if (m_count < m_options.sample_size) {
+    m_sample.emplace_back(m_line, std::string(begin, end));
+  } else {
+    // Reservoir sampling keeps every record seen so far with equal chance
+    intptr_t i = std::uniform_int_distribution<intptr_t>(0, m_count)(m_random);
+    if (i < m_options.sample_size) {
+      m_sample[i].first = m_line;
+      m_sample[i].second.assign(begin, end);
+    }
+  }
+  ++m_count;
+}
+
+void ndt::json::ndjson_discoverer::feed(const char *begin, const char *end) {
+  if (is_done()) {
+    return;
+  }
+
+  split_lines(m_partial, begin, end, [this](const char *line_begin, const char *line_end) {
+    discover_line(line_begin, line_end);
+  });
+}
+
+void ndt::json::ndjson_discoverer::finish() {
+  if (!m_partial.empty()) {
+    discover_line(m_partial.data(), m_partial.data() + m_partial.size());
+    m_partial.clear();
+  }
+
+  // Merge the types in the order of the lines, which fixes the order of the
+  // fields of structs
+  std::sort(m_sample.begin(), m_sample.end());
+  for (const auto &record : m_sample) {
+    discover_record(record.first, record.second.data(), record.second.data() + record.second.size());
+  }
+  m_sample.clear();
+}
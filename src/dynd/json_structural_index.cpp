@@ -0,0 +1,332 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <dynd/json_structural_index.hpp>
+#include <dynd/parse_util.hpp>
+#include <dynd/simd_isa.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+/**
+ * Bit masks of the characters of one 64 byte block, with bit ``i`` for byte
+ * ``i``.
+ */
+struct block_masks {
+  uint64_t quote;
+  uint64_t backslash;
+  uint64_t bracket;
+};
+
+void classify_scalar(const char *p, block_masks &m) {
+  m.quote = 0;
+  m.backslash = 0;
+  m.bracket = 0;
+  for (int i = 0; i < 64; ++i) {
+    char c = p[i];
+    uint64_t bit = static_cast<uint64_t>(1) << i;
+    if (c == '"') {
+      m.quote |= bit;
+    } else if (c == '\\') {
+      m.backslash |= bit;
+    } else if (c == '{' || c == '}' || c == '[' || c == ']') {
+      m.bracket |= bit;
+    }
+  }
+}
+
+#ifdef DYND_SIMD_X86
+
+// As '[' and ']' differ from '{' and '}' only in bit 5, setting that bit
+// finds all four with two comparisons.
+#define DYND_DEF_CLASSIFY(ISA, TARGET, WIDTH, MOVEMASK)                                                                \
+  __attribute__((target(TARGET))) void classify_##ISA(const char *p, block_masks &m) {                                 \
+    typedef char vector_type __attribute__((vector_size(WIDTH)));                                                      \
+    m.quote = 0;                                                                                                       \
+    m.backslash = 0;                                                                                                   \
+    m.bracket = 0;                                                                                                     \
+    for (int i = 0; i < 64; i += WIDTH) {                                                                              \
+      vector_type v;                                                                                                   \
+      memcpy(&v, p + i, WIDTH);                                                                                        \
+      vector_type w = v | 0x20;                                                                                        \
+      vector_type bracket = (vector_type)((w == '{') | (w == '}'));                                                    \
+      m.quote |= static_cast<uint64_t>(static_cast<uint32_t>(MOVEMASK((vector_type)(v == '"')))) << i;                 \
+      m.backslash |= static_cast<uint64_t>(static_cast<uint32_t>(MOVEMASK((vector_type)(v == '\\')))) << i;            \
+      m.bracket |= static_cast<uint64_t>(static_cast<uint32_t>(MOVEMASK(bracket))) << i;                               \
+    }                                                                                                                  \
+  }
+
+DYND_DEF_CLASSIFY(sse2, "sse2", 16, __builtin_ia32_pmovmskb128)
+DYND_DEF_CLASSIFY(avx2, "avx2", 32, __builtin_ia32_pmovmskb256)
+
+#undef DYND_DEF_CLASSIFY
+
+typedef void (*classify_t)(const char *, block_masks &);
+
+classify_t get_classify() {
+  switch (detail::get_cpu_simd_isa(detail::simd_isa_avx2)) {
+  case detail::simd_isa_avx2:
+    return &classify_avx2;
+  case detail::simd_isa_sse2:
+    return &classify_sse2;
+  default:
+    return &classify_scalar;
+  }
+}
+
+#else
+
+typedef void (*classify_t)(const char *, block_masks &);
+
+classify_t get_classify() { return &classify_scalar; }
+
+#endif
+
+/**
+ * Returns the mask of the characters escaped by a backslash, given the mask
+ * of backslashes. ``carry`` is set when the block ends in an escape, so that
+ * the first character of the next block is escaped.
+ */
+inline uint64_t find_escaped(uint64_t backslash, uint64_t &carry) {
+  const uint64_t even_bits = 0x5555555555555555ULL;
+
+  backslash &= ~carry;
+  uint64_t follows_escape = backslash << 1 | carry;
+
+  // Adding the starts of the runs of backslashes on odd bits to the mask
+  // carries through each run, which flips the parity of the runs that
+  // start on odd bits
+  uint64_t odd_starts = backslash & ~even_bits & ~follows_escape;
+  uint64_t even_starts = odd_starts + backslash;
+  carry = even_starts < backslash ? 1 : 0;
+
+  return (even_bits ^ (even_starts << 1)) & follows_escape;
+}
+
+/**
+ * Returns the mask with bit ``i`` set to the parity of the bits up to and
+ * including ``i`` of ``x``.
+ */
+inline uint64_t prefix_xor(uint64_t x) {
+  x ^= x << 1;
+  x ^= x << 2;
+  x ^= x << 4;
+  x ^= x << 8;
+  x ^= x << 16;
+  x ^= x << 32;
+  return x;
+}
+
+inline int count_trailing_zeros(uint64_t x) {
+#ifdef __GNUC__
+  return __builtin_ctzll(x);
+#else
+  int n = 0;
+  for (; (x & 1) == 0; x >>= 1) {
+    ++n;
+  }
+  return n;
+#endif
+}
+
+} // anonymous namespace
+
+json::structural_index::structural_index(const char *begin, const char *end)
+    : m_begin(begin), m_end(end), m_entries(new entries_type), m_cursor(0), m_valid(true) {
+  build();
+}
+
+void json::structural_index::build() {
+  static const classify_t classify = get_classify();
+
+  vector<uint32_t> &positions = m_entries->positions;
+  vector<uint32_t> &close = m_entries->close;
+  vector<bool> &escaped = m_entries->escaped;
+
+  // The entries grow with the structure found rather than being reserved
+  // from the length of the document
+  size_t size = m_end - m_begin;
+  if (size > numeric_limits<uint32_t>::max()) {
+    m_valid = false;
+    return;
+  }
+
+  // The entries of the quotes and brackets that are not closed yet
+  vector<uint32_t> open;
+
+  uint64_t escaped_carry = 0, in_string_carry = 0;
+  // Whether the string that is open has a backslash so far
+  bool string_escaped = false;
+  char tail[64];
+  for (size_t offset = 0; offset < size; offset += 64) {
+    const char *p = m_begin + offset;
+    if (size - offset < 64) {
+      memset(tail, ' ', sizeof(tail));
+      memcpy(tail, p, size - offset);
+      p = tail;
+    }
+
+    block_masks m;
+    classify(p, m);
+
+    uint64_t quote = m.quote & ~find_escaped(m.backslash, escaped_carry);
+    uint64_t in_string = prefix_xor(quote) ^ in_string_carry;
+    in_string_carry = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+    // The backslashes of the block not yet attributed to a string
+    uint64_t string_backslash = m.backslash & in_string;
+
+    for (uint64_t bits = quote | (m.bracket & ~in_string); bits != 0; bits &= bits - 1) {
+      int i = count_trailing_zeros(bits);
+      uint32_t entry = static_cast<uint32_t>(positions.size());
+      positions.push_back(static_cast<uint32_t>(offset + i));
+      close.push_back(0);
+      escaped.push_back(false);
+
+      char c = p[i];
+      if (c == '"') {
+        // Strings do not nest, so the backslashes before a quote belong to
+        // the string it closes, if any
+        uint64_t below = (static_cast<uint64_t>(1) << i) - 1;
+        string_escaped = ((in_string >> i) & 1) == 0 && (string_escaped || (string_backslash & below) != 0);
+        string_backslash &= ~below;
+      }
+      if ((c == '"' && ((in_string >> i) & 1) != 0) || c == '{' || c == '[') {
+        open.push_back(entry);
+        continue;
+      }
+
+      char expected = c == '"' ? '"' : (c == '}' ? '{' : '[');
+      if (open.empty() || *get(open.back()) != expected) {
+        m_valid = false;
+        return;
+      }
+      close[open.back()] = entry;
+      escaped[open.back()] = c == '"' && string_escaped;
+      open.pop_back();
+    }
+    string_escaped = string_escaped || string_backslash != 0;
+  }
+
+  m_valid = open.empty() && validate();
+  m_cursor = 0;
+}
+
+/**
+ * Checks that the document is a single JSON value, jumping over the body of
+ * each string without escapes. It returns false where the parser without an
+ * index would report an error.
+ */
+bool json::structural_index::validate() {
+  const char *begin = m_begin, *end = m_end;
+  // The arrays and objects that enclose the current value, as '[' or '{'
+  vector<char> enclosing;
+
+  // Skips the string at ``begin``, checking its escapes if it has any
+  auto skip_string = [&]() {
+    bool escaped;
+    const char *close = *begin == '"' ? find_close(begin, &escaped) : NULL;
+    if (close == NULL) {
+      return false;
+    }
+    if (escaped) {
+      const char *strbegin, *strend;
+      parse_doublequote_string_no_ws(begin, end, strbegin, strend, escaped);
+    }
+    begin = close + 1;
+    return true;
+  };
+  auto skip_name = [&]() {
+    skip_whitespace(begin, end);
+    return begin != end && skip_string() && parse_token(begin, end, ':');
+  };
+
+  try {
+    for (;;) {
+      skip_whitespace(begin, end);
+      if (begin == end) {
+        return false;
+      }
+      char c = *begin;
+      if (c == '[' || c == '{') {
+        ++begin;
+        if (!parse_token(begin, end, c == '[' ? ']' : '}')) {
+          enclosing.push_back(c);
+          if (c == '{' && !skip_name()) {
+            return false;
+          }
+          continue;
+        }
+      } else if (c == '"') {
+        if (!skip_string()) {
+          return false;
+        }
+      } else if (!parse_token(begin, end, "true") && !parse_token(begin, end, "false") &&
+                 !parse_token(begin, end, "null")) {
+        const char *nbegin, *nend;
+        if (!json::parse_number(begin, end, nbegin, nend)) {
+          return false;
+        }
+      }
+
+      // After a value, close the arrays and objects it ends
+      for (;;) {
+        if (enclosing.empty()) {
+          skip_whitespace(begin, end);
+          return begin == end;
+        }
+        if (parse_token(begin, end, ',')) {
+          if (enclosing.back() == '{' && !skip_name()) {
+            return false;
+          }
+          break;
+        }
+        if (!parse_token(begin, end, enclosing.back() == '[' ? ']' : '}')) {
+          return false;
+        }
+        enclosing.pop_back();
+      }
+    }
+  } catch (const parse_error &) {
+    return false;
+  }
+}
+
+intptr_t json::structural_index::find(const char *p) {
+  if (!m_valid || p < m_begin || p >= m_end) {
+    return -1;
+  }
+
+  const vector<uint32_t> &positions = m_entries->positions;
+  size_t pos = p - m_begin;
+  if (m_cursor > 0 && positions[m_cursor - 1] >= pos) {
+    // Looking back, which the parser only does to report an error
+    m_cursor = lower_bound(positions.begin(), positions.begin() + m_cursor, pos) - positions.begin();
+  }
+  while (m_cursor < positions.size() && positions[m_cursor] < pos) {
+    ++m_cursor;
+  }
+
+  if (m_cursor < positions.size() && positions[m_cursor] == pos) {
+    return m_cursor;
+  }
+
+  return -1;
+}
+
+void json::structural_index::seek(const char *p) {
+  const vector<uint32_t> &positions = m_entries->positions;
+  size_t pos = p < m_begin ? 0 : p - m_begin;
+  m_cursor = lower_bound(positions.begin(), positions.end(), pos) - positions.begin();
+}
+
+const char *json::get_structural_index_isa() {
+  return detail::get_simd_isa_name(detail::get_cpu_simd_isa(detail::simd_isa_avx2));
+}
@@ -0,0 +1,100 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <dynd/kernels/prepared_kernel.hpp>
+#include <dynd/option.hpp>
+
+using namespace std;
+using namespace dynd;
+
+nd::prepared_kernel::prepared_kernel(const callable &f, const ndt::type &dst_tp, const char *dst_arrmeta, size_t nsrc,
+                                     const ndt::type *src_tp, const char *const *src_arrmeta,
+                                     kernel_request_t kernreq,
+                                     std::initializer_list<std::pair<const char *, array>> kwds)
+    : m_dst_tp(dst_tp), m_src_tp(src_tp, src_tp + nsrc), m_kernreq(kernreq) {
+  prepare(f, dst_arrmeta, src_arrmeta, kwds);
+}
+
+void nd::prepared_kernel::prepare(const callable &f, const char *dst_arrmeta, const char *const *src_arrmeta,
+                                  std::initializer_list<std::pair<const char *, array>> kwds) {
+  kernel_request_t kernreq = m_kernreq;
+  size_t nsrc = m_src_tp.size();
+  const ndt::type &dst_tp = m_dst_tp;
+  const ndt::type *src_tp = m_src_tp.data();
+
+  if (kernreq != kernel_request_single && kernreq != kernel_request_strided) {
+    throw invalid_argument("a prepared kernel must be either single or strided, got kernel request " +
+                           to_string(kernreq));
+  }
+
+  if (dst_tp.is_symbolic()) {
+    stringstream ss;
+    ss << "cannot prepare a kernel with the symbolic destination type " << dst_tp;
+    throw invalid_argument(ss.str());
+  }
+
+  std::map<std::string, ndt::type> tp_vars;
+
+  detail::check_narg(f.get(), nsrc);
+  for (size_t i = 0; i < nsrc; ++i) {
+    detail::check_arg(f.get(), i, src_tp[i], src_arrmeta[i], tp_vars);
+  }
+
+  if (!f->get_ret_type().match(dst_tp, tp_vars)) {
+    stringstream ss;
+    ss << "destination type " << dst_tp << " does not match callable return type " << f->get_ret_type();
+    throw invalid_argument(ss.str());
+  }
+
+  // Order the keywords as in the callable type, filling in missing optional
+  // ones with missing values
+  const std::vector<std::pair<ndt::type, std::string>> &kwd_tp = f->get_kwd_types();
+  std::vector<array> kwd_values(f->get_nkwd());
+  for (const auto &kwd : kwds) {
+    intptr_t k = f->get_kwd_index(kwd.first);
+    if (k == -1) {
+      stringstream ss;
+      ss << "passed an unexpected keyword \"" << kwd.first << "\" to callable with type " << f->get_type();
+      throw invalid_argument(ss.str());
+    }
+    kwd_values[k] = kwd.second;
+  }
+  for (intptr_t j : f->get_option_kwd_indices()) {
+    if (kwd_values[j].is_null()) {
+      ndt::type actual_tp = ndt::substitute(kwd_tp[j].first, tp_vars, false);
+      if (actual_tp.is_symbolic()) {
+        actual_tp = ndt::make_type<ndt::option_type>(ndt::make_type<void>());
+      }
+      kwd_values[j] = assign_na({{"dst_tp", actual_tp}});
+    }
+  }
+  for (const array &value : kwd_values) {
+    if (value.is_null()) {
+      stringstream ss;
+      ss << "callable requires keyword parameters that were not provided. callable signature " << f->get_type();
+      throw invalid_argument(ss.str());
+    }
+  }
+
+  ndt::type res_tp = dst_tp;
+  m_cg = f->resolve_cached(res_tp, nsrc, src_tp, kwd_values.size(), kwd_values.data(), tp_vars);
+
+  m_kb.reset(new kernel_builder(m_cg->get()));
+  (*m_kb)(kernreq, nullptr, dst_arrmeta, nsrc, src_arrmeta);
+}
+
+nd::prepared_kernel::prepared_kernel(const callable &f, const array &dst, std::initializer_list<array> src,
+                                     kernel_request_t kernreq,
+                                     std::initializer_list<std::pair<const char *, array>> kwds)
+    : m_dst_tp(dst.get_type()), m_kernreq(kernreq), m_arrays(1, dst) {
+  std::vector<const char *> src_arrmeta;
+  for (const array &a : src) {
+    m_src_tp.push_back(a.get_type());
+    src_arrmeta.push_back(a->metadata());
+    m_arrays.push_back(a);
+  }
+
+  prepare(f, dst->metadata(), src_arrmeta.data(), kwds);
+}
@@ -0,0 +1,181 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cstring>
+
+#include <dynd/kernels/simd_arithmetic.hpp>
+#include <dynd/simd_isa.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+template <detail::simd_binary_op_t Op, typename T>
+inline T apply_op(T a, T b) {
+  switch (Op) {
+  case detail::simd_add:
+    return a + b;
+  case detail::simd_subtract:
+    return a - b;
+  case detail::simd_multiply:
+    return a * b;
+  default:
+    return a / b;
+  }
+}
+
+#ifdef DYND_SIMD_X86
+
+// The body of every loop, written with GCC vector extensions so that it is
+// compiled for the instruction set of the function it is inlined into. The
+// vectors never cross a function boundary, which would change the ABI.
+template <detail::simd_binary_op_t Op, typename T, size_t Width, bool Scalar0, bool Scalar1>
+__attribute__((always_inline)) inline void vector_loop(char *dst, const char *src0, const char *src1,
+                                                       size_t count) {
+  typedef T vector_type __attribute__((vector_size(Width)));
+  const size_t n = Width / sizeof(T);
+
+  T a0, b0;
+  vector_type a = {}, b = {};
+  if (Scalar0) {
+    memcpy(&a0, src0, sizeof(T));
+    a += a0;
+  }
+  if (Scalar1) {
+    memcpy(&b0, src1, sizeof(T));
+    b += b0;
+  }
+
+  size_t i = 0;
+  for (; i + n <= count; i += n) {
+    if (!Scalar0) {
+      memcpy(&a, src0 + i * sizeof(T), Width);
+    }
+    if (!Scalar1) {
+      memcpy(&b, src1 + i * sizeof(T), Width);
+    }
+    vector_type res;
+    switch (Op) {
+    case detail::simd_add:
+      res = a + b;
+      break;
+    case detail::simd_subtract:
+      res = a - b;
+      break;
+    case detail::simd_multiply:
+      res = a * b;
+      break;
+    default:
+      res = a / b;
+      break;
+    }
+    memcpy(dst + i * sizeof(T), &res, Width);
+  }
+
+  for (; i < count; ++i) {
+    if (!Scalar0) {
+      memcpy(&a0, src0 + i * sizeof(T), sizeof(T));
+    }
+    if (!Scalar1) {
+      memcpy(&b0, src1 + i * sizeof(T), sizeof(T));
+    }
+    T res = apply_op<Op>(a0, b0);
+    memcpy(dst + i * sizeof(T), &res, sizeof(T));
+  }
+}
+
+#define DYND_DEF_SIMD_LOOP(ISA, TARGET, WIDTH)                                                                        \
+  template <detail::simd_binary_op_t Op, typename T>                                                                  \
+  __attribute__((target(TARGET))) void ISA##_loop(char *dst, const char *src0, intptr_t src0_stride,                 \
+                                                  const char *src1, intptr_t src1_stride, size_t count) {             \
+    if (src0_stride == 0) {                                                                                           \
+      vector_loop<Op, T, WIDTH, true, false>(dst, src0, src1, count);                                                 \
+    } else if (src1_stride == 0) {                                                                                    \
+      vector_loop<Op, T, WIDTH, false, true>(dst, src0, src1, count);                                                 \
+    } else {                                                                                                          \
+      vector_loop<Op, T, WIDTH, false, false>(dst, src0, src1, count);                                                \
+    }                                                                                                                 \
+  }
+
+DYND_DEF_SIMD_LOOP(sse2, "sse2", 16)
+DYND_DEF_SIMD_LOOP(avx2, "avx2", 32)
+DYND_DEF_SIMD_LOOP(avx512f, "avx512f", 64)
+
+#undef DYND_DEF_SIMD_LOOP
+
+template <detail::simd_binary_op_t Op, typename T>
+detail::simd_binary_t get_loop() {
+  switch (detail::get_cpu_simd_isa()) {
+  case detail::simd_isa_avx512f:
+    return &avx512f_loop<Op, T>;
+  case detail::simd_isa_avx2:
+    return &avx2_loop<Op, T>;
+  case detail::simd_isa_sse2:
+    return &sse2_loop<Op, T>;
+  default:
+    return NULL;
+  }
+}
+
+#else
+
+template <detail::simd_binary_op_t Op, typename T>
+void scalar_loop(char *dst, const char *src0, intptr_t src0_stride, const char *src1, intptr_t src1_stride,
+                 size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    *reinterpret_cast<T *>(dst) =
+        apply_op<Op>(*reinterpret_cast<const T *>(src0), *reinterpret_cast<const T *>(src1));
+    dst += sizeof(T);
+    src0 += src0_stride;
+    src1 += src1_stride;
+  }
+}
+
+// Without a way to pick the instruction set at runtime, the contiguous loop
+// is left to the auto-vectorizer of the compiler
+template <detail::simd_binary_op_t Op, typename T>
+detail::simd_binary_t get_loop() {
+  return &scalar_loop<Op, T>;
+}
+
+#endif
+
+template <detail::simd_binary_op_t Op>
+detail::simd_binary_t get_loop(type_id_t id) {
+  switch (id) {
+  case int32_id:
+    return (Op == detail::simd_divide) ? NULL : get_loop<Op, int32_t>();
+  case int64_id:
+    return (Op == detail::simd_divide) ? NULL : get_loop<Op, int64_t>();
+  case float32_id:
+    return get_loop<Op, float>();
+  case float64_id:
+    return get_loop<Op, double>();
+  default:
+    return NULL;
+  }
+}
+
+} // anonymous namespace
+
+detail::simd_binary_t detail::get_simd_binary(simd_binary_op_t op, type_id_t id) {
+  // Integer division checks for a zero divisor one element at a time, so it
+  // has no loop here
+  switch (op) {
+  case simd_add:
+    return get_loop<simd_add>(id);
+  case simd_subtract:
+    return get_loop<simd_subtract>(id);
+  case simd_multiply:
+    return get_loop<simd_multiply>(id);
+  case simd_divide:
+    return get_loop<simd_divide>(id);
+  default:
+    return NULL;
+  }
+}
+
+const char *detail::get_simd_isa() { return get_simd_isa_name(get_cpu_simd_isa()); }
@@ -0,0 +1,209 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <map>
+#include <set>
+#include <sstream>
+
+#include <dynd/arithmetic.hpp>
+#include <dynd/callables/fused_callable.hpp>
+#include <dynd/comparison.hpp>
+#include <dynd/functional.hpp>
+#include <dynd/lazy.hpp>
+#include <dynd/math.hpp>
+
+using namespace std;
+using namespace dynd;
+
+struct nd::lazy::expr::node {
+  // The value of a leaf
+  array value;
+  // Otherwise, the call
+  callable func;
+  std::vector<expr> args;
+};
+
+namespace {
+
+// The most arrays elwise can take
+const size_t max_nsrc = 7;
+
+/**
+ * The expression flattened into the distinct arrays it reads, followed by
+ * the steps that compute it in an order where every step comes after its
+ * arguments.
+ */
+struct program {
+  std::vector<nd::array> srcs;
+  std::vector<nd::functional::fused_step> steps;
+  std::map<const void *, size_t> src_indices;
+  std::map<const void *, size_t> step_indices;
+  std::set<const void *> visited;
+
+  void add_srcs(const nd::lazy::expr &e) {
+    const nd::lazy::expr::node *n = e.get();
+    if (n->func.is_null()) {
+      if (src_indices.emplace(n->value.get(), srcs.size()).second) {
+        srcs.push_back(n->value);
+      }
+    } else if (visited.insert(n).second) {
+      for (const nd::lazy::expr &arg : n->args) {
+        add_srcs(arg);
+      }
+    }
+  }
+
+  // Called once every source is known, returns the argument index of ``e``
+  size_t add_steps(const nd::lazy::expr &e) {
+    const nd::lazy::expr::node *n = e.get();
+    if (n->func.is_null()) {
+      return src_indices[n->value.get()];
+    }
+
+    auto it = step_indices.find(n);
+    if (it != step_indices.end()) {
+      return it->second;
+    }
+
+    nd::functional::fused_step step;
+    step.func = n->func;
+    std::vector<ndt::type> src_tp;
+    for (const nd::lazy::expr &arg : n->args) {
+      size_t i = add_steps(arg);
+      step.args.push_back(i);
+      src_tp.push_back(i < srcs.size() ? srcs[i].get_dtype() : steps[i - srcs.size()].tp);
+    }
+    step.tp = step.func.resolve(step.func->get_ret_type(), src_tp.size(), src_tp.data(), 0, nullptr);
+
+    steps.push_back(step);
+    size_t index = srcs.size() + steps.size() - 1;
+    step_indices[n] = index;
+    return index;
+  }
+};
+
+nd::array eval_unfused(const nd::lazy::expr &e, std::map<const void *, nd::array> &values) {
+  const nd::lazy::expr::node *n = e.get();
+  if (n->func.is_null()) {
+    return n->value;
+  }
+
+  nd::array &value = values[n];
+  if (value.is_null()) {
+    std::vector<nd::array> args;
+    for (const nd::lazy::expr &arg : n->args) {
+      args.push_back(eval_unfused(arg, values));
+    }
+    value = n->func.call(args.size(), args.data(), 0, nullptr);
+  }
+
+  return value;
+}
+
+} // anonymous namespace
+
+nd::lazy::expr::expr(const array &value) {
+  std::shared_ptr<node> n = std::make_shared<node>();
+  n->value = value;
+  m_node = n;
+}
+
+nd::lazy::expr::expr(const callable &func, const std::vector<expr> &args) {
+  if (func->get_nkwd() != 0) {
+    throw invalid_argument("a lazy expression cannot call a callable with keyword arguments");
+  }
+  if (args.size() != func->get_narg()) {
+    stringstream ss;
+    ss << "a lazy expression passed " << args.size() << " arguments to a callable with type " << func->get_type();
+    throw invalid_argument(ss.str());
+  }
+
+  std::shared_ptr<node> n = std::make_shared<node>();
+  n->func = func;
+  n->args = args;
+  m_node = n;
+}
+
+nd::array nd::lazy::expr::eval() const {
+  if (m_node->func.is_null()) {
+    return m_node->value;
+  }
+
+  program prog;
+  prog.add_srcs(*this);
+  if (prog.srcs.size() > max_nsrc) {
+    std::map<const void *, array> values;
+    return eval_unfused(*this, values);
+  }
+
+  prog.add_steps(*this);
+
+  for (size_t i = 0; i + 1 < prog.steps.size(); ++i) {
+    if (!prog.steps[i].tp.is_builtin()) {
+      std::map<const void *, array> values;
+      return eval_unfused(*this, values);
+    }
+  }
+
+  // A single call needs no fusing
+  if (prog.steps.size() == 1) {
+    return m_node->func.call(prog.srcs.size(), prog.srcs.data(), 0, nullptr);
+  }
+
+  std::vector<ndt::type> src_tp;
+  for (const array &src : prog.srcs) {
+    src_tp.push_back(src.get_dtype());
+  }
+  callable fused = make_callable<functional::fused_callable>(
+      ndt::make_type<ndt::callable_type>(prog.steps.back().tp, src_tp), prog.steps);
+
+  return functional::elwise(fused).call(prog.srcs.size(), prog.srcs.data(), 0, nullptr);
+}
+
+nd::lazy::expr nd::lazy::operator+(const expr &a0) { return expr(plus, {a0}); }
+
+nd::lazy::expr nd::lazy::operator-(const expr &a0) { return expr(minus, {a0}); }
+
+nd::lazy::expr nd::lazy::operator!(const expr &a0) { return expr(logical_not, {a0}); }
+
+nd::lazy::expr nd::lazy::operator+(const expr &a0, const expr &a1) { return expr(add, {a0, a1}); }
+
+nd::lazy::expr nd::lazy::operator-(const expr &a0, const expr &a1) { return expr(subtract, {a0, a1}); }
+
+nd::lazy::expr nd::lazy::operator*(const expr &a0, const expr &a1) { return expr(multiply, {a0, a1}); }
+
+nd::lazy::expr nd::lazy::operator/(const expr &a0, const expr &a1) { return expr(divide, {a0, a1}); }
+
+nd::lazy::expr nd::lazy::operator%(const expr &a0, const expr &a1) { return expr(mod, {a0, a1}); }
+
+nd::lazy::expr nd::lazy::operator&&(const expr &a0, const expr &a1) { return expr(logical_and, {a0, a1}); }
+
+nd::lazy::expr nd::lazy::operator||(const expr &a0, const expr &a1) { return expr(logical_or, {a0, a1}); }
+
+nd::lazy::expr nd::lazy::operator<(const expr &a0, const expr &a1) { return expr(less, {a0, a1}); }
+
+nd::lazy::expr nd::lazy::operator<=(const expr &a0, const expr &a1) { return expr(less_equal, {a0, a1}); }
+
+nd::lazy::expr nd::lazy::operator==(const expr &a0, const expr &a1) { return expr(equal, {a0, a1}); }
+
+nd::lazy::expr nd::lazy::operator!=(const expr &a0, const expr &a1) { return expr(not_equal, {a0, a1}); }
+
+nd::lazy::expr nd::lazy::operator>=(const expr &a0, const expr &a1) { return expr(greater_equal, {a0, a1}); }
+
+nd::lazy::expr nd::lazy::operator>(const expr &a0, const expr &a1) { return expr(greater, {a0, a1}); }
+
+nd::lazy::expr nd::lazy::sqrt(const expr &a0) { return expr(nd::sqrt, {a0}); }
+
+nd::lazy::expr nd::lazy::cbrt(const expr &a0) { return expr(nd::cbrt, {a0}); }
+
+nd::lazy::expr nd::lazy::exp(const expr &a0) { return expr(nd::exp, {a0}); }
+
+nd::lazy::expr nd::lazy::sin(const expr &a0) { return expr(nd::sin, {a0}); }
+
+nd::lazy::expr nd::lazy::cos(const expr &a0) { return expr(nd::cos, {a0}); }
+
+nd::lazy::expr nd::lazy::tan(const expr &a0) { return expr(nd::tan, {a0}); }
+
+nd::lazy::expr nd::lazy::pow(const expr &a0, const expr &a1) { return expr(nd::pow, {a0, a1}); }
@@ -0,0 +1,202 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <dynd/ragged.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/types/var_dim_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+const ndt::type &get_ragged_element_type(const nd::array &a) {
+  const ndt::type &tp = a.get_type();
+  if (tp.get_id() != fixed_dim_id || tp.extended<ndt::base_dim_type>()->get_element_type().get_id() != var_dim_id) {
+    stringstream ss;
+    ss << "Expected a ragged array of type N * var * T, not " << tp;
+    throw invalid_argument(ss.str());
+  }
+
+  const ndt::type &el_tp = tp.extended<ndt::base_dim_type>()->get_element_type().extended<ndt::base_dim_type>()
+                               ->get_element_type();
+  if (el_tp.get_arrmeta_size() > 0) {
+    stringstream ss;
+    ss << "The elements of a ragged array must not have arrmeta, not " << el_tp;
+    throw invalid_argument(ss.str());
+  }
+
+  return el_tp;
+}
+
+/**
+ * Calls ``f(i, begin, size)`` for each row of the ragged array ``a``.
+ */
+template <typename F>
+void for_each_row(const nd::array &a, F &&f) {
+  const fixed_dim_type_arrmeta *md = reinterpret_cast<const fixed_dim_type_arrmeta *>(a.get()->metadata());
+  const ndt::var_dim_type::metadata_type *var_md =
+      reinterpret_cast<const ndt::var_dim_type::metadata_type *>(a.get()->metadata() + sizeof(fixed_dim_type_arrmeta));
+
+  const char *data = a.cdata();
+  for (intptr_t i = 0; i < md->dim_size; ++i, data += md->stride) {
+    const ndt::var_dim_type::data_type *row = reinterpret_cast<const ndt::var_dim_type::data_type *>(data);
+    f(i, row->begin + var_md->offset, row->size);
+  }
+}
+
+/**
+ * Returns the start of the values of the ragged array ``a`` if its rows are
+ * packed, otherwise NULL. The begin pointers of empty rows do not matter.
+ */
+const char *get_packed_begin(const nd::array &a) {
+  intptr_t stride =
+      reinterpret_cast<const ndt::var_dim_type::metadata_type *>(a.get()->metadata() + sizeof(fixed_dim_type_arrmeta))
+          ->stride;
+
+  const char *begin = NULL, *end = NULL;
+  bool packed = true;
+  for_each_row(a, [&](intptr_t, const char *row_begin, size_t row_size) {
+    if (row_size == 0) {
+      return;
+    }
+    if (begin == NULL) {
+      begin = row_begin;
+    } else if (row_begin != end) {
+      packed = false;
+    }
+    end = row_begin + row_size * stride;
+  });
+
+  if (!packed) {
+    return NULL;
+  }
+
+  // With no values, any pointer will do
+  return begin == NULL ? a.cdata() : begin;
+}
+
+} // anonymous namespace
+
+nd::array nd::make_ragged(const array &offsets, const array &values) {
+  if (offsets.get_ndim() != 1 || offsets.get_dim_size() < 1) {
+    stringstream ss;
+    ss << "The offsets of a ragged array must be a nonempty one-dimensional array, not " << offsets.get_type();
+    throw invalid_argument(ss.str());
+  }
+  if (values.get_type().get_id() != fixed_dim_id || values.get_ndim() != 1) {
+    stringstream ss;
+    ss << "The values of a ragged array must be a one-dimensional array, not " << values.get_type();
+    throw invalid_argument(ss.str());
+  }
+
+  const ndt::type &el_tp = values.get_type().extended<ndt::base_dim_type>()->get_element_type();
+  if (el_tp.get_arrmeta_size() > 0) {
+    stringstream ss;
+    ss << "The elements of a ragged array must not have arrmeta, not " << el_tp;
+    throw invalid_argument(ss.str());
+  }
+
+  intptr_t size = offsets.get_dim_size() - 1;
+  array offsets64 = empty(ndt::make_fixed_dim(size + 1, ndt::make_type<int64_t>()));
+  offsets64.assign(offsets);
+  const int64_t *offsets_data = reinterpret_cast<const int64_t *>(offsets64.cdata());
+
+  const fixed_dim_type_arrmeta *values_md = reinterpret_cast<const fixed_dim_type_arrmeta *>(values.get()->metadata());
+  if (offsets_data[0] < 0 || offsets_data[size] > values_md->dim_size) {
+    stringstream ss;
+    ss << "The offsets of a ragged array must be within the " << values_md->dim_size << " values";
+    throw invalid_argument(ss.str());
+  }
+  for (intptr_t i = 0; i < size; ++i) {
+    if (offsets_data[i] > offsets_data[i + 1]) {
+      throw invalid_argument("The offsets of a ragged array must be nondecreasing");
+    }
+  }
+
+  // The rows are a view of the values, so they can only be written where
+  // the values can
+  array result = empty(ndt::make_fixed_dim(size, ndt::make_var_dim(el_tp)), values.get_flags());
+
+  // The rows point into the values, which the var dimension holds on to
+  ndt::var_dim_type::metadata_type *var_md =
+      reinterpret_cast<ndt::var_dim_type::metadata_type *>(result.get()->metadata() + sizeof(fixed_dim_type_arrmeta));
+  var_md->blockref = values.get_owner() ? values.get_data_memblock() : values;
+  var_md->stride = values_md->stride;
+  var_md->offset = 0;
+
+  char *values_data = const_cast<char *>(values.cdata());
+  ndt::var_dim_type::data_type *rows =
+      reinterpret_cast<ndt::var_dim_type::data_type *>(const_cast<char *>(result.cdata()));
+  for (intptr_t i = 0; i < size; ++i) {
+    rows[i].begin = values_data + offsets_data[i] * values_md->stride;
+    rows[i].size = static_cast<size_t>(offsets_data[i + 1] - offsets_data[i]);
+  }
+
+  return result;
+}
+
+bool nd::is_packed_ragged(const array &a) {
+  get_ragged_element_type(a);
+
+  return get_packed_begin(a) != NULL;
+}
+
+nd::array nd::pack_ragged(const array &a) {
+  get_ragged_element_type(a);
+  if (get_packed_begin(a) != NULL) {
+    return a;
+  }
+
+  // Assigning to new var rows allocates them together, packed
+  array result = empty(a.get_type());
+  result.assign(a);
+
+  return result;
+}
+
+nd::array nd::ragged_offsets(const array &a) {
+  get_ragged_element_type(a);
+  if (get_packed_begin(a) == NULL) {
+    throw invalid_argument("Cannot get the offsets of a ragged array whose rows are not packed");
+  }
+
+  // The rows of a packed array follow each other from the start of the values
+  intptr_t size = a.get_dim_size();
+  array result = empty(ndt::make_fixed_dim(size + 1, ndt::make_type<int64_t>()));
+  int64_t *offsets = reinterpret_cast<int64_t *>(result.data());
+  offsets[0] = 0;
+  for_each_row(a, [&](intptr_t i, const char *, size_t row_size) {
+    offsets[i + 1] = offsets[i] + static_cast<int64_t>(row_size);
+  });
+
+  return result;
+}
+
+nd::array nd::ragged_values(const array &a) {
+  const ndt::type &el_tp = get_ragged_element_type(a);
+  const char *begin = get_packed_begin(a);
+  if (begin == NULL) {
+    throw invalid_argument("Cannot get the values of a ragged array whose rows are not packed");
+  }
+
+  const ndt::var_dim_type::metadata_type *var_md =
+      reinterpret_cast<const ndt::var_dim_type::metadata_type *>(a.get()->metadata() + sizeof(fixed_dim_type_arrmeta));
+
+  size_t total_size = 0;
+  for_each_row(a, [&](intptr_t, const char *, size_t row_size) { total_size += row_size; });
+
+  memory_block owner = var_md->blockref;
+  if (!owner) {
+    owner = a.get_owner() ? a.get_data_memblock() : a;
+  }
+
+  array result = make_array(ndt::make_fixed_dim(total_size, el_tp), const_cast<char *>(begin), owner, a.get_flags());
+  fixed_dim_type_arrmeta *md = reinterpret_cast<fixed_dim_type_arrmeta *>(result.get()->metadata());
+  md->dim_size = total_size;
+  md->stride = var_md->stride;
+
+  return result;
+}
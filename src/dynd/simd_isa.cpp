@@ -0,0 +1,44 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <dynd/simd_isa.hpp>
+
+using namespace std;
+using namespace dynd;
+
+detail::simd_isa_t detail::get_cpu_simd_isa() {
+#ifdef DYND_SIMD_X86
+  static const simd_isa_t isa = [] {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+      return simd_isa_avx512f;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+      return simd_isa_avx2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+      return simd_isa_sse2;
+    }
+    return simd_isa_none;
+  }();
+
+  return isa;
+#else
+  return simd_isa_none;
+#endif
+}
+
+const char *detail::get_simd_isa_name(simd_isa_t isa) {
+  switch (isa) {
+  case simd_isa_avx512f:
+    return "avx512f";
+  case simd_isa_avx2:
+    return "avx2";
+  case simd_isa_sse2:
+    return "sse2";
+  default:
+    return "none";
+  }
+}
@@ -3,7 +3,11 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <dynd/callables/argsort_callable.hpp>
+#include <dynd/callables/partition_callable.hpp>
 #include <dynd/callables/sort_callable.hpp>
+#include <dynd/callables/stable_sort_callable.hpp>
+#include <dynd/callables/topk_callable.hpp>
 #include <dynd/callables/unique_callable.hpp>
 #include <dynd/sort.hpp>
 
@@ -12,4 +16,14 @@ using namespace dynd;
 
 DYND_API nd::callable nd::sort = nd::make_callable<nd::sort_callable>();
 
-DYND_API nd::callable nd::unique = nd::make_callable<nd::unique_callable>();
+DYND_API nd::callable nd::stable_sort = nd::make_callable<nd::stable_sort_callable>();
+
+DYND_API nd::callable nd::argsort = nd::make_callable<nd::argsort_callable>();
+
+DYND_API nd::callable nd::partition = nd::make_callable<nd::partition_callable>();
+
+DYND_API nd::callable nd::topk = nd::make_callable<nd::topk_callable>();
+
+DYND_API nd::callable nd::unique = nd::make_callable<nd::unique_callable<false>>();
+
+DYND_API nd::callable nd::value_counts = nd::make_callable<nd::unique_callable<true>>();
@@ -0,0 +1,89 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cstdlib>
+
+#include <dynd/storagebuf.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+// Blocks are a power of two from 256 bytes to 64 KB, larger ones are not cached
+const size_t min_block_shift = 8;
+const size_t nblock_size = 9;
+const size_t max_cached_blocks = 16;
+
+// Trivially destructible, so that it can still be used while other
+// thread_local objects are destroyed at thread exit
+struct storage_cache {
+  void *blocks[nblock_size][max_cached_blocks];
+  size_t nblocks[nblock_size];
+  storage_stats stats;
+  // Buffers that outlive the cached blocks, like those of thread_local
+  // objects destroyed later, bypass the cache once it is closed
+  bool closed;
+};
+
+thread_local storage_cache cache;
+
+// Frees the cached blocks when the thread exits. It is set up by the first
+// block put into the cache.
+struct storage_cache_owner {
+  bool registered;
+
+  storage_cache_owner() : registered(true) {}
+
+  ~storage_cache_owner() {
+    for (size_t i = 0; i < nblock_size; ++i) {
+      for (size_t j = 0; j < cache.nblocks[i]; ++j) {
+        std::free(cache.blocks[i][j]);
+      }
+      cache.nblocks[i] = 0;
+    }
+    cache.closed = true;
+  }
+};
+
+thread_local storage_cache_owner owner;
+
+size_t get_block_index(size_t size) {
+  size_t i = 0;
+  while (i < nblock_size && (static_cast<size_t>(1) << (min_block_shift + i)) < size) {
+    ++i;
+  }
+
+  return i;
+}
+
+} // anonymous namespace
+
+storage_stats dynd::get_storage_stats() { return cache.stats; }
+
+void *dynd::detail::storage_alloc(size_t &size) {
+  ++cache.stats.allocs;
+
+  size_t i = get_block_index(size);
+  if (i < nblock_size) {
+    size = static_cast<size_t>(1) << (min_block_shift + i);
+    if (cache.nblocks[i] != 0) {
+      return cache.blocks[i][--cache.nblocks[i]];
+    }
+  }
+
+  ++cache.stats.heap_allocs;
+  return std::malloc(size);
+}
+
+void dynd::detail::storage_free(void *ptr, size_t size) {
+  size_t i = get_block_index(size);
+  if (!cache.closed && i < nblock_size && cache.nblocks[i] < max_cached_blocks && owner.registered) {
+    cache.blocks[i][cache.nblocks[i]++] = ptr;
+    return;
+  }
+
+  std::free(ptr);
+}
@@ -3,8 +3,11 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <algorithm>
+#include <cstring>
 #include <sstream>
 
+#include <dynd/simd_isa.hpp>
 #include <dynd/string_encodings.hpp>
 #include <dynd/type.hpp>
 #include <dynd/types/char_type.hpp>
@@ -125,6 +128,7 @@ uint32_t next_utf8(const char *&it, const char *end) {
 }
 
 uint32_t noerror_next_utf8(const char *&it, const char *end) {
+  const char *saved_it = it;
   uint32_t cp = 0;
   // Determine the sequence length based on the lead octet
   std::size_t length = utf8::internal::sequence_length(it);
@@ -133,7 +137,8 @@ uint32_t noerror_next_utf8(const char *&it, const char *end) {
   utf8::internal::utf_error err = utf8::internal::UTF8_OK;
   switch (length) {
   case 0:
-    return ERROR_SUBSTITUTE_CODEPOINT;
+    err = utf8::internal::INVALID_LEAD;
+    break;
   case 1:
     err = utf8::internal::get_sequence_1(it, end, cp);
     break;
@@ -155,17 +160,13 @@ uint32_t noerror_next_utf8(const char *&it, const char *end) {
         // Passed! Return here.
         ++it;
         return cp;
-      } else {
-        return ERROR_SUBSTITUTE_CODEPOINT;
       }
-    } else {
-      return ERROR_SUBSTITUTE_CODEPOINT;
     }
-  } else {
-    return ERROR_SUBSTITUTE_CODEPOINT;
   }
 
-  return cp;
+  // Skip one byte of the invalid sequence, so that decoding makes progress
+  it = saved_it + 1;
+  return ERROR_SUBSTITUTE_CODEPOINT;
 }
 
 void append_utf8(uint32_t cp, char *&it, char *end) {
@@ -323,6 +324,296 @@ void noerror_append_utf32(uint32_t cp, char *&it_raw, char *DYND_UNUSED(end_raw)
   *it = cp;
   ++it;
 }
+
+// The code units of ASCII characters, which have the same value in every
+// encoding, are in [0x01, 0x7f], or [0x00, 0x7f] when a null does not end the
+// string.
+template <class UnitType>
+size_t ascii_run_scalar(const char *src, size_t count, bool stop_at_null) {
+  const UnitType *s = reinterpret_cast<const UnitType *>(src);
+  UnitType lo = stop_at_null ? 1 : 0;
+  size_t i = 0;
+  while (i < count && static_cast<UnitType>(s[i] - lo) < static_cast<UnitType>(0x80 - lo)) {
+    ++i;
+  }
+  return i;
+}
+
+#ifdef DYND_SIMD_X86
+
+// Returns the number of leading code units of ``BITS`` bits that are ASCII,
+// by comparing a vector of them at a time
+#define DYND_DEF_ASCII_RUN(ISA, TARGET, WIDTH, MOVEMASK, BITS)                                                         \
+  __attribute__((target(TARGET))) size_t ascii_run##BITS##_##ISA(const char *src, size_t count, bool stop_at_null) {   \
+    typedef uint##BITS##_t vector_type __attribute__((vector_size(WIDTH)));                                            \
+    typedef char byte_vector_type __attribute__((vector_size(WIDTH)));                                                 \
+    const size_t n = WIDTH / sizeof(uint##BITS##_t);                                                                   \
+    const uint##BITS##_t lo = stop_at_null ? 1 : 0;                                                                    \
+    const uint32_t all = WIDTH == 32 ? 0xffffffffu : 0xffffu;                                                          \
+    size_t i = 0;                                                                                                      \
+    for (; count - i >= n; i += n) {                                                                                   \
+      vector_type v;                                                                                                   \
+      memcpy(&v, src + i * sizeof(uint##BITS##_t), WIDTH);                                                             \
+      byte_vector_type ascii = (byte_vector_type)((v - lo) < static_cast<uint##BITS##_t>(0x80 - lo));                  \
+      uint32_t mask = static_cast<uint32_t>(MOVEMASK(ascii)) ^ all;                                                    \
+      if (mask != 0) {                                                                                                 \
+        return i + __builtin_ctz(mask) / sizeof(uint##BITS##_t);                                                       \
+      }                                                                                                                \
+    }                                                                                                                  \
+    return i + ascii_run_scalar<uint##BITS##_t>(src + i * sizeof(uint##BITS##_t), count - i, stop_at_null);            \
+  }
+
+DYND_DEF_ASCII_RUN(sse2, "sse2", 16, __builtin_ia32_pmovmskb128, 8)
+DYND_DEF_ASCII_RUN(sse2, "sse2", 16, __builtin_ia32_pmovmskb128, 16)
+DYND_DEF_ASCII_RUN(sse2, "sse2", 16, __builtin_ia32_pmovmskb128, 32)
+DYND_DEF_ASCII_RUN(avx2, "avx2", 32, __builtin_ia32_pmovmskb256, 8)
+DYND_DEF_ASCII_RUN(avx2, "avx2", 32, __builtin_ia32_pmovmskb256, 16)
+DYND_DEF_ASCII_RUN(avx2, "avx2", 32, __builtin_ia32_pmovmskb256, 32)
+
+#undef DYND_DEF_ASCII_RUN
+
+typedef size_t (*ascii_run_t)(const char *, size_t, bool);
+
+ascii_run_t get_ascii_run(intptr_t unit_size) {
+  static const ascii_run_t table[3][3] = {
+      {&ascii_run_scalar<uint8_t>, &ascii_run_scalar<uint16_t>, &ascii_run_scalar<uint32_t>},
+      {&ascii_run8_sse2, &ascii_run16_sse2, &ascii_run32_sse2},
+      {&ascii_run8_avx2, &ascii_run16_avx2, &ascii_run32_avx2}};
+
+  return table[detail::get_cpu_simd_isa(detail::simd_isa_avx2)][unit_size == 1 ? 0 : (unit_size == 2 ? 1 : 2)];
+}
+
+#else
+
+typedef size_t (*ascii_run_t)(const char *, size_t, bool);
+
+ascii_run_t get_ascii_run(intptr_t unit_size) {
+  static const ascii_run_t table[3] = {&ascii_run_scalar<uint8_t>, &ascii_run_scalar<uint16_t>,
+                                       &ascii_run_scalar<uint32_t>};
+
+  return table[unit_size == 1 ? 0 : (unit_size == 2 ? 1 : 2)];
+}
+
+#endif
+
+// Copies ASCII code units, widening or narrowing them to the destination
+// size. These are simple loops, which the compiler vectorizes.
+template <class DstUnitType, class SrcUnitType>
+void copy_units(char *dst, const char *src, size_t count) {
+  DstUnitType *d = reinterpret_cast<DstUnitType *>(dst);
+  const SrcUnitType *s = reinterpret_cast<const SrcUnitType *>(src);
+  for (size_t i = 0; i < count; ++i) {
+    d[i] = static_cast<DstUnitType>(s[i]);
+  }
+}
+
+template <class UnitType>
+void copy_same_units(char *dst, const char *src, size_t count) {
+  memcpy(dst, src, count * sizeof(UnitType));
+}
+
+typedef void (*copy_units_t)(char *, const char *, size_t);
+
+copy_units_t get_copy_units(intptr_t dst_unit_size, intptr_t src_unit_size) {
+  static const copy_units_t table[3][3] = {
+      {&copy_same_units<uint8_t>, &copy_units<uint8_t, uint16_t>, &copy_units<uint8_t, uint32_t>},
+      {&copy_units<uint16_t, uint8_t>, &copy_same_units<uint16_t>, &copy_units<uint16_t, uint32_t>},
+      {&copy_units<uint32_t, uint8_t>, &copy_units<uint32_t, uint16_t>, &copy_same_units<uint32_t>}};
+
+  return table[dst_unit_size == 1 ? 0 : (dst_unit_size == 2 ? 1 : 2)]
+              [src_unit_size == 1 ? 0 : (src_unit_size == 2 ? 1 : 2)];
+}
+
+// The number of bytes ``cp`` takes in the encoding
+intptr_t encoded_size(string_encoding_t encoding, uint32_t cp) {
+  switch (encoding) {
+  case string_encoding_utf_8:
+    return cp < 0x80 ? 1 : (cp < 0x800 ? 2 : (cp < 0x10000 ? 3 : 4));
+  case string_encoding_utf_16:
+    return cp > 0xffff ? 4 : 2;
+  default:
+    return string_encoding_char_size_table[encoding];
+  }
+}
+
+// The size of the valid UTF-8 sequence at ``s``, or 0 if it is invalid or cut
+// off by ``end``. The ranges of the second byte follow table 3-7 of the
+// Unicode standard, which rules out overlong sequences, surrogates and code
+// points past U+10FFFF.
+inline intptr_t utf8_sequence_size(const uint8_t *s, const uint8_t *end) {
+  uint8_t lead = s[0];
+  if (lead < 0x80) {
+    return 1;
+  }
+  if (lead < 0xc2) {
+    return 0;
+  }
+  if (lead < 0xe0) {
+    return (end - s >= 2 && (s[1] & 0xc0) == 0x80) ? 2 : 0;
+  }
+  if (lead < 0xf0) {
+    if (end - s < 3 || (s[2] & 0xc0) != 0x80) {
+      return 0;
+    }
+    uint8_t lo = (lead == 0xe0) ? 0xa0 : 0x80, hi = (lead == 0xed) ? 0x9f : 0xbf;
+    return (s[1] >= lo && s[1] <= hi) ? 3 : 0;
+  }
+  if (lead < 0xf5) {
+    if (end - s < 4 || (s[2] & 0xc0) != 0x80 || (s[3] & 0xc0) != 0x80) {
+      return 0;
+    }
+    uint8_t lo = (lead == 0xf0) ? 0x90 : 0x80, hi = (lead == 0xf4) ? 0x8f : 0xbf;
+    return (s[1] >= lo && s[1] <= hi) ? 4 : 0;
+  }
+  return 0;
+}
+
+// Decodes a multi-byte sequence that utf8_sequence_size accepted
+inline uint32_t decode_utf8(const uint8_t *s, intptr_t size) {
+  switch (size) {
+  case 2:
+    return (static_cast<uint32_t>(s[0] & 0x1f) << 6) | (s[1] & 0x3f);
+  case 3:
+    return (static_cast<uint32_t>(s[0] & 0x0f) << 12) | (static_cast<uint32_t>(s[1] & 0x3f) << 6) | (s[2] & 0x3f);
+  default:
+    return (static_cast<uint32_t>(s[0] & 0x07) << 18) | (static_cast<uint32_t>(s[1] & 0x3f) << 12) |
+           (static_cast<uint32_t>(s[2] & 0x3f) << 6) | (s[3] & 0x3f);
+  }
+}
+
+// The multibyte_* functions convert a run of non-ASCII characters directly,
+// without going through the next and append functions. They stop before an
+// ASCII character, an invalid sequence or a character that does not fit,
+// leaving those to the transcoder's general path, so valid text converts the
+// same way in every error mode.
+
+template <class DstUnitType>
+void multibyte_from_utf8(char *&dst_raw, char *dst_end_raw, const char *&src_raw, const char *src_end_raw) {
+  DstUnitType *dst = reinterpret_cast<DstUnitType *>(dst_raw);
+  DstUnitType *dst_end = dst + (dst_end_raw - dst_raw) / sizeof(DstUnitType);
+  const uint8_t *src = reinterpret_cast<const uint8_t *>(src_raw);
+  const uint8_t *src_end = reinterpret_cast<const uint8_t *>(src_end_raw);
+
+  while (src < src_end && *src >= 0x80) {
+    intptr_t size = utf8_sequence_size(src, src_end);
+    if (size == 0) {
+      break;
+    }
+    uint32_t cp = decode_utf8(src, size);
+    if (sizeof(DstUnitType) == 2 && cp > 0xffff) {
+      if (dst_end - dst < 2) {
+        break;
+      }
+      dst[0] = static_cast<DstUnitType>((cp >> 10) + utf8::internal::LEAD_OFFSET);
+      dst[1] = static_cast<DstUnitType>((cp & 0x3ff) + utf8::internal::TRAIL_SURROGATE_MIN);
+      dst += 2;
+    } else {
+      if (dst == dst_end) {
+        break;
+      }
+      *dst++ = static_cast<DstUnitType>(cp);
+    }
+    src += size;
+  }
+
+  dst_raw = reinterpret_cast<char *>(dst);
+  src_raw = reinterpret_cast<const char *>(src);
+}
+
+template <class SrcUnitType>
+void multibyte_to_utf8(char *&dst_raw, char *dst_end_raw, const char *&src_raw, const char *src_end_raw) {
+  uint8_t *dst = reinterpret_cast<uint8_t *>(dst_raw);
+  uint8_t *dst_end = reinterpret_cast<uint8_t *>(dst_end_raw);
+  const SrcUnitType *src = reinterpret_cast<const SrcUnitType *>(src_raw);
+  const SrcUnitType *src_end = src + (src_end_raw - src_raw) / sizeof(SrcUnitType);
+
+  while (src < src_end && *src >= 0x80) {
+    uint32_t cp = *src;
+    intptr_t units = 1;
+    if (sizeof(SrcUnitType) == 2 && utf8::internal::is_surrogate(cp)) {
+      if (!utf8::internal::is_lead_surrogate(cp) || src_end - src < 2 ||
+          !utf8::internal::is_trail_surrogate(src[1])) {
+        break;
+      }
+      cp = (cp << 10) + src[1] + utf8::internal::SURROGATE_OFFSET;
+      units = 2;
+    } else if (sizeof(SrcUnitType) == 4 && !utf8::internal::is_code_point_valid(cp)) {
+      break;
+    }
+
+    intptr_t size = cp < 0x800 ? 2 : (cp < 0x10000 ? 3 : 4);
+    if (dst_end - dst < size) {
+      break;
+    }
+    switch (size) {
+    case 2:
+      dst[0] = static_cast<uint8_t>(0xc0 | (cp >> 6));
+      break;
+    case 3:
+      dst[0] = static_cast<uint8_t>(0xe0 | (cp >> 12));
+      dst[1] = static_cast<uint8_t>(0x80 | ((cp >> 6) & 0x3f));
+      break;
+    default:
+      dst[0] = static_cast<uint8_t>(0xf0 | (cp >> 18));
+      dst[1] = static_cast<uint8_t>(0x80 | ((cp >> 12) & 0x3f));
+      dst[2] = static_cast<uint8_t>(0x80 | ((cp >> 6) & 0x3f));
+      break;
+    }
+    dst[size - 1] = static_cast<uint8_t>(0x80 | (cp & 0x3f));
+    dst += size;
+    src += units;
+  }
+
+  dst_raw = reinterpret_cast<char *>(dst);
+  src_raw = reinterpret_cast<const char *>(src);
+}
+
+void multibyte_utf8(char *&dst, char *dst_end, const char *&src_raw, const char *src_end_raw) {
+  const uint8_t *src = reinterpret_cast<const uint8_t *>(src_raw);
+  const uint8_t *src_end = src + min(src_end_raw - src_raw, dst_end - dst);
+
+  // Find the valid sequences that fit, then copy them at once
+  const uint8_t *it = src;
+  while (it < src_end && *it >= 0x80) {
+    intptr_t size = utf8_sequence_size(it, src_end);
+    if (size == 0) {
+      break;
+    }
+    it += size;
+  }
+
+  memcpy(dst, src, it - src);
+  dst += it - src;
+  src_raw = reinterpret_cast<const char *>(it);
+}
+
+typedef void (*multibyte_t)(char *&, char *, const char *&, const char *);
+
+multibyte_t get_multibyte(string_encoding_t dst_encoding, string_encoding_t src_encoding) {
+  if (src_encoding == string_encoding_utf_8) {
+    switch (dst_encoding) {
+    case string_encoding_utf_8:
+      return &multibyte_utf8;
+    case string_encoding_utf_16:
+      return &multibyte_from_utf8<uint16_t>;
+    case string_encoding_utf_32:
+      return &multibyte_from_utf8<uint32_t>;
+    default:
+      break;
+    }
+  } else if (dst_encoding == string_encoding_utf_8) {
+    switch (src_encoding) {
+    case string_encoding_utf_16:
+      return &multibyte_to_utf8<uint16_t>;
+    case string_encoding_utf_32:
+      return &multibyte_to_utf8<uint32_t>;
+    default:
+      break;
+    }
+  }
+
+  return NULL;
+}
 } // anonymous namespace
 
 next_unicode_codepoint_t dynd::get_next_unicode_codepoint_function(string_encoding_t encoding,
@@ -361,6 +652,75 @@ append_unicode_codepoint_t dynd::get_append_unicode_codepoint_function(string_en
   }
 }
 
+const char *dynd::validate_utf8(const char *begin, const char *end) {
+  static const ascii_run_t ascii_run = get_ascii_run(1);
+
+  while (begin < end) {
+    begin += ascii_run(begin, end - begin, false);
+    if (begin == end) {
+      break;
+    }
+
+    const uint8_t *it = reinterpret_cast<const uint8_t *>(begin);
+    const uint8_t *it_end = reinterpret_cast<const uint8_t *>(end);
+    while (it < it_end && *it >= 0x80) {
+      intptr_t size = utf8_sequence_size(it, it_end);
+      if (size == 0) {
+        return reinterpret_cast<const char *>(it);
+      }
+      it += size;
+    }
+    begin = reinterpret_cast<const char *>(it);
+  }
+
+  return end;
+}
+
+string_transcoder::string_transcoder(string_encoding_t dst_encoding, string_encoding_t src_encoding,
+                                     assign_error_mode errmode)
+    : m_dst_encoding(dst_encoding), m_dst_unit_size(string_encoding_char_size_table[dst_encoding]),
+      m_src_unit_size(string_encoding_char_size_table[src_encoding]),
+      m_next_fn(get_next_unicode_codepoint_function(src_encoding, errmode)),
+      m_append_fn(get_append_unicode_codepoint_function(dst_encoding, errmode)),
+      m_ascii_run(get_ascii_run(m_src_unit_size)), m_copy_units(get_copy_units(m_dst_unit_size, m_src_unit_size)),
+      m_multibyte(get_multibyte(dst_encoding, src_encoding)) {}
+
+bool string_transcoder::operator()(char *&dst, char *dst_end, const char *&src, const char *src_end,
+                                   bool stop_at_null) const {
+  while (src < src_end && dst < dst_end) {
+    size_t count = min((src_end - src) / m_src_unit_size, (dst_end - dst) / m_dst_unit_size);
+    size_t n = m_ascii_run(src, count, stop_at_null);
+    m_copy_units(dst, src, n);
+    src += n * m_src_unit_size;
+    dst += n * m_dst_unit_size;
+    if (src >= src_end || dst >= dst_end) {
+      break;
+    }
+
+    if (m_multibyte != NULL) {
+      const char *run_src = src;
+      m_multibyte(dst, dst_end, src, src_end);
+      if (src != run_src) {
+        continue;
+      }
+    }
+
+    const char *saved_src = src;
+    uint32_t cp = m_next_fn(src, src_end);
+    if (cp == 0 && stop_at_null) {
+      src = saved_src;
+      return true;
+    }
+    if (encoded_size(m_dst_encoding, cp) > dst_end - dst) {
+      src = saved_src;
+      break;
+    }
+    m_append_fn(cp, dst, dst_end);
+  }
+
+  return false;
+}
+
 template <next_unicode_codepoint_t next_fn>
 std::string string_range_as_utf8_string_templ(const char *begin, const char *end) {
   std::string result;
@@ -0,0 +1,84 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cstring>
+
+#include <dynd/simd_isa.hpp>
+#include <dynd/string_search.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+const char *find_first_last_scalar(const char *p, const char *end, char first, char last, size_t offset) {
+  while (p < end) {
+    p = reinterpret_cast<const char *>(memchr(p, first, end - p));
+    if (p == NULL) {
+      return NULL;
+    }
+    if (p[offset] == last) {
+      return p;
+    }
+    ++p;
+  }
+
+  return NULL;
+}
+
+#ifdef DYND_SIMD_X86
+
+// Bit ``i`` of the mask is set when the candidate starting at ``p + i`` has
+// both the first and the last byte of the needle
+#define DYND_DEF_FIND_FIRST_LAST(ISA, TARGET, WIDTH, MOVEMASK)                                                        \
+  __attribute__((target(TARGET))) const char *find_first_last_##ISA(const char *p, const char *end, char first,       \
+                                                                     char last, size_t offset) {                       \
+    typedef char vector_type __attribute__((vector_size(WIDTH)));                                                      \
+    for (; end - p >= WIDTH; p += WIDTH) {                                                                             \
+      vector_type u, v;                                                                                                \
+      memcpy(&u, p, WIDTH);                                                                                            \
+      memcpy(&v, p + offset, WIDTH);                                                                                   \
+      vector_type candidates = (vector_type)((u == first) & (v == last));                                              \
+      uint32_t mask = static_cast<uint32_t>(MOVEMASK(candidates));                                                     \
+      if (mask != 0) {                                                                                                 \
+        return p + __builtin_ctz(mask);                                                                                \
+      }                                                                                                                \
+    }                                                                                                                  \
+    return find_first_last_scalar(p, end, first, last, offset);                                                        \
+  }
+
+DYND_DEF_FIND_FIRST_LAST(sse2, "sse2", 16, __builtin_ia32_pmovmskb128)
+DYND_DEF_FIND_FIRST_LAST(avx2, "avx2", 32, __builtin_ia32_pmovmskb256)
+
+#undef DYND_DEF_FIND_FIRST_LAST
+
+typedef const char *(*find_first_last_t)(const char *, const char *, char, char, size_t);
+
+find_first_last_t get_find_first_last() {
+  switch (detail::get_cpu_simd_isa(detail::simd_isa_avx2)) {
+  case detail::simd_isa_avx2:
+    return &find_first_last_avx2;
+  case detail::simd_isa_sse2:
+    return &find_first_last_sse2;
+  default:
+    return &find_first_last_scalar;
+  }
+}
+
+#else
+
+typedef const char *(*find_first_last_t)(const char *, const char *, char, char, size_t);
+
+find_first_last_t get_find_first_last() { return &find_first_last_scalar; }
+
+#endif
+
+} // anonymous namespace
+
+const char *detail::find_first_last(const char *begin, const char *end, char first, char last, size_t offset) {
+  static const find_first_last_t f = get_find_first_last();
+
+  return f(begin, end, first, last, offset);
+}
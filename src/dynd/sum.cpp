@@ -8,6 +8,7 @@
 #include <dynd/callables/multidispatch_callable.hpp>
 #include <dynd/callables/sum_callable.hpp>
 #include <dynd/functional.hpp>
+#include <dynd/types/any_kind_type.hpp>
 #include <dynd/types/scalar_kind_type.hpp>
 
 using namespace dynd;
@@ -19,10 +20,20 @@ static std::vector<ndt::type> func_ptr(const ndt::type &DYND_UNUSED(dst_tp), siz
   return {src_tp[0].get_dtype()};
 }
 
+static std::vector<ndt::type> func_ptr_dst(const ndt::type &dst_tp, size_t DYND_UNUSED(nsrc),
+                                           const ndt::type *DYND_UNUSED(src_tp)) {
+  return {dst_tp};
+}
+
 } // unnamed namespace
 
 DYND_API nd::callable nd::sum = nd::functional::reduction(
-    [] { return 0; },
+    nd::make_callable<nd::multidispatch_callable<1>>(
+        ndt::make_type<ndt::callable_type>(ndt::make_type<ndt::any_kind_type>(), {}),
+        nd::callable::make_all<nd::sum_identity_callable,
+                               type_sequence<int8_t, int16_t, int32_t, int64_t, uint8_t, uint16_t, uint32_t, uint64_t,
+                                             float16, float, double, dynd::complex<float>, dynd::complex<double>>>(
+            func_ptr_dst)),
     nd::make_callable<nd::multidispatch_callable<1>>(
         ndt::make_type<ndt::callable_type>(ndt::make_type<ndt::scalar_kind_type>(),
                                            {ndt::make_type<ndt::scalar_kind_type>()}),
@@ -0,0 +1,204 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+
+#include <dynd/thread_pool.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+thread_local bool parallel_region = false;
+
+size_t hardware_nthreads(size_t nthreads) {
+  if (nthreads == 0) {
+    nthreads = std::thread::hardware_concurrency();
+  }
+
+  return std::max<size_t>(nthreads, 1);
+}
+
+} // anonymous namespace
+
+thread_pool::thread_pool(size_t nthreads)
+    : m_runs(new run_type[hardware_nthreads(nthreads)]), m_generation(0), m_running(0), m_stop(false),
+      m_task(nullptr), m_size(0), m_grain_size(1), m_failed(false) {
+  nthreads = hardware_nthreads(nthreads);
+  for (size_t i = 1; i < nthreads; ++i) {
+    m_threads.emplace_back(&thread_pool::main, this, i);
+  }
+}
+
+thread_pool::~thread_pool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_start.notify_all();
+
+  for (std::thread &thread : m_threads) {
+    thread.join();
+  }
+}
+
+bool thread_pool::in_parallel_region() { return parallel_region; }
+
+bool thread_pool::next(size_t worker, size_t &chunk) {
+  run_type &run = m_runs[worker];
+  std::lock_guard<std::mutex> lock(run.mutex);
+
+  if (run.begin == run.end) {
+    return false;
+  }
+
+  chunk = run.begin++;
+  return true;
+}
+
+bool thread_pool::steal(size_t worker, size_t &chunk) {
+  size_t nthreads = get_nthreads();
+  for (;;) {
+    // Pick the worker with the most chunks left
+    size_t victim = worker, remaining = 0;
+    for (size_t i = 0; i < nthreads; ++i) {
+      if (i != worker) {
+        std::lock_guard<std::mutex> lock(m_runs[i].mutex);
+        if (m_runs[i].end - m_runs[i].begin > remaining) {
+          victim = i;
+          remaining = m_runs[i].end - m_runs[i].begin;
+        }
+      }
+    }
+
+    if (remaining == 0) {
+      return false;
+    }
+
+    // Take the back half of its run, the victim may have made progress since
+    size_t begin, end;
+    {
+      std::lock_guard<std::mutex> lock(m_runs[victim].mutex);
+      run_type &run = m_runs[victim];
+      if (run.begin == run.end) {
+        continue;
+      }
+
+      end = run.end;
+      begin = end - (run.end - run.begin + 1) / 2;
+      run.end = begin;
+    }
+
+    run_type &run = m_runs[worker];
+    std::lock_guard<std::mutex> lock(run.mutex);
+    run.begin = begin + 1;
+    run.end = end;
+    chunk = begin;
+    return true;
+  }
+}
+
+void thread_pool::work(size_t worker) {
+  size_t chunk;
+  while (!m_failed && (next(worker, chunk) || steal(worker, chunk))) {
+    size_t begin = chunk * m_grain_size;
+    size_t end = std::min(begin + m_grain_size, m_size);
+    try {
+      (*m_task)(worker, begin, end);
+    }
+    catch (...) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (!m_error) {
+        m_error = std::current_exception();
+      }
+      m_failed = true;
+    }
+  }
+}
+
+void thread_pool::main(size_t worker) {
+  parallel_region = true;
+
+  size_t generation = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_start.wait(lock, [&] { return m_stop || m_generation != generation; });
+      if (m_stop) {
+        return;
+      }
+      generation = m_generation;
+    }
+
+    work(worker);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (--m_running == 0) {
+      m_finish.notify_all();
+    }
+  }
+}
+
+void thread_pool::parallel_for(size_t size, size_t grain_size, const task_type &task) {
+  if (size == 0) {
+    return;
+  }
+
+  grain_size = std::max<size_t>(grain_size, 1);
+  size_t nchunks = (size - 1) / grain_size + 1;
+  size_t nthreads = get_nthreads();
+
+  std::unique_lock<std::mutex> busy(m_busy, std::defer_lock);
+  if (nthreads == 1 || nchunks == 1 || parallel_region || !busy.try_lock()) {
+    task(0, 0, size);
+    return;
+  }
+
+  for (size_t i = 0; i < nthreads; ++i) {
+    m_runs[i].begin = nchunks * i / nthreads;
+    m_runs[i].end = nchunks * (i + 1) / nthreads;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_task = &task;
+    m_size = size;
+    m_grain_size = grain_size;
+    m_error = nullptr;
+    m_failed = false;
+    m_running = nthreads - 1;
+    ++m_generation;
+  }
+  m_start.notify_all();
+
+  parallel_region = true;
+  work(0);
+  parallel_region = false;
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_finish.wait(lock, [&] { return m_running == 0; });
+  m_task = nullptr;
+
+  if (m_error) {
+    std::exception_ptr error = m_error;
+    m_error = nullptr;
+    std::rethrow_exception(error);
+  }
+}
+
+std::shared_ptr<thread_pool> dynd::get_thread_pool(size_t nthreads) {
+  static std::mutex mutex;
+  static std::shared_ptr<thread_pool> pool;
+
+  nthreads = hardware_nthreads(nthreads);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!pool || pool->get_nthreads() != nthreads) {
+    pool = std::make_shared<thread_pool>(nthreads);
+  }
+
+  return pool;
+}
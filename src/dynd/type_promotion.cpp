@@ -8,7 +8,9 @@
 
 #include <dynd/type_promotion.hpp>
 #include <dynd/types/option_type.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
 #include <dynd/types/string_type.hpp>
+#include <dynd/types/struct_type.hpp>
 #include <dynd/types/var_dim_type.hpp>
 
 using namespace std;
@@ -234,3 +236,107 @@ ndt::type dynd::promote_types_arithmetic(const ndt::type &tp0, const ndt::type &
   ss << "type promotion of " << tp0 << " and " << tp1 << " is not yet supported";
   throw dynd::type_error(ss.str());
 }
+
+static bool is_inferred_number(const ndt::type &tp) {
+  switch (tp.get_base_id()) {
+  case int_kind_id:
+  case uint_kind_id:
+  case float_kind_id:
+  case complex_kind_id:
+    return true;
+  default:
+    return false;
+  }
+}
+
+static bool is_inferred_dim(const ndt::type &tp) { return tp.get_id() == fixed_dim_id || tp.get_id() == var_dim_id; }
+
+static bool is_empty_tuple(const ndt::type &tp) {
+  return tp.get_id() == tuple_id && tp.extended<ndt::tuple_type>()->get_field_count() == 0;
+}
+
+static ndt::type make_inferred_option(const ndt::type &tp) {
+  return tp.get_id() == option_id ? tp : ndt::make_type<ndt::option_type>(tp);
+}
+
+ndt::type dynd::promote_types_inferred(const ndt::type &tp0, const ndt::type &tp1) {
+  if (tp0 == tp1) {
+    return tp0;
+  }
+
+  // An option of Any, inferred from a null, only makes the other type optional
+  if (tp0.get_id() == option_id || tp1.get_id() == option_id) {
+    const ndt::type &val0 = tp0.get_id() == option_id ? tp0.extended<ndt::option_type>()->get_value_type() : tp0;
+    const ndt::type &val1 = tp1.get_id() == option_id ? tp1.extended<ndt::option_type>()->get_value_type() : tp1;
+    if (val0.get_id() == any_kind_id) {
+      return make_inferred_option(val1);
+    } else if (val1.get_id() == any_kind_id) {
+      return make_inferred_option(val0);
+    }
+    return make_inferred_option(promote_types_inferred(val0, val1));
+  }
+
+  if (is_inferred_number(tp0) && is_inferred_number(tp1)) {
+    return promote_types_arithmetic(tp0, tp1);
+  }
+
+  if ((tp0.get_id() == string_id || tp0.get_id() == fixed_string_id) &&
+      (tp1.get_id() == string_id || tp1.get_id() == fixed_string_id)) {
+    return ndt::make_type<ndt::string_type>();
+  }
+
+  // An empty tuple is inferred from an empty list, so it goes with any dimension
+  if (is_inferred_dim(tp0) && is_empty_tuple(tp1)) {
+    return ndt::make_type<ndt::var_dim_type>(tp0.extended<ndt::base_dim_type>()->get_element_type());
+  } else if (is_empty_tuple(tp0) && is_inferred_dim(tp1)) {
+    return ndt::make_type<ndt::var_dim_type>(tp1.extended<ndt::base_dim_type>()->get_element_type());
+  }
+
+  if (is_inferred_dim(tp0) && is_inferred_dim(tp1)) {
+    ndt::type el_tp = promote_types_inferred(tp0.extended<ndt::base_dim_type>()->get_element_type(),
+                                             tp1.extended<ndt::base_dim_type>()->get_element_type());
+    if (tp0.get_id() == fixed_dim_id && tp1.get_id() == fixed_dim_id &&
+        tp0.extended<ndt::fixed_dim_type>()->get_fixed_dim_size() ==
+            tp1.extended<ndt::fixed_dim_type>()->get_fixed_dim_size()) {
+      return ndt::make_fixed_dim(tp0.extended<ndt::fixed_dim_type>()->get_fixed_dim_size(), el_tp);
+    }
+    return ndt::make_type<ndt::var_dim_type>(el_tp);
+  }
+
+  if (tp0.get_id() == tuple_id && tp1.get_id() == tuple_id) {
+    const ndt::tuple_type *tt0 = tp0.extended<ndt::tuple_type>();
+    const ndt::tuple_type *tt1 = tp1.extended<ndt::tuple_type>();
+    if (tt0->get_field_count() == tt1->get_field_count()) {
+      std::vector<ndt::type> field_tps;
+      for (intptr_t i = 0; i < tt0->get_field_count(); ++i) {
+        field_tps.push_back(promote_types_inferred(tt0->get_field_type(i), tt1->get_field_type(i)));
+      }
+      return ndt::make_type<ndt::tuple_type>(field_tps);
+    }
+  }
+
+  if (tp0.get_id() == struct_id && tp1.get_id() == struct_id) {
+    const ndt::struct_type *st0 = tp0.extended<ndt::struct_type>();
+    const ndt::struct_type *st1 = tp1.extended<ndt::struct_type>();
+    // The fields of the first struct come first, in their order
+    std::vector<std::string> field_names;
+    std::vector<ndt::type> field_tps;
+    for (intptr_t i = 0; i < st0->get_field_count(); ++i) {
+      field_names.push_back(st0->get_field_name(i));
+      intptr_t j = st1->get_field_index(field_names.back());
+      field_tps.push_back(j < 0 ? make_inferred_option(st0->get_field_type(i))
+                                : promote_types_inferred(st0->get_field_type(i), st1->get_field_type(j)));
+    }
+    for (intptr_t j = 0; j < st1->get_field_count(); ++j) {
+      if (st0->get_field_index(st1->get_field_name(j)) < 0) {
+        field_names.push_back(st1->get_field_name(j));
+        field_tps.push_back(make_inferred_option(st1->get_field_type(j)));
+      }
+    }
+    return ndt::make_type<ndt::struct_type>(field_names, field_tps);
+  }
+
+  stringstream ss;
+  ss << "cannot promote the inferred types " << tp0 << " and " << tp1 << " to a common type";
+  throw dynd::type_error(ss.str());
+}
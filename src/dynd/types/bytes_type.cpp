@@ -91,6 +91,19 @@ bool ndt::bytes_type::operator==(const base_type &rhs) const {
   }
 }
 
+void ndt::bytes_type::arrmeta_copy_construct(char *dst_arrmeta, const char *src_arrmeta,
+                                             const nd::memory_block &DYND_UNUSED(embedded_reference)) const {
+  const metadata_type *src_md = reinterpret_cast<const metadata_type *>(src_arrmeta);
+  metadata_type *dst_md = reinterpret_cast<metadata_type *>(dst_arrmeta);
+  dst_md->blockref = src_md->blockref;
+  dst_md->owner = false;
+}
+
+void ndt::bytes_type::arrmeta_destruct(char *arrmeta) const {
+  metadata_type *md = reinterpret_cast<metadata_type *>(arrmeta);
+  md->~metadata_type();
+}
+
 void ndt::bytes_type::data_destruct(const char *DYND_UNUSED(arrmeta), char *data) const {
   reinterpret_cast<bytes *>(data)->~bytes();
 }
@@ -3,15 +3,19 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <algorithm>
 #include <cstring>
 #include <map>
-#include <set>
+#include <numeric>
 
-#include <dynd/array_range.hpp>
 #include <dynd/assignment.hpp>
 #include <dynd/callable.hpp>
+#include <dynd/comparison.hpp>
+#include <dynd/hash.hpp>
+#include <dynd/kernels/prepared_kernel.hpp>
 #include <dynd/parse_util.hpp>
 #include <dynd/search.hpp>
+#include <dynd/sort.hpp>
 #include <dynd/types/categorical_type.hpp>
 #include <dynd/types/datashape_parser.hpp>
 #include <dynd/types/fixed_dim_type.hpp>
@@ -21,127 +25,131 @@ using namespace std;
 
 namespace {
 
-class sorter {
-  char *m_originptr;
-  intptr_t m_stride;
-  const kernel_single_t m_less;
-  nd::kernel_prefix *m_less_self;
+/**
+ * Fills ``perm`` with the permutation that stably sorts the ``count``
+ * elements of the one-dimensional array ``categories``.
+ */
+void sort_categories(const nd::array &categories, intptr_t count, intptr_t *perm) {
+  const ndt::type &category_tp = categories.get_type().at(0);
+  if (category_tp.get_id() == fixed_string_id) {
+    // There is no ``less`` kernel for fixed_string, but as it pads with zeros
+    // its elements sort by their bytes
+    const char *data = categories.cdata();
+    intptr_t stride = reinterpret_cast<const fixed_dim_type_arrmeta *>(categories.get()->metadata())->stride;
+    size_t data_size = category_tp.get_data_size();
+    std::iota(perm, perm + count, 0);
+    std::stable_sort(perm, perm + count, [=](intptr_t i, intptr_t j) {
+      return std::memcmp(data + i * stride, data + j * stride, data_size) < 0;
+    });
+  } else {
+    nd::array sorted_perm = nd::argsort(categories);
+    for (intptr_t i = 0; i < count; ++i) {
+      perm[i] = ndt::unchecked_fixed_dim_get<int64_t>(sorted_perm, i);
+    }
+  }
+}
 
-public:
-  sorter(const char *originptr, intptr_t stride, const kernel_single_t less, nd::kernel_prefix *less_self)
-      : m_originptr(const_cast<char *>(originptr)), m_stride(stride), m_less(less), m_less_self(less_self) {}
+/**
+ * Returns the ``count`` elements of the one-dimensional array ``a`` at
+ * ``indices``, copied through one prepared assignment kernel.
+ */
+nd::array gather(const nd::array &a, const intptr_t *indices, intptr_t count) {
+  ndt::type el_tp = a.get_type().at(0);
+  nd::array res = nd::empty(count, el_tp);
+
+  const char *src_arrmeta = a.get()->metadata() + sizeof(fixed_dim_type_arrmeta);
+  nd::prepared_kernel copy(nd::assign, el_tp, res.get()->metadata() + sizeof(fixed_dim_type_arrmeta), 1, &el_tp,
+                           &src_arrmeta);
+
+  intptr_t src_stride = reinterpret_cast<const fixed_dim_type_arrmeta *>(a.get()->metadata())->stride;
+  intptr_t dst_stride = reinterpret_cast<const fixed_dim_type_arrmeta *>(res.get()->metadata())->stride;
+  for (intptr_t i = 0; i < count; ++i) {
+    char *src = const_cast<char *>(a.cdata()) + indices[i] * src_stride;
+    copy.single(res.data() + i * dst_stride, &src);
+  }
 
-  bool operator()(intptr_t i, intptr_t j) const {
-    int dst;
-    char *s[2] = {m_originptr + i * m_stride, m_originptr + j * m_stride};
-    m_less(m_less_self, reinterpret_cast<char *>(&dst), s);
+  return res;
+}
 
-    return dst != 0;
+/**
+ * Fills the hash index of ``count`` categories, returning the index of the
+ * first category equal to an earlier one or -1 if they are all distinct.
+ */
+template <typename HashType>
+intptr_t build_index(const HashType &h, const char *categories, intptr_t stride, intptr_t count,
+                     vector<uint32_t> &index) {
+  size_t size = 16;
+  while (size < 2 * static_cast<size_t>(count)) {
+    size *= 2;
+  }
+  index.assign(size, 0);
+
+  size_t mask = size - 1;
+  for (intptr_t i = 0; i < count; ++i) {
+    const char *data = categories + i * stride;
+    size_t j = h.hash(data) & mask;
+    for (; index[j] != 0; j = (j + 1) & mask) {
+      if (h.equal(categories + (index[j] - 1) * stride, data)) {
+        return i;
+      }
+    }
+    index[j] = static_cast<uint32_t>(i + 1);
   }
-};
 
-class cmp {
-  const kernel_single_t m_less;
-  nd::kernel_prefix *m_less_self;
+  return -1;
+}
 
-public:
-  cmp(const kernel_single_t less, nd::kernel_prefix *less_self) : m_less(less), m_less_self(less_self) {}
+template <typename HashType>
+inline intptr_t find_index(const HashType &h, const vector<uint32_t> &index, const char *categories, intptr_t stride,
+                           const char *data) {
+  size_t mask = index.size() - 1;
+  for (size_t j = h.hash(data) & mask; index[j] != 0; j = (j + 1) & mask) {
+    if (h.equal(categories + (index[j] - 1) * stride, data)) {
+      return index[j] - 1;
+    }
+  }
 
-  bool operator()(const char *a, const char *b) const {
-    int dst;
-    char *s[2] = {const_cast<char *>(a), const_cast<char *>(b)};
+  return -1;
+}
 
-    m_less(m_less_self, reinterpret_cast<char *>(&dst), s);
-    return dst != 0;
-  }
-};
-
-// struct assign_from_commensurate_category {
-//     static void general_kernel(char *dst, intptr_t dst_stride, const char
-//     *src, intptr_t src_stride,
-//                         intptr_t count, const AuxDataBase *auxdata)
-//     {
-//         categorical_type *cat = reinterpret_cast<categorical_type *>(
-//             get_raw_auxiliary_data(auxdata)&~1
-//         );
-//     }
-
-//     static void scalar_kernel(char *dst, intptr_t DYND_UNUSED(dst_stride),
-//     const char *src, intptr_t DYND_UNUSED(src_stride),
-//                         intptr_t, const AuxDataBase *auxdata)
-//     {
-//         categorical_type *cat = reinterpret_cast<categorical_type *>(
-//             get_raw_auxiliary_data(auxdata)&~1
-//         );
-//     }
-
-//     static void contiguous_kernel(char *dst, intptr_t
-//     DYND_UNUSED(dst_stride), const char *src, intptr_t
-//     DYND_UNUSED(src_stride),
-//                         intptr_t count, const AuxDataBase *auxdata)
-//     {
-//         categorical_type *cat = reinterpret_cast<categorical_type *>(
-//             get_raw_auxiliary_data(auxdata)&~1
-//         );
-//     }
-
-//     static void scalar_to_contiguous_kernel(char *dst, intptr_t
-//     DYND_UNUSED(dst_stride), const char *src, intptr_t
-//     DYND_UNUSED(src_stride),
-//                         intptr_t count, const AuxDataBase *auxdata)
-//     {
-//         categorical_type *cat = reinterpret_cast<categorical_type *>(
-//             get_raw_auxiliary_data(auxdata)&~1
-//         );
-//     }
-// };
-
-// static specialized_unary_operation_table_t
-// assign_from_commensurate_category_specializations = {
-//     assign_from_commensurate_category::general_kernel,
-//     assign_from_commensurate_category::scalar_kernel,
-//     assign_from_commensurate_category::contiguous_kernel,
-//     assign_from_commensurate_category::scalar_to_contiguous_kernel
-// };
-
-} // anoymous namespace
-
-/** This function converts the set of char* pointers into a strided immutable
- * nd::array of the categories */
-static nd::array make_sorted_categories(const set<const char *, cmp> &uniques, const ndt::type &element_tp,
-                                        const char *DYND_UNUSED(arrmeta)) {
-  nd::array categories = nd::empty(uniques.size(), element_tp);
-  nd::kernel_builder k;
-  //  make_assignment_kernel(&k, element_tp, categories.get()->metadata() + sizeof(fixed_dim_type_arrmeta), element_tp,
-  //                       arrmeta, kernel_request_single, &eval::default_eval_context);
-  kernel_single_t fn = k.get()->get_function<kernel_single_t>();
-
-  intptr_t stride = reinterpret_cast<const fixed_dim_type_arrmeta *>(categories.get()->metadata())->stride;
-  char *dst_ptr = categories.data();
-  for (set<const char *, cmp>::const_iterator it = uniques.begin(); it != uniques.end(); ++it) {
-    char *src = const_cast<char *>(*it);
-    fn(k.get(), dst_ptr, &src);
-    dst_ptr += stride;
+/**
+ * Encodes ``count`` strided elements, returning the position of the first
+ * one that is not a category or ``count`` if they all are.
+ */
+template <typename ValueType, typename HashType>
+size_t encode_values(const HashType &h, const vector<uint32_t> &index, const char *categories, intptr_t stride,
+                     const intptr_t *category_index_to_value, char *dst, intptr_t dst_stride, const char *src,
+                     intptr_t src_stride, size_t count) {
+  for (size_t i = 0; i < count; ++i, dst += dst_stride, src += src_stride) {
+    intptr_t j = find_index(h, index, categories, stride, src);
+    if (j < 0) {
+      return i;
+    }
+    *reinterpret_cast<ValueType *>(dst) = static_cast<ValueType>(category_index_to_value[j]);
   }
-  categories.get_type().extended()->arrmeta_finalize_buffers(categories.get()->metadata());
 
-  return categories;
+  return count;
 }
 
+} // anonymous namespace
+
 ndt::categorical_type::categorical_type(type_id_t id, const nd::array &categories, bool presorted)
     : base_type(id, 4, 4, type_flag_none, 0, 0, 0) {
-  intptr_t category_count;
+  intptr_t category_count = categories.get_dim_size();
+  m_value_to_category_index = nd::empty(category_count, make_type<intptr_t>());
+  m_category_index_to_value = nd::empty(category_count, make_type<intptr_t>());
+  intptr_t *value_to_category_index = reinterpret_cast<intptr_t *>(m_value_to_category_index.data());
+  intptr_t *category_index_to_value = reinterpret_cast<intptr_t *>(m_category_index_to_value.data());
+
   if (presorted) {
     // This is construction shortcut, for the case when the categories are
-    // already
-    // sorted. No validation of this is done, the caller should have ensured it
-    // was correct already, typically by construction.
+    // already sorted. No validation of this is done, the caller should have
+    // ensured it was correct already, typically by construction.
     m_categories = categories.eval();
     m_category_tp = m_categories.get_type().at(0);
-
-    category_count = categories.get_dim_size();
-    m_value_to_category_index = nd::old_range(category_count);
-    m_category_index_to_value = m_value_to_category_index;
+    for (intptr_t i = 0; i < category_count; ++i) {
+      category_index_to_value[i] = i;
+    }
   } else {
     // Process the categories array to make sure it's valid
     const type &cdt = categories.get_type();
@@ -155,49 +163,37 @@ ndt::categorical_type::categorical_type(type_id_t id, const nd::array &categorie
                              "a 1-dimensional strided array of categories");
     }
 
-    category_count = categories.get_dim_size();
-    intptr_t categories_stride = reinterpret_cast<const fixed_dim_type_arrmeta *>(categories.get()->metadata())->stride;
-
-    const char *categories_element_arrmeta = categories.get()->metadata() + sizeof(fixed_dim_type_arrmeta);
-    nd::kernel_builder k;
-    kernel_single_t fn = k.get()->get_function<kernel_single_t>();
-
-    cmp less(fn, k.get());
-    set<const char *, cmp> uniques(less);
-
-    m_value_to_category_index = nd::empty(category_count, make_type<intptr_t>());
-    m_category_index_to_value = nd::empty(category_count, make_type<intptr_t>());
-
-    // create the mapping from indices of (to be lexicographically sorted)
-    // categories to values
-    for (size_t i = 0; i != (size_t)category_count; ++i) {
-      unchecked_fixed_dim_get_rw<intptr_t>(m_category_index_to_value, i) = i;
-      const char *category_value = categories.cdata() + i * categories_stride;
-
-      if (uniques.find(category_value) == uniques.end()) {
-        uniques.insert(category_value);
-      } else {
-        stringstream ss;
-        ss << "categories must be unique: category value ";
-        m_category_tp.print_data(ss, categories_element_arrmeta, category_value);
-        ss << " appears more than once";
-        throw std::runtime_error(ss.str());
+    // Sort the categories, keeping the permutation from sorted positions
+    // (category indices) to their original positions (values)
+    sort_categories(categories, category_count, category_index_to_value);
+    m_categories = gather(categories, category_index_to_value, category_count);
+  }
+
+  // invert the m_category_index_to_value permutation
+  for (intptr_t i = 0; i < category_count; ++i) {
+    value_to_category_index[category_index_to_value[i]] = i;
+  }
+
+  // Index the categories by hash, which also finds any duplicates
+  const char *categories_data = m_categories.cdata();
+  intptr_t categories_stride = reinterpret_cast<const fixed_dim_type_arrmeta *>(m_categories.get()->metadata())->stride;
+  intptr_t duplicate = -1;
+  if (!dynd::detail::with_element_hash(m_category_tp.get_id(), m_category_tp.get_data_size(), [&](auto h) {
+        duplicate = build_index(h, categories_data, categories_stride, category_count, m_index);
+      })) {
+    for (intptr_t i = 1; i < category_count; ++i) {
+      if (!nd::less(m_categories(i - 1), m_categories(i)).as<bool>()) {
+        duplicate = i;
+        break;
       }
     }
-    // TODO: Putting everything in a set already caused a sort operation to
-    // occur,
-    //       there's no reason we should need a second sort.
-    std::sort(&unchecked_fixed_dim_get_rw<intptr_t>(m_category_index_to_value, 0),
-              &unchecked_fixed_dim_get_rw<intptr_t>(m_category_index_to_value, category_count),
-              sorter(categories.cdata(), categories_stride, fn, k.get()));
-
-    // invert the m_category_index_to_value permutation
-    for (intptr_t i = 0; i < category_count; ++i) {
-      unchecked_fixed_dim_get_rw<intptr_t>(m_value_to_category_index,
-                                           unchecked_fixed_dim_get<intptr_t>(m_category_index_to_value, i)) = i;
-    }
-
-    m_categories = make_sorted_categories(uniques, m_category_tp, categories_element_arrmeta);
+  }
+  if (duplicate >= 0 && !presorted) {
+    stringstream ss;
+    ss << "categories must be unique: category value ";
+    m_category_tp.print_data(ss, get_category_arrmeta(), categories_data + duplicate * categories_stride);
+    ss << " appears more than once";
+    throw std::runtime_error(ss.str());
   }
 
   // Use the number of categories to set which underlying integer storage to use
@@ -261,23 +257,86 @@ void ndt::categorical_type::get_shape(intptr_t ndim, intptr_t i, intptr_t *out_s
   }
 }
 
+intptr_t ndt::categorical_type::find_value(const char *category_data) const {
+  const char *categories_data = m_categories.cdata();
+  intptr_t categories_stride = reinterpret_cast<const fixed_dim_type_arrmeta *>(m_categories.get()->metadata())->stride;
+
+  intptr_t i = -1;
+  if (!dynd::detail::with_element_hash(m_category_tp.get_id(), m_category_tp.get_data_size(), [&](auto h) {
+        i = find_index(h, m_index, categories_data, categories_stride, category_data);
+      })) {
+    type dst_tp = make_type<intptr_t>();
+    type src_tp[2] = {m_categories.get_type(), m_category_tp};
+    const char *src_arrmeta[2] = {m_categories.get()->metadata(), get_category_arrmeta()};
+    char *src_data[2] = {const_cast<char *>(categories_data), const_cast<char *>(category_data)};
+    i = nd::binary_search->call(dst_tp, 2, src_tp, src_arrmeta, src_data, 0, NULL, std::map<std::string, ndt::type>())
+            .as<intptr_t>();
+  }
+
+  return i < 0 ? -1 : unchecked_fixed_dim_get<intptr_t>(m_category_index_to_value, i);
+}
+
+void ndt::categorical_type::encode(char *dst, intptr_t dst_stride, const char *src, intptr_t src_stride,
+                                   size_t count) const {
+  const char *categories_data = m_categories.cdata();
+  intptr_t categories_stride = reinterpret_cast<const fixed_dim_type_arrmeta *>(m_categories.get()->metadata())->stride;
+  const intptr_t *category_index_to_value = reinterpret_cast<const intptr_t *>(m_category_index_to_value.cdata());
+
+  // Dispatch on the types once, so every element is a probe of the index
+  size_t encoded = 0;
+  bool hashable = dynd::detail::with_element_hash(m_category_tp.get_id(), m_category_tp.get_data_size(), [&](auto h) {
+    switch (m_storage_type.get_id()) {
+    case uint8_id:
+      encoded = encode_values<uint8_t>(h, m_index, categories_data, categories_stride, category_index_to_value, dst,
+                                       dst_stride, src, src_stride, count);
+      break;
+    case uint16_id:
+      encoded = encode_values<uint16_t>(h, m_index, categories_data, categories_stride, category_index_to_value, dst,
+                                        dst_stride, src, src_stride, count);
+      break;
+    default:
+      encoded = encode_values<uint32_t>(h, m_index, categories_data, categories_stride, category_index_to_value, dst,
+                                        dst_stride, src, src_stride, count);
+      break;
+    }
+  });
+
+  if (!hashable) {
+    for (; encoded < count; ++encoded) {
+      uint32_t value = get_value_from_category(get_category_arrmeta(), src + encoded * src_stride);
+      char *dst_data = dst + encoded * dst_stride;
+      switch (m_storage_type.get_id()) {
+      case uint8_id:
+        *reinterpret_cast<uint8_t *>(dst_data) = static_cast<uint8_t>(value);
+        break;
+      case uint16_id:
+        *reinterpret_cast<uint16_t *>(dst_data) = static_cast<uint16_t>(value);
+        break;
+      default:
+        *reinterpret_cast<uint32_t *>(dst_data) = value;
+        break;
+      }
+    }
+  } else if (encoded < count) {
+    stringstream ss;
+    ss << "Unrecognized category value ";
+    m_category_tp.print_data(ss, get_category_arrmeta(), src + encoded * src_stride);
+    ss << " assigning to dynd type " << type(this, true);
+    throw std::runtime_error(ss.str());
+  }
+}
+
 uint32_t ndt::categorical_type::get_value_from_category(const char *category_arrmeta, const char *category_data) const {
-  type dst_tp = make_type<intptr_t>();
-  type src_tp[2] = {m_categories.get_type(), m_category_tp};
-  const char *src_arrmeta[2] = {m_categories.get()->metadata(), category_arrmeta};
-  char *src_data[2] = {const_cast<char *>(m_categories.cdata()), const_cast<char *>(category_data)};
-  intptr_t i =
-      nd::binary_search->call(dst_tp, 2, src_tp, src_arrmeta, src_data, 0, NULL, std::map<std::string, ndt::type>())
-          .as<intptr_t>();
-  if (i < 0) {
+  intptr_t value = find_value(category_data);
+  if (value < 0) {
     stringstream ss;
     ss << "Unrecognized category value ";
     m_category_tp.print_data(ss, category_arrmeta, category_data);
     ss << " assigning to dynd type " << type(this, true);
     throw std::runtime_error(ss.str());
-  } else {
-    return (uint32_t)unchecked_fixed_dim_get<intptr_t>(m_category_index_to_value, i);
   }
+
+  return static_cast<uint32_t>(value);
 }
 
 uint32_t ndt::categorical_type::get_value_from_category(const nd::array &category) const {
@@ -291,16 +350,7 @@ uint32_t ndt::categorical_type::get_value_from_category(const nd::array &categor
     c.assign(category);
   }
 
-  intptr_t i = nd::binary_search(m_categories, c).as<intptr_t>();
-  if (i < 0) {
-    stringstream ss;
-    ss << "Unrecognized category value ";
-    m_category_tp.print_data(ss, c.get()->metadata(), c.data());
-    ss << " assigning to dynd type " << type(this, true);
-    throw std::runtime_error(ss.str());
-  } else {
-    return (uint32_t)unchecked_fixed_dim_get<intptr_t>(m_category_index_to_value, i);
-  }
+  return get_value_from_category(c.get()->metadata(), c.cdata());
 }
 
 const char *ndt::categorical_type::get_category_arrmeta() const {
@@ -310,22 +360,8 @@ const char *ndt::categorical_type::get_category_arrmeta() const {
 }
 
 nd::array ndt::categorical_type::get_categories() const {
-  // TODO: store categories in their original order
-  //       so this is simply "return m_categories".
-  nd::array categories = nd::empty(get_category_count(), m_category_tp);
-  intptr_t dim_size, stride;
-  type el_tp;
-  const char *el_arrmeta;
-  categories.get_type().get_as_strided(categories.get()->metadata(), &dim_size, &stride, &el_tp, &el_arrmeta);
-  nd::kernel_builder k;
-  //  ::make_assignment_kernel(&k, m_category_tp, el_arrmeta, el_tp, get_category_arrmeta(), kernel_request_single,
-  //                         &eval::default_eval_context);
-  kernel_single_t fn = k.get()->get_function<kernel_single_t>();
-  for (intptr_t i = 0; i < dim_size; ++i) {
-    char *src = const_cast<char *>(get_category_data_from_value((uint32_t)i));
-    fn(k.get(), categories.data() + i * stride, &src);
-  }
-  return categories;
+  return gather(m_categories, reinterpret_cast<const intptr_t *>(m_value_to_category_index.cdata()),
+                m_categories.get_dim_size());
 }
 
 bool ndt::categorical_type::is_lossless_assignment(const type &dst_tp, const type &src_tp) const {
@@ -376,32 +412,16 @@ void ndt::categorical_type::arrmeta_debug_print(const char *DYND_UNUSED(arrmeta)
 }
 
 ndt::type ndt::factor_categorical(const nd::array &values) {
-  // Do the factor operation on a concrete version of the values
-  // TODO: Some cases where we don't want to do this?
-  nd::array values_eval = values.eval();
-
-  intptr_t dim_size, stride;
-  type el_tp;
-  const char *el_arrmeta;
-  values_eval.get_type().get_as_strided(values_eval.get()->metadata(), &dim_size, &stride, &el_tp, &el_arrmeta);
-
-  nd::kernel_builder k;
-  kernel_single_t fn = k.get()->get_function<kernel_single_t>();
-
-  cmp less(fn, k.get());
-  set<const char *, cmp> uniques(less);
-
-  for (intptr_t i = 0; i < dim_size; ++i) {
-    const char *data = values_eval.cdata() + i * stride;
-    if (uniques.find(data) == uniques.end()) {
-      uniques.insert(data);
-    }
-  }
+  // Find the distinct values with a hash table, then sort only those
+  nd::array uniques = nd::unique(values.eval());
+  intptr_t category_count = uniques.get_dim_size();
+  nd::array categories = nd::empty(category_count, uniques.get_type().at(0));
+  categories.vals() = uniques;
 
-  // Copy the values (now sorted and unique) into a new nd::array
-  nd::array categories = make_sorted_categories(uniques, el_tp, el_arrmeta);
+  std::vector<intptr_t> perm(category_count);
+  sort_categories(categories, category_count, perm.data());
 
-  return make_type<categorical_type>(categories, true);
+  return make_type<categorical_type>(gather(categories, perm.data(), category_count), true);
 }
 
 std::map<std::string, std::pair<ndt::type, const char *>> ndt::categorical_type::get_dynamic_type_properties() const {
@@ -233,10 +233,15 @@ static void move_to_tuple(const ndt::type &tp, const char *meta, char *data, vec
   auto data_offsets = reinterpret_cast<const uintptr_t *>(meta);
   for (size_t i = 0; i != values.size(); ++i) {
     const nd::buffer &buf = values[i];
-    if (buf.get_type() != types[i] ||
-        memcmp(buf.get()->metadata(), meta + meta_offsets[i], types[i].get_arrmeta_size()) != 0) {
+    if (buf.get_type() != types[i]) {
       throw runtime_error("internal error concatenating datashape type arguments in dynd datashape parser");
     }
+    // The arrmeta comes along too, as it may hold memory the data points into, like the arena of strings
+    if (types[i].get_arrmeta_size() > 0) {
+      char *field_meta = const_cast<char *>(meta) + meta_offsets[i];
+      types[i].extended()->arrmeta_destruct(field_meta);
+      types[i].extended()->arrmeta_copy_construct(field_meta, buf.get()->metadata(), nd::memory_block());
+    }
     memcpy(data + data_offsets[i], buf.cdata(), types[i].get_default_data_size());
     // Destroy the nd::buffer without destructing its data
     nd::buffer tmp;
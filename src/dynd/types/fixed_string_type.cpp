@@ -58,23 +58,14 @@ void ndt::fixed_string_type::set_from_utf8_string(const char *DYND_UNUSED(arrmet
 {
   assign_error_mode errmode = ectx->errmode;
   char *dst_end = dst + get_data_size();
-  next_unicode_codepoint_t next_fn = get_next_unicode_codepoint_function(string_encoding_utf_8, errmode);
-  append_unicode_codepoint_t append_fn = get_append_unicode_codepoint_function(m_encoding, errmode);
-  uint32_t cp;
+  string_transcoder transcode(m_encoding, string_encoding_utf_8, errmode);
 
-  while (utf8_begin < utf8_end && dst < dst_end) {
-    cp = next_fn(utf8_begin, utf8_end);
-    append_fn(cp, dst, dst_end);
-  }
-  if (utf8_begin < utf8_end) {
-    if (errmode != assign_error_nocheck) {
-      throw std::runtime_error("Input is too large to convert to "
-                               "destination fixed-size string");
-    }
-  }
-  else if (dst < dst_end) {
-    memset(dst, 0, dst_end - dst);
+  transcode(dst, dst_end, utf8_begin, utf8_end, false);
+  if (utf8_begin < utf8_end && errmode != assign_error_nocheck) {
+    throw std::runtime_error("Input is too large to convert to "
+                             "destination fixed-size string");
   }
+  memset(dst, 0, dst_end - dst);
 }
 
 void ndt::fixed_string_type::print_data(std::ostream &o, const char *DYND_UNUSED(arrmeta), const char *data) const
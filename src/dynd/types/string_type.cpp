@@ -21,44 +21,41 @@ void ndt::string_type::get_string_range(const char **out_begin, const char **out
   *out_end = reinterpret_cast<const string *>(data)->end();
 }
 
-void ndt::string_type::set_from_utf8_string(const char *DYND_UNUSED(arrmeta), char *dst, const char *utf8_begin,
+void ndt::string_type::set_from_utf8_string(const char *arrmeta, char *dst, const char *utf8_begin,
                                             const char *utf8_end, const eval::eval_context *ectx) const
 {
-  assign_error_mode errmode = ectx->errmode;
-  const intptr_t src_charsize = 1;
-  intptr_t dst_charsize = string_encoding_char_size_table[string_encoding_utf_8];
-  char *dst_current;
-  next_unicode_codepoint_t next_fn = get_next_unicode_codepoint_function(string_encoding_utf_8, errmode);
-  append_unicode_codepoint_t append_fn = get_append_unicode_codepoint_function(string_encoding_utf_8, errmode);
-  uint32_t cp;
+  string_transcoder transcode(string_encoding_utf_8, string_encoding_utf_8, ectx->errmode);
+
+  // Validating UTF-8 never makes it longer, as invalid bytes are replaced by '?', so the output is built in place
+  string *dst_str = reinterpret_cast<string *>(dst);
+  arena_resize(arrmeta, dst, utf8_end - utf8_begin);
+  char *dst_current = dst_str->begin();
+  transcode(dst_current, dst_str->end(), utf8_begin, utf8_end, false);
+  if (utf8_begin == utf8_end) {
+    dst_str->resize(dst_current - dst_str->begin());
+    return;
+  }
 
-  // Allocate the initial output as the src number of characters + some padding
-  // TODO: Don't add padding if the output is not a multi-character encoding
+  // Otherwise continue in a buffer that grows
+  intptr_t size = dst_current - dst_str->begin();
   string dst_d;
-  dst_d.resize(((utf8_end - utf8_begin) / src_charsize + 16) * dst_charsize * 1124 / 1024);
+  dst_d.resize(2 * dst_str->size() + 16);
+  DYND_MEMCPY(dst_d.begin(), dst_str->begin(), size);
   char *dst_begin = dst_d.begin();
   char *dst_end = dst_d.end();
 
-  dst_current = dst_begin;
-  while (utf8_begin < utf8_end) {
-    cp = next_fn(utf8_begin, utf8_end);
-    // Append the codepoint, or increase the allocated memory as necessary
-    if (dst_end - dst_current >= 8) {
-      append_fn(cp, dst_current, dst_end);
-    }
-    else {
-      char *dst_begin_saved = dst_begin;
-      dst_d.resize(2 * dst_d.size());
-      dst_begin = dst_d.begin();
-      dst_end = dst_d.end();
-      dst_current = dst_begin + (dst_current - dst_begin_saved);
-
-      append_fn(cp, dst_current, dst_end);
-    }
+  dst_current = dst_begin + size;
+  while (!transcode(dst_current, dst_end, utf8_begin, utf8_end, false) && utf8_begin < utf8_end) {
+    // Increase the allocated memory for the rest of the string
+    intptr_t size = dst_current - dst_begin;
+    dst_d.resize(2 * dst_d.size());
+    dst_begin = dst_d.begin();
+    dst_end = dst_d.end();
+    dst_current = dst_begin + size;
   }
 
   // Set the output
-  reinterpret_cast<string *>(dst)->assign(dst_d.begin(), dst_current - dst_begin);
+  arena_assign(arrmeta, dst, dst_d.begin(), dst_current - dst_begin);
 }
 
 void ndt::string_type::print_data(std::ostream &o, const char *DYND_UNUSED(arrmeta), const char *data) const
@@ -115,8 +112,50 @@ bool ndt::string_type::operator==(const base_type &rhs) const
   }
 }
 
-void ndt::string_type::arrmeta_debug_print(const char *DYND_UNUSED(arrmeta), std::ostream &DYND_UNUSED(o),
-                                           const std::string &DYND_UNUSED(indent)) const {}
+nd::base_memory_block *ndt::string_type::get_arena(const char *arrmeta)
+{
+  // The arena is only made once a string needs it, so that arrays whose strings all fit in SSO allocate nothing
+  metadata_type *md = reinterpret_cast<metadata_type *>(const_cast<char *>(arrmeta));
+  if (!md->blockref && md->owner) {
+    md->blockref = nd::make_memory_block<nd::pod_memory_block>(1, sizeof(size_t), 0);
+  }
+
+  return md->blockref.get();
+}
+
+void ndt::string_type::arrmeta_default_construct(char *arrmeta, bool blockref_alloc) const
+{
+  metadata_type *md = reinterpret_cast<metadata_type *>(arrmeta);
+  md->owner = blockref_alloc;
+}
+
+void ndt::string_type::arrmeta_copy_construct(char *dst_arrmeta, const char *src_arrmeta,
+                                              const nd::memory_block &DYND_UNUSED(embedded_reference)) const
+{
+  // The embedded reference does not take the place of a missing arena, as it might not allocate
+  const metadata_type *src_md = reinterpret_cast<const metadata_type *>(src_arrmeta);
+  metadata_type *dst_md = reinterpret_cast<metadata_type *>(dst_arrmeta);
+  dst_md->blockref = src_md->blockref;
+  dst_md->owner = false;
+}
+
+void ndt::string_type::arrmeta_destruct(char *arrmeta) const
+{
+  metadata_type *md = reinterpret_cast<metadata_type *>(arrmeta);
+  md->~metadata_type();
+}
+
+void ndt::string_type::arrmeta_debug_print(const char *arrmeta, std::ostream &o, const std::string &indent) const
+{
+  const metadata_type *md = reinterpret_cast<const metadata_type *>(arrmeta);
+  o << indent << "string arrmeta\n";
+  if (md->blockref) {
+    md->blockref->debug_print(o, indent + " ");
+  }
+  else {
+    o << indent << " no arena\n";
+  }
+}
 
 void ndt::string_type::data_destruct(const char *DYND_UNUSED(arrmeta), char *data) const
 {
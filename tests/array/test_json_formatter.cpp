@@ -48,6 +48,45 @@ TEST(JSONFormatter, Builtins) {
   EXPECT_EQ("null", format_json(a).as<std::string>());
 }
 
+TEST(JSONFormatter, ShortestFloats) {
+  nd::array a;
+  a = 0.1;
+  EXPECT_EQ("0.1", format_json(a).as<std::string>());
+  a = 0.1f;
+  EXPECT_EQ("0.1", format_json(a).as<std::string>());
+  a = 1.0 / 3.0;
+  EXPECT_EQ("0.3333333333333333", format_json(a).as<std::string>());
+  a = 123.0;
+  EXPECT_EQ("123", format_json(a).as<std::string>());
+  a = -0.00025;
+  EXPECT_EQ("-0.00025", format_json(a).as<std::string>());
+  a = 6.02214076e23;
+  EXPECT_EQ("6.02214076e+23", format_json(a).as<std::string>());
+  a = 1e-7;
+  EXPECT_EQ("1e-7", format_json(a).as<std::string>());
+  a = numeric_limits<double>::max();
+  EXPECT_EQ("1.7976931348623157e+308", format_json(a).as<std::string>());
+  a = numeric_limits<double>::denorm_min();
+  EXPECT_EQ("5e-324", format_json(a).as<std::string>());
+  a = numeric_limits<float>::max();
+  EXPECT_EQ("3.4028235e+38", format_json(a).as<std::string>());
+  a = -0.0;
+  EXPECT_EQ("-0", format_json(a).as<std::string>());
+  a = numeric_limits<int64_t>::min();
+  EXPECT_EQ("-9223372036854775808", format_json(a).as<std::string>());
+  a = numeric_limits<uint64_t>::max();
+  EXPECT_EQ("18446744073709551615", format_json(a).as<std::string>());
+
+  // Every value reads back the same
+  double vals[] = {0.1, 2.2250738585072014e-308, 9007199254740993.0, 1.0 / 7.0, 1e300 / 7.0, -3.0e-300 / 7.0};
+  a = vals;
+  std::string json = format_json(a).as<std::string>();
+  nd::array b = parse_json(ndt::type("6 * float64"), json.c_str());
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_EQ(vals[i], b(i).as<double>());
+  }
+}
+
 TEST(JSONFormatter, String) {
   nd::array a;
   a = "testing string";
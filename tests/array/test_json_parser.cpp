@@ -5,13 +5,18 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <stdexcept>
 
 #include <dynd/callable.hpp>
 #include <dynd/gtest.hpp>
+#include <dynd/json_formatter.hpp>
 #include <dynd/json_parser.hpp>
+#include <dynd/json_structural_index.hpp>
 #include <dynd/parse.hpp>
+#include <dynd/type_promotion.hpp>
 #include <dynd/types/fixed_dim_type.hpp>
 #include <dynd/types/option_type.hpp>
 #include <dynd/types/string_type.hpp>
@@ -108,6 +113,77 @@ TEST(JSONParser, BuiltinsFromFloat) {
   EXPECT_EQ(1.5e2, n.as<double>());
 }
 
+template <typename T>
+T parse_decimal(const char *s) {
+  return parse<T>(s, s + strlen(s));
+}
+
+TEST(JSONParser, FloatRounding) {
+  // Halfway cases and the boundaries of the subnormals and of the finite range
+  EXPECT_EQ(0.1, parse_decimal<double>("0.1"));
+  EXPECT_EQ(9007199254740992.0, parse_decimal<double>("9007199254740993"));
+  EXPECT_EQ(9007199254740994.0, parse_decimal<double>("9007199254740993.0000000000000000001"));
+  EXPECT_EQ(9007199254740996.0, parse_decimal<double>("9007199254740995"));
+  EXPECT_EQ(2.2250738585072009e-308, parse_decimal<double>("2.2250738585072011e-308"));
+  EXPECT_EQ(numeric_limits<double>::min(), parse_decimal<double>("2.2250738585072012e-308"));
+  EXPECT_EQ(numeric_limits<double>::denorm_min(), parse_decimal<double>("4.9406564584124654e-324"));
+  EXPECT_EQ(0.0, parse_decimal<double>("2.4703282292062327e-324"));
+  EXPECT_EQ(numeric_limits<double>::denorm_min(), parse_decimal<double>("2.4703282292062328e-324"));
+  EXPECT_EQ(numeric_limits<double>::max(), parse_decimal<double>("1.7976931348623157e308"));
+  EXPECT_EQ(numeric_limits<double>::infinity(), parse_decimal<double>("1.7976931348623159e308"));
+  EXPECT_EQ(0.0, parse_decimal<double>("1e-400"));
+  EXPECT_TRUE(signbit(parse_decimal<double>("-0.0")));
+  EXPECT_EQ(1e23, parse_decimal<double>("1e23"));
+  EXPECT_EQ(1e23, parse_decimal<double>("100000000000000000000000"));
+  EXPECT_EQ(numeric_limits<double>::denorm_min(),
+            parse_decimal<double>("2.4703282292062327208828439643411068618252990130716238221279284125033775364"
+                                  "51e-324"));
+
+  EXPECT_EQ(0.1f, parse_decimal<float>("0.1"));
+  EXPECT_EQ(16777216.0f, parse_decimal<float>("16777217"));
+  EXPECT_EQ(1.0f, parse_decimal<float>("1.00000005960464477539062499"));
+  EXPECT_EQ(1.0f, parse_decimal<float>("1.000000059604644775390625"));
+  EXPECT_EQ(1.00000012f, parse_decimal<float>("1.00000005960464477539062501"));
+  EXPECT_EQ(numeric_limits<float>::min(), parse_decimal<float>("1.17549435e-38"));
+  EXPECT_EQ(numeric_limits<float>::max(), parse_decimal<float>("3.4028235e38"));
+  EXPECT_EQ(numeric_limits<float>::infinity(), parse_decimal<float>("3.5e38"));
+
+  EXPECT_EQ(1.5, parse_decimal<double>("+1.5"));
+  EXPECT_EQ(0.5, parse_decimal<double>(".5"));
+  EXPECT_EQ(5.0, parse_decimal<double>("5."));
+  EXPECT_EQ(-1.5e-3, parse_decimal<double>("-1.5E-3"));
+  EXPECT_THROW(parse_decimal<double>(""), invalid_argument);
+  EXPECT_THROW(parse_decimal<double>("."), invalid_argument);
+  EXPECT_THROW(parse_decimal<double>("1e"), invalid_argument);
+  EXPECT_THROW(parse_decimal<double>("1.5x"), invalid_argument);
+  EXPECT_THROW(parse_decimal<double>("1..5"), invalid_argument);
+  EXPECT_THROW(parse_decimal<float>("e5"), invalid_argument);
+
+  // Compare with the C library on pseudorandom values written with various
+  // numbers of digits
+  uint64_t state = 12345;
+  for (int i = 0; i < 20000; ++i) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    uint64_t bits = state;
+    double x;
+    memcpy(&x, &bits, sizeof(x));
+    if (!isfinite(x)) {
+      continue;
+    }
+
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.*e", static_cast<int>(i % 25), x);
+    const char *end = buffer + strlen(buffer);
+    EXPECT_EQ(strtod(buffer, NULL), parse<double>(buffer, end)) << buffer;
+    EXPECT_EQ(strtof(buffer, NULL), parse<float>(buffer, end)) << buffer;
+  }
+
+  nd::array n = parse_json("3 * float64", "[0.1, 2.2250738585072011e-308, 9007199254740993]");
+  EXPECT_EQ(0.1, n(0).as<double>());
+  EXPECT_EQ(2.2250738585072009e-308, n(1).as<double>());
+  EXPECT_EQ(9007199254740992.0, n(2).as<double>());
+}
+
 TEST(JSONParser, Struct) {
   nd::array n;
   ndt::type sdt = ndt::make_type<ndt::struct_type>({{ndt::make_type<int>(), "id"},
@@ -222,15 +298,206 @@ TEST(JSON, ParserWithMissingValue) {
   EXPECT_TRUE(a.p("y").is_na());
 }
 
-/*
-TEST(JSON, DiscoverBool)
-{
+TEST(JSONParser, StructuralIndex) {
+  // Runs of backslashes and strings that cross the 64 byte blocks
+  std::string json = "{\"a\": [1, {\"b\": \"x]\\\\\", \"c\\\"{[\": []}], \"";
+  json += std::string(70, '\\');
+  json += "\": [[[\"}\"], {}]], \"e\": \"";
+  json += std::string(61, 'z') + "\\\"\\\\" + std::string(5, 'z');
+  json += "\"}";
+
+  // The structural characters found one byte at a time
+  std::vector<size_t> expected;
+  bool in_string = false;
+  for (size_t i = 0; i < json.size(); ++i) {
+    char c = json[i];
+    if (in_string && c == '\\') {
+      ++i;
+    } else if (c == '"') {
+      in_string = !in_string;
+      expected.push_back(i);
+    } else if (!in_string && (c == '{' || c == '}' || c == '[' || c == ']')) {
+      expected.push_back(i);
+    }
+  }
+
+  json::structural_index index(json.data(), json.data() + json.size());
+  ASSERT_TRUE(index.is_valid());
+  ASSERT_EQ(expected.size(), index.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(json.data() + expected[i], index.get(i));
+  }
+
+  const char *begin = json.data();
+  EXPECT_EQ(begin + json.size() - 1, index.find_close(begin));
+  EXPECT_EQ(begin + 3, index.find_close(begin + 1));
+  EXPECT_EQ(NULL, index.find_close(begin + 3));
+  EXPECT_EQ(NULL, index.find_close(begin + 4));
+
+  // Whether each string has escapes, including one that crosses a block
+  bool escaped = true;
+  EXPECT_EQ(begin + 3, index.find_close(begin + 1, &escaped));
+  EXPECT_FALSE(escaped);
+  EXPECT_EQ(begin + json.size() - 2, index.find_close(begin + json.size() - 73, &escaped));
+  EXPECT_TRUE(escaped);
+  EXPECT_EQ(begin + 13, index.find_close(begin + 11, &escaped));
+  EXPECT_FALSE(escaped);
+  EXPECT_EQ(begin + 21, index.find_close(begin + 16, &escaped));
+  EXPECT_TRUE(escaped);
+  EXPECT_EQ(begin + 30, index.find_close(begin + 24, &escaped));
+  EXPECT_TRUE(escaped);
+  EXPECT_EQ(begin + 35, index.find_close(begin + 10, &escaped));
+  EXPECT_FALSE(escaped);
+
+  // Documents that are not a single valid JSON value, most of which balance
+  const char *invalid[] = {"{\"a\": [1, 2}", "[1, 2 3]", "{\"a\" 1}", "{\"a\": 1,}",
+                           "[\"\\q\", \"[\"]", "[\"\\u12g4\"]", "[1] [2]", "[tru]",
+                           "{1: 2}",         "",              "[1] x",   "[\"]\"] \\"};
+  for (const char *str : invalid) {
+    EXPECT_FALSE(json::structural_index(str, str + strlen(str)).is_valid()) << str;
+  }
+  const char *valid[] = {" [1, -2.5e3, true, false, null, {}, [], \"\\u12a4\\n\"] ", "7", "\"x\"",
+                         "{\"a\": {\"b\": []}}"};
+  for (const char *str : valid) {
+    EXPECT_TRUE(json::structural_index(str, str + strlen(str)).is_valid()) << str;
+  }
+}
+
+TEST(JSONParser, IndexedSkip) {
+  ndt::type tp("{id: int32, name: string}");
+
+  // Large enough to be parsed through a structural index, with fields that
+  // are skipped and brackets and escaped quotes inside strings
+  std::string skipped = "[";
+  for (int i = 0; i < 50; ++i) {
+    skipped += "{\"k\": [\"]}\\\"\", 1, {\"x\": null}]},";
+  }
+  skipped += "\"end\"]";
+  std::string json = "{\"skip\": " + skipped + ", \"id\": 7, \"more\": \"{[\\\"\", \"name\": \"bob\"}";
+
+  nd::array a = parse_json(tp, json.c_str());
+  EXPECT_EQ(7, a.p("id").as<int>());
+  EXPECT_EQ("bob", a.p("name").as<std::string>());
+
+  // Errors after a skipped value are still reported
+  EXPECT_THROW(parse_json(tp, json.substr(0, json.size() - 1).c_str()), invalid_argument);
+  EXPECT_THROW(parse_json(tp, ("{\"skip\": " + skipped + ", \"id\": 7 \"name\": \"bob\"}").c_str()), invalid_argument);
+
+  // Malformed JSON inside a skipped value is rejected as it is without an
+  // index, however long the document
+  std::string malformed = "{\"skip\": [1, 2 3], \"id\": 7, \"name\": \"bob\"}";
+  EXPECT_THROW(parse_json(tp, malformed.c_str()), invalid_argument);
+  EXPECT_THROW(parse_json(tp, (malformed + std::string(300, ' ')).c_str()), invalid_argument);
+  EXPECT_THROW(parse_json(tp, ("{\"skip\": [" + skipped + ", {\"a\" 1}], \"id\": 7, \"name\": \"bob\"}").c_str()),
+               invalid_argument);
+}
+
+TEST(JSONParser, NDJSON) {
+  ndt::type tp("{id: int32, name: string, tags: var * int32}");
+  std::string input = "{\"id\": 0, \"name\": \"zero\", \"tags\": []}\n"
+                      "{\"id\": 1, \"name\": \"one\", \"tags\": [1]}\r\n"
+                      "\n"
+                      "{\"id\": 2, \"name\": \"a name longer than a short string\", \"tags\": [1, 2]}\n"
+                      "{\"id\": 3, \"name\": \"three\", \"tags\": [1, 2, 3]}\n"
+                      "{\"id\": 4, \"name\": \"four\", \"tags\": [1, 2, 3, 4]}";
+
+  // Every way of splitting the input into chunks gives the same batches
+  for (size_t chunk_size = 1; chunk_size <= input.size(); chunk_size += 7) {
+    nd::json::ndjson_parser parser(tp, 2);
+    for (size_t i = 0; i < input.size(); i += chunk_size) {
+      parser.feed(input.substr(i, chunk_size));
+    }
+    parser.finish();
+    EXPECT_EQ(6, parser.get_line_count());
+
+    std::vector<nd::array> batches;
+    nd::array batch;
+    while (parser.next(batch)) {
+      batches.push_back(batch);
+    }
+    ASSERT_EQ(3u, batches.size());
+    EXPECT_EQ(ndt::make_fixed_dim(2, tp), batches[0].get_type());
+    EXPECT_EQ(ndt::make_fixed_dim(2, tp), batches[1].get_type());
+    EXPECT_EQ(ndt::make_fixed_dim(1, tp), batches[2].get_type());
+
+    for (int id = 0; id < 5; ++id) {
+      nd::array record = batches[id / 2](id % 2);
+      EXPECT_EQ(id, record.p("id").as<int>());
+      EXPECT_EQ(id, record.p("tags").get_dim_size());
+    }
+    EXPECT_EQ("one", batches[0](1).p("name").as<std::string>());
+    EXPECT_EQ("a name longer than a short string", batches[1](0).p("name").as<std::string>());
+  }
+}
+
+TEST(JSONParser, NDJSONError) {
+  nd::json::ndjson_parser parser(ndt::type("{x: int32}"), 16);
+  parser.feed("{\"x\": 1}\n{\"x\": 2}\n");
+  try {
+    parser.feed("{\"x\": \"three\"}\n");
+    FAIL() << "expected a parse error";
+  } catch (const invalid_argument &e) {
+    EXPECT_NE(std::string::npos, std::string(e.what()).find("line 3"));
+  }
+
+  EXPECT_THROW(nd::json::ndjson_parser(ndt::type("{x: int32}"), 0), invalid_argument);
+  EXPECT_THROW(nd::json::ndjson_parser(ndt::type("{x: T}"), 16), type_error);
+}
+
+TEST(JSONParser, ParallelArray) {
+  std::string json = "[";
+  for (int i = 0; i < 20000; ++i) {
+    json += i > 0 ? ",\n" : "";
+    json += "{\"id\": " + std::to_string(i) + ", \"name\": \"item, [" + std::to_string(i) + "] \\\"quoted\\\"\", ";
+    json += "\"values\": [";
+    for (int j = 0; j < i % 5; ++j) {
+      json += (j > 0 ? ", " : "") + std::to_string(i + j * 0.25);
+    }
+    json += std::string("], \"flag\": ") + (i % 3 == 0 ? "null" : "true") + "}";
+  }
+  json += "]";
+
+  eval::eval_context ectx;
+  ectx.nthreads = 4;
+  const char *types[] = {"var * {id: int32, name: string, values: var * float64, flag: ?bool}",
+                         "20000 * {id: int32, name: string, values: var * float64, flag: ?bool}"};
+  for (const char *tp_str : types) {
+    ndt::type tp(tp_str);
+    nd::array serial = parse_json(tp, json, &eval::default_eval_context);
+    nd::array parallel = parse_json(tp, json, &ectx);
+    EXPECT_EQ(serial.get_type(), parallel.get_type());
+    EXPECT_EQ(format_json(serial).as<std::string>(), format_json(parallel).as<std::string>());
+    EXPECT_EQ(12345, parallel(12345).p("id").as<int>());
+    EXPECT_EQ("item, [19999] \"quoted\"", parallel(19999).p("name").as<std::string>());
+    EXPECT_EQ(4, parallel(19999).p("values").get_dim_size());
+    EXPECT_EQ(19999.75, parallel(19999).p("values")(3).as<double>());
+  }
+
+  // An error in the middle of the array is reported like the serial parser does
+  size_t pos = json.find("{\"id\": 15000,");
+  json.replace(pos, 12, "{\"id\": true,");
+  ndt::type tp("var * {id: int32, name: string, values: var * float64, flag: ?bool}");
+  std::string serial_error, parallel_error;
+  try {
+    parse_json(tp, json, &eval::default_eval_context);
+  } catch (const invalid_argument &e) {
+    serial_error = e.what();
+  }
+  try {
+    parse_json(tp, json, &ectx);
+  } catch (const invalid_argument &e) {
+    parallel_error = e.what();
+  }
+  EXPECT_NE(std::string::npos, serial_error.find("line 15001"));
+  EXPECT_EQ(serial_error, parallel_error);
+}
+
+TEST(JSON, DiscoverBool) {
   EXPECT_EQ(ndt::make_type<bool1>(), ndt::json::discover("true"));
   EXPECT_EQ(ndt::make_type<bool1>(), ndt::json::discover("false"));
 }
 
-TEST(JSON, DiscoverInt64)
-{
+TEST(JSON, DiscoverInt64) {
   EXPECT_EQ(ndt::make_type<int64>(), ndt::json::discover("0"));
   EXPECT_EQ(ndt::make_type<int64>(), ndt::json::discover("3"));
   EXPECT_EQ(ndt::make_type<int64>(), ndt::json::discover("11"));
@@ -239,18 +506,16 @@ TEST(JSON, DiscoverInt64)
   EXPECT_EQ(ndt::make_type<int64>(), ndt::json::discover("-5"));
 }
 
-TEST(JSON, DiscoverFloat64)
-{
+TEST(JSON, DiscoverFloat64) {
   EXPECT_EQ(ndt::make_type<float64>(), ndt::json::discover("0.5"));
   EXPECT_EQ(ndt::make_type<float64>(), ndt::json::discover("3.14"));
 }
 
-TEST(JSON, DiscoverString) { EXPECT_EQ(ndt::type(string_id), ndt::json::discover("\"Hello, world!\"")); }
+TEST(JSON, DiscoverString) { EXPECT_EQ(ndt::make_type<ndt::string_type>(), ndt::json::discover("\"Hello, world!\"")); }
 
 TEST(JSON, DiscoverOption) { EXPECT_EQ(ndt::type("?Any"), ndt::json::discover("null")); }
 
-TEST(JSON, DiscoverArray)
-{
+TEST(JSON, DiscoverArray) {
   EXPECT_EQ(ndt::type("()"), ndt::json::discover("[]"));
 
   EXPECT_EQ(ndt::type("1 * int64"), ndt::json::discover("[0]"));
@@ -288,8 +553,7 @@ TEST(JSON, DiscoverArray)
   EXPECT_EQ(ndt::type("2 * var * ?int64"), ndt::json::discover("[[0, null], [2]]"));
 }
 
-TEST(JSON, DiscoverObject)
-{
+TEST(JSON, DiscoverObject) {
   EXPECT_EQ(ndt::type("{}"), ndt::json::discover("{}"));
 
   EXPECT_EQ(ndt::type("{a: int64}"), ndt::json::discover("{\"a\": 3}"));
@@ -297,4 +561,133 @@ TEST(JSON, DiscoverObject)
 
   EXPECT_EQ(ndt::type("{x: float64, y: 3 * int64}"), ndt::json::discover("{\"x\": 3.14, \"y\": [1, 2, 3]}"));
 }
-*/
+
+TEST(JSON, DiscoverMerge) {
+  EXPECT_EQ(ndt::type("2 * {a: int64, b: ?string}"), ndt::json::discover("[{\"a\": 1}, {\"a\": 2, \"b\": \"x\"}]"));
+  EXPECT_EQ(ndt::type("2 * {a: ?float64, b: ?int64}"),
+            ndt::json::discover("[{\"a\": null, \"b\": 1}, {\"a\": 2.5}]"));
+  EXPECT_EQ(ndt::type("2 * var * int64"), ndt::json::discover("[[], [1, 2]]"));
+  EXPECT_EQ(ndt::type("({a: int64}, {a: string})"), ndt::json::discover("[{\"a\": 1}, {\"a\": \"x\"}]"));
+  EXPECT_EQ(ndt::type("float64"), ndt::json::discover("12345678901234567890"));
+
+  EXPECT_EQ(ndt::type("var * ?int64"),
+            promote_types_inferred(ndt::type("3 * int64"), ndt::type("2 * ?int64")));
+  EXPECT_THROW(promote_types_inferred(ndt::type("int64"), ndt::type("string")), type_error);
+  EXPECT_THROW(ndt::json::discover("[1, 2"), invalid_argument);
+}
+
+TEST(JSON, DiscoverNullContainers) {
+  // A null or a missing field in place of an array or object makes an option
+  // of it, which parses back as NA in each of its values
+  std::string json = "[[1, 2], null]";
+  nd::array a = parse_json(ndt::json::discover(json), json.c_str());
+  EXPECT_EQ(ndt::type("2 * ?2 * int64"), a.get_type());
+  const int64_t *data = reinterpret_cast<const int64_t *>(a.cdata());
+  EXPECT_EQ(2, data[1]);
+  EXPECT_EQ(DYND_INT64_NA, data[2]);
+  EXPECT_EQ(DYND_INT64_NA, data[3]);
+
+  json = "[{\"a\": [1, 2]}, {\"b\": 2}]";
+  a = parse_json(ndt::json::discover(json), json.c_str());
+  EXPECT_EQ(ndt::type("2 * {a: ?2 * int64, b: ?int64}"), a.get_type());
+  EXPECT_EQ(2, reinterpret_cast<const int64_t *>(a(0, 0).cdata())[1]);
+  EXPECT_TRUE(a(0, 1).is_na());
+  EXPECT_EQ(DYND_INT64_NA, reinterpret_cast<const int64_t *>(a(1, 0).cdata())[1]);
+  EXPECT_EQ(2, a(1, 1).as<int64_t>());
+
+  json = "[{\"a\": {\"x\": 1}}, {\"b\": 1}]";
+  a = parse_json(ndt::json::discover(json), json.c_str());
+  EXPECT_EQ(ndt::type("2 * {a: ?{x: int64}, b: ?int64}"), a.get_type());
+  EXPECT_EQ(1, *reinterpret_cast<const int64_t *>(a(0, 0).cdata()));
+  EXPECT_EQ(DYND_INT64_NA, *reinterpret_cast<const int64_t *>(a(1, 0).cdata()));
+  EXPECT_EQ(1, a(1, 1).as<int64_t>());
+}
+
+TEST(JSON, DiscoverSample) {
+  std::string json = "[{\"a\": 1}, {\"a\": 2}, {\"a\": 3.5}, {\"a\": 4, \"b\": true}, {\"a\": null}]";
+
+  ndt::json::discover_options options;
+  options.sample_size = 2;
+  EXPECT_EQ(ndt::type("var * {a: int64}"), ndt::json::discover(json, options));
+  options.sample_size = 3;
+  EXPECT_EQ(ndt::type("var * {a: float64}"), ndt::json::discover(json, options));
+  options.sample_size = 10;
+  EXPECT_EQ(ndt::type("var * {a: ?float64, b: ?bool}"), ndt::json::discover(json, options));
+
+  // Taking the first elements does not read past them
+  options.sample_size = 2;
+  EXPECT_EQ(ndt::type("var * {a: int64}"), ndt::json::discover("[{\"a\": 1}, {\"a\": 2}, {\"a\": oops", options));
+
+  // A random sample takes every element with equal chance
+  options.random = true;
+  options.sample_size = 1;
+  bool seen_float = false, seen_bool = false;
+  for (uint32_t seed = 0; seed < 100; ++seed) {
+    options.seed = seed;
+    ndt::type tp = ndt::json::discover(json, options);
+    seen_float = seen_float || tp == ndt::type("var * {a: float64}");
+    seen_bool = seen_bool || tp == ndt::type("var * {a: int64, b: bool}");
+  }
+  EXPECT_TRUE(seen_float);
+  EXPECT_TRUE(seen_bool);
+  options.sample_size = 5;
+  EXPECT_EQ(ndt::type("var * {a: ?float64, b: ?bool}"), ndt::json::discover(json, options));
+
+  // An empty array has no element type, and is discovered as without options
+  EXPECT_EQ(ndt::json::discover("[]"), ndt::json::discover(" [ ] ", options));
+  EXPECT_EQ(ndt::type("()"), ndt::json::discover("[]", options));
+  options.random = false;
+  EXPECT_EQ(ndt::type("()"), ndt::json::discover("[]", options));
+}
+
+TEST(JSON, DiscoverNDJSON) {
+  std::string input = "{\"id\": 0, \"tags\": []}\n"
+                      "{\"id\": 1, \"tags\": [1]}\r\n"
+                      "\n"
+                      "{\"id\": 2, \"name\": \"two\", \"tags\": [1, 2]}\n"
+                      "{\"id\": 3.5, \"tags\": [1, 2, 3]}";
+
+  for (size_t chunk_size = 1; chunk_size <= input.size(); chunk_size += 5) {
+    ndt::json::ndjson_discoverer discoverer;
+    for (size_t i = 0; i < input.size(); i += chunk_size) {
+      discoverer.feed(input.substr(i, chunk_size));
+    }
+    discoverer.finish();
+    EXPECT_EQ(ndt::type("{id: float64, tags: var * int64, name: ?string}"), discoverer.get_type());
+    EXPECT_EQ(4, discoverer.get_record_count());
+  }
+
+  // The types of separately discovered chunks merge the same way
+  size_t split = input.find('\n', input.find('\n') + 1) + 1;
+  ndt::json::ndjson_discoverer first, second;
+  first.feed(input.substr(0, split));
+  first.finish();
+  second.feed(input.substr(split));
+  second.finish();
+  EXPECT_EQ(ndt::type("{id: float64, tags: var * int64, name: ?string}"),
+            promote_types_inferred(first.get_type(), second.get_type()));
+
+  ndt::json::discover_options options;
+  options.sample_size = 2;
+  ndt::json::ndjson_discoverer sampled(options);
+  sampled.feed(input.substr(0, 50));
+  EXPECT_TRUE(sampled.is_done());
+  sampled.feed("not json\n");
+  sampled.finish();
+  EXPECT_EQ(ndt::type("{id: int64, tags: var * int64}"), sampled.get_type());
+
+  options.random = true;
+  options.sample_size = 10;
+  ndt::json::ndjson_discoverer random_sampled(options);
+  random_sampled.feed(input);
+  random_sampled.finish();
+  EXPECT_EQ(ndt::type("{id: float64, tags: var * int64, name: ?string}"), random_sampled.get_type());
+
+  ndt::json::ndjson_discoverer bad;
+  try {
+    bad.feed("{\"x\": 1}\n{\"x\": }\n");
+    FAIL() << "expected an error";
+  } catch (const invalid_argument &e) {
+    EXPECT_NE(std::string::npos, std::string(e.what()).find("line 2"));
+  }
+}
@@ -5,19 +5,172 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <stdexcept>
 
+#include <dynd/arithmetic.hpp>
 #include <dynd/array.hpp>
 #include <dynd/gtest.hpp>
 #include <dynd/types/bytes_type.hpp>
 #include <dynd/types/callable_type.hpp>
 #include <dynd/types/string_type.hpp>
 
+#ifdef WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
 using namespace std;
 using namespace dynd;
 
+namespace {
+
+void write_ints(const char *fn, const vector<int32_t> &values) {
+  ofstream fout(fn, ios::binary);
+  fout.write(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(int32_t));
+}
+
+vector<int32_t> read_ints(const char *fn) {
+  ifstream fin(fn, ios::binary);
+  vector<int32_t> values;
+  int32_t value;
+  while (fin.read(reinterpret_cast<char *>(&value), sizeof(value))) {
+    values.push_back(value);
+  }
+  return values;
+}
+
+/**
+ * A file in the temporary directory, which is removed when this goes out of
+ * scope.
+ */
+class temp_file {
+  std::string m_path;
+
+public:
+  temp_file() {
+#ifdef WIN32
+    char dir[MAX_PATH], path[MAX_PATH];
+    if (GetTempPathA(MAX_PATH, dir) == 0 || GetTempFileNameA(dir, "dyn", 0, path) == 0) {
+      throw runtime_error("failed to create a temporary file");
+    }
+    m_path = path;
+#else
+    const char *dir = getenv("TMPDIR");
+    std::string path = std::string(dir != NULL ? dir : "/tmp") + "/test_memmap_XXXXXX";
+    int fd = mkstemp(&path[0]);
+    if (fd == -1) {
+      throw runtime_error("failed to create a temporary file");
+    }
+    close(fd);
+    m_path = path;
+#endif
+  }
+
+  temp_file(const temp_file &) = delete;
+  temp_file &operator=(const temp_file &) = delete;
+
+  ~temp_file() {
+#ifdef WIN32
+    _unlink(m_path.c_str());
+#else
+    unlink(m_path.c_str());
+#endif
+  }
+
+  const char *c_str() const { return m_path.c_str(); }
+};
+
+} // anonymous namespace
+
+TEST(ArrayMemMap, Typed) {
+  vector<int32_t> values(1000);
+  for (int i = 0; i < 1000; ++i) {
+    values[i] = 3 * i;
+  }
+  temp_file fn;
+  write_ints(fn.c_str(), values);
+
+  {
+    nd::array a = nd::memmap(fn.c_str(), ndt::type("Fixed * int32"));
+    EXPECT_EQ(ndt::make_type<int32_t[1000]>(), a.get_type());
+    EXPECT_EQ(nd::read_access_flag, a.get_flags() & nd::readwrite_access_flags);
+    EXPECT_EQ(0, a(0).as<int32_t>());
+    EXPECT_EQ(2997, a(999).as<int32_t>());
+    EXPECT_EQ(3 * 999 * 1000 / 2, nd::sum(a).as<int32_t>());
+
+    // A fixed size from an offset, with a hint
+    a = nd::memmap(fn.c_str(), ndt::type("10 * 2 * int32"), 40, nd::memmap_readonly,
+                   nd::memmap_advice_sequential);
+    EXPECT_EQ(ndt::type("10 * 2 * int32"), a.get_type());
+    EXPECT_EQ(30, a(0, 0).as<int32_t>());
+    EXPECT_EQ(87, a(9, 1).as<int32_t>());
+
+    // A struct per record
+    a = nd::memmap(fn.c_str(), ndt::type("Fixed * {x: int32, y: int32}"), 0, nd::memmap_readonly,
+                   nd::memmap_advice_random);
+    EXPECT_EQ(500, a.get_dim_size());
+    EXPECT_EQ(6, a(1, 0).as<int32_t>());
+    EXPECT_EQ(2997, a(499, 1).as<int32_t>());
+  }
+
+  {
+    // Writes to a private copy leave the file as it was
+    nd::array a = nd::memmap(fn.c_str(), ndt::type("Fixed * int32"), 0, nd::memmap_copy_on_write);
+    a(5).vals() = -1;
+    EXPECT_EQ(-1, a(5).as<int32_t>());
+  }
+  EXPECT_EQ(values, read_ints(fn.c_str()));
+
+  {
+    nd::array a = nd::memmap(fn.c_str(), ndt::type("Fixed * int32"), 0, nd::memmap_readwrite);
+    a(5).vals() = -1;
+  }
+  values[5] = -1;
+  EXPECT_EQ(values, read_ints(fn.c_str()));
+
+}
+
+TEST(ArrayMemMap, Errors) {
+  temp_file fn;
+  write_ints(fn.c_str(), vector<int32_t>(10));
+
+  EXPECT_THROW(nd::memmap(fn.c_str(), ndt::type("11 * int32")), runtime_error);
+  EXPECT_THROW(nd::memmap(fn.c_str(), ndt::type("Fixed * int32"), 2), invalid_argument);
+  EXPECT_THROW(nd::memmap(fn.c_str(), ndt::type("Fixed * string")), invalid_argument);
+  EXPECT_THROW(nd::memmap(fn.c_str(), ndt::type("var * int32")), invalid_argument);
+  EXPECT_THROW(nd::memmap(std::string(fn.c_str()) + ".missing", ndt::type("Fixed * int32")), runtime_error);
+
+  nd::array a = nd::memmap(fn.c_str(), ndt::type("Fixed * int32"), 40);
+  EXPECT_EQ(0, a.get_dim_size());
+
+}
+
+TEST(ArrayMemMap, Bytes) {
+  temp_file fn;
+  {
+    ofstream fout(fn.c_str(), ios::binary);
+    fout << "This is a test.";
+  }
+
+  nd::array a = nd::memmap(fn.c_str(), 5, -1);
+  EXPECT_EQ(ndt::make_type<uint8_t[9]>(), a.get_type());
+  EXPECT_EQ('i', a(0).as<int>());
+  EXPECT_EQ('t', a(8).as<int>());
+
+  // No access flags means the default ones
+  a = nd::memmap(fn.c_str(), 0, 4, 0);
+  EXPECT_EQ(nd::default_access_flags, a.get_flags() & nd::readwrite_access_flags);
+  EXPECT_EQ('T', a(0).as<int>());
+
+}
+
 /*
 
 static void write_string_file(const char *fn,
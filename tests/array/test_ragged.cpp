@@ -0,0 +1,90 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+
+#include <dynd/arithmetic.hpp>
+#include <dynd/gtest.hpp>
+#include <dynd/json_parser.hpp>
+#include <dynd/ragged.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(Ragged, MakeRagged) {
+  nd::array values = {1, 2, 3, 4, 5, 6};
+  nd::array a = nd::make_ragged(nd::array{0, 3, 3, 4, 6}, values);
+  EXPECT_EQ(ndt::type("4 * var * int32"), a.get_type());
+  EXPECT_EQ(3, a(0).get_dim_size());
+  EXPECT_EQ(0, a(1).get_dim_size());
+  EXPECT_EQ(4, a(2, 0).as<int>());
+  EXPECT_EQ(6, a(3, 1).as<int>());
+
+  // The rows are a view of the values
+  EXPECT_TRUE(nd::is_packed_ragged(a));
+  EXPECT_EQ(values.cdata(), nd::ragged_values(a).cdata());
+  EXPECT_ARRAY_EQ(values, nd::ragged_values(a));
+  EXPECT_ARRAY_EQ((nd::array{0LL, 3LL, 3LL, 4LL, 6LL}), nd::ragged_offsets(a));
+
+  // The offsets may start after the first value
+  a = nd::make_ragged(nd::array{2, 3, 5}, values);
+  EXPECT_EQ(1, a(0).get_dim_size());
+  EXPECT_EQ(3, a(0, 0).as<int>());
+  EXPECT_EQ(5, a(1, 1).as<int>());
+  EXPECT_ARRAY_EQ((nd::array{3, 4, 5}), nd::ragged_values(a));
+  EXPECT_ARRAY_EQ((nd::array{0LL, 1LL, 3LL}), nd::ragged_offsets(a));
+
+  EXPECT_THROW(nd::make_ragged(nd::array{0, 3, 2}, values), invalid_argument);
+  EXPECT_THROW(nd::make_ragged(nd::array{0, 7}, values), invalid_argument);
+  EXPECT_THROW(nd::make_ragged(nd::array{-1, 2}, values), invalid_argument);
+
+  // The view is only as writable as the values
+  nd::array frozen = values.eval_copy(nd::read_access_flag | nd::immutable_access_flag);
+  EXPECT_EQ(0u, frozen.get_flags() & nd::write_access_flag);
+  EXPECT_EQ(frozen.get_flags(), nd::make_ragged(nd::array{0, 6}, frozen).get_flags());
+  EXPECT_EQ(values.get_flags(), nd::make_ragged(nd::array{0, 6}, values).get_flags());
+}
+
+TEST(Ragged, Pack) {
+  nd::array a = parse_json("3 * var * int32", "[[1, 2], [3], [4, 5, 6]]");
+  EXPECT_TRUE(nd::is_packed_ragged(a));
+  EXPECT_EQ(a.get(), nd::pack_ragged(a).get());
+
+  // Rows allocated out of order are not packed
+  nd::array b = nd::empty("3 * var * int32");
+  b(0).vals() = nd::array{1, 2};
+  b(2).vals() = nd::array{4, 5, 6};
+  b(1).vals() = nd::array{3};
+  EXPECT_FALSE(nd::is_packed_ragged(b));
+  EXPECT_THROW(nd::ragged_offsets(b), invalid_argument);
+
+  nd::array c = nd::pack_ragged(b);
+  EXPECT_TRUE(nd::is_packed_ragged(c));
+  EXPECT_ARRAY_EQ((nd::array{1, 2, 3, 4, 5, 6}), nd::ragged_values(c));
+  EXPECT_ARRAY_EQ((nd::array{0LL, 2LL, 3LL, 6LL}), nd::ragged_offsets(c));
+}
+
+TEST(Ragged, Elwise) {
+  nd::array a = nd::make_ragged(nd::array{0, 2, 2, 5}, nd::array{1, 2, 3, 4, 5});
+  nd::array b = parse_json("3 * var * int32", "[[10, 20], [], [30, 40, 50]]");
+
+  nd::array c = a + b;
+  EXPECT_TRUE(nd::is_packed_ragged(c));
+  EXPECT_ARRAY_EQ((nd::array{11, 22, 33, 44, 55}), nd::ragged_values(c));
+  EXPECT_ARRAY_EQ((nd::array{0LL, 2LL, 2LL, 5LL}), nd::ragged_offsets(c));
+
+  // Broadcasting a row of one element
+  c = a + parse_json("3 * var * int32", "[[1], [], [2]]");
+  EXPECT_ARRAY_EQ((nd::array{2, 3, 5, 6, 7}), nd::ragged_values(c));
+
+  c = a + parse_json("3 * 1 * int32", "[[1], [2], [3]]");
+  EXPECT_ARRAY_EQ((nd::array{2, 3, 6, 7, 8}), nd::ragged_values(c));
+}
+
+TEST(Ragged, Sum) {
+  nd::array a = nd::make_ragged(nd::array{0, 2, 2, 5}, nd::array{1, 2, 3, 4, 5});
+  EXPECT_ARRAY_EQ(15, nd::sum(a));
+}
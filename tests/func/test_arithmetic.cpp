@@ -257,6 +257,51 @@ TEST(Arithmetic, Minus) {
   EXPECT_ARRAY_EQ(nd::array({-0.0, -1.0, -2.0, -3.0, -4.0}), -a);
 }
 
+TEST(Arithmetic, SIMDContiguous) {
+  // A size that is not a multiple of any vector width
+  std::vector<int> x(37), y(37);
+  std::vector<double> u(37), v(37);
+  for (int i = 0; i < 37; ++i) {
+    x[i] = 3 * i - 50;
+    y[i] = i + 1;
+    u[i] = 0.5 * i - 4.0;
+    v[i] = i + 0.25;
+  }
+  nd::array a = x, b = y, c = u, d = v;
+
+  nd::array res = a + b, res2 = a - 7, res3 = 7 * b, res4 = c / d, res5 = c * 2.5;
+  nd::array res6 = a(irange().by(2)) * b(irange().by(2));
+  for (int i = 0; i < 37; ++i) {
+    EXPECT_EQ(x[i] + y[i], res(i).as<int>());
+    EXPECT_EQ(x[i] - 7, res2(i).as<int>());
+    EXPECT_EQ(7 * y[i], res3(i).as<int>());
+    EXPECT_EQ(u[i] / v[i], res4(i).as<double>());
+    EXPECT_EQ(u[i] * 2.5, res5(i).as<double>());
+  }
+  for (int i = 0; i < 19; ++i) {
+    EXPECT_EQ(x[2 * i] * y[2 * i], res6(i).as<int>());
+  }
+
+  // Integer division has no vector loop, and still checks for zero
+  b(5).vals() = 0;
+  EXPECT_THROW(a / b, zero_division_error);
+}
+
+TEST(Arithmetic, SIMDBroadcastBoth) {
+  // Both sources broadcast into a wider destination
+  nd::array dst = nd::empty(ndt::type("16 * int32"));
+  nd::add({nd::array{1}, nd::array{2}}, {{"dst", dst}});
+  for (int i = 0; i < 16; ++i) {
+    EXPECT_EQ(3, dst(i).as<int>());
+  }
+
+  nd::array dst2 = nd::empty(ndt::type("13 * float64"));
+  nd::multiply({nd::array{1.5}, nd::array{4.0}}, {{"dst", dst2}});
+  for (int i = 0; i < 13; ++i) {
+    EXPECT_EQ(6.0, dst2(i).as<double>());
+  }
+}
+
 /*
 TEST(Arithmetic, CompoundDiv)
 {
@@ -15,6 +15,7 @@
 #include <dynd/gtest.hpp>
 #include <dynd/index.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/prepared_kernel.hpp>
 #include <dynd/types/fixed_string_type.hpp>
 
 using namespace std;
@@ -147,6 +148,76 @@ TEST(Callable, KeywordParsing) {
   EXPECT_THROW(af0({1}, {{"y", 4}, {"y", 2.5}}).as<int>(), std::invalid_argument);
 }
 
+TEST(Callable, ResolveCache) {
+  nd::callable f = nd::functional::apply([](int x, int y) { return x + y; }, "y");
+  nd::resolve_cache &cache = f->get_resolve_cache();
+
+  EXPECT_EQ(5, f({1}, {{"y", 4}}).as<int>());
+  EXPECT_EQ(1u, cache.get_miss_count());
+  EXPECT_EQ(0u, cache.get_hit_count());
+
+  EXPECT_EQ(6, f({2}, {{"y", 4}}).as<int>());
+  EXPECT_EQ(7, f({3}, {{"y", 4}}).as<int>());
+  EXPECT_EQ(1u, cache.get_miss_count());
+  EXPECT_EQ(2u, cache.get_hit_count());
+
+  // A different keyword value is a different signature
+  EXPECT_EQ(6, f({1}, {{"y", 5}}).as<int>());
+  EXPECT_EQ(2u, cache.get_miss_count());
+  EXPECT_EQ(2u, cache.size());
+
+  // Overloading any callable invalidates what was resolved through it
+  nd::resolve_cache::invalidate_all();
+  EXPECT_EQ(5, f({1}, {{"y", 4}}).as<int>());
+  EXPECT_EQ(3u, cache.get_miss_count());
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_EQ(5, f({1}, {{"y", 4}}).as<int>());
+  EXPECT_EQ(3u, cache.get_miss_count());
+
+  EXPECT_EQ(6, f({1}, {{"y", 5}}).as<int>());
+  cache.set_capacity(1);
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_EQ(5, f({1}, {{"y", 4}}).as<int>());
+  EXPECT_EQ(5u, cache.get_miss_count());
+
+  cache.set_capacity(0);
+  cache.reset_counts();
+  EXPECT_EQ(5, f({1}, {{"y", 4}}).as<int>());
+  EXPECT_EQ(0u, cache.size());
+  EXPECT_EQ(0u, cache.get_hit_count());
+  EXPECT_EQ(0u, cache.get_miss_count());
+}
+
+TEST(Callable, PreparedKernel) {
+  nd::callable f = nd::functional::apply([](int x, int y) { return x * y; }, "y");
+
+  nd::array dst = nd::empty(ndt::make_type<int>());
+  nd::array src = nd::empty(ndt::make_type<int>());
+  nd::prepared_kernel pk(f, dst, {src}, kernel_request_single, {{"y", 3}});
+  EXPECT_EQ(ndt::make_type<int>(), pk.get_dst_type());
+
+  int res;
+  for (int x = 0; x < 5; ++x) {
+    char *src_data = reinterpret_cast<char *>(&x);
+    pk.single(reinterpret_cast<char *>(&res), &src_data);
+    EXPECT_EQ(3 * x, res);
+  }
+
+  int xs[4] = {1, 2, 3, 4}, ys[4];
+  nd::prepared_kernel spk(f, dst, {src}, kernel_request_strided, {{"y", -2}});
+  char *src_data = reinterpret_cast<char *>(xs);
+  intptr_t src_stride = sizeof(int);
+  spk.strided(reinterpret_cast<char *>(ys), sizeof(int), &src_data, &src_stride, 4);
+  EXPECT_EQ(-2, ys[0]);
+  EXPECT_EQ(-8, ys[3]);
+
+  // Missing keyword, mismatched destination type and unsupported request
+  EXPECT_THROW(nd::prepared_kernel(f, dst, {src}), invalid_argument);
+  EXPECT_THROW(nd::prepared_kernel(f, nd::empty(ndt::make_type<double>()), {src}, kernel_request_single, {{"y", 3}}),
+               invalid_argument);
+  EXPECT_THROW(nd::prepared_kernel(f, dst, {src}, kernel_request_call, {{"y", 3}}), invalid_argument);
+}
+
 TEST(Callable, Assignment_CallInterface) {
   // Test with the unary operation prototype
   nd::callable af = nd::assign.specialize(ndt::make_type<int>(), {ndt::make_type<ndt::string_type>()});
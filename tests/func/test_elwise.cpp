@@ -8,6 +8,8 @@
 #include <iostream>
 #include <stdexcept>
 
+#include "../test_eval_context.hpp"
+
 #include <dynd/array.hpp>
 #include <dynd/assignment.hpp>
 #include <dynd/callable.hpp>
@@ -218,6 +220,93 @@ TEST(Elwise, Binary_FixedDim) {
   EXPECT_ARRAY_EQ((nd::array{3, 5, 7}), f({{0, 1, 2}, {3, 4, 5}}, {}));
 }
 
+TEST(Elwise, Parallel) {
+  nd::callable f = nd::functional::elwise(nd::functional::apply([](int x, int y) { return 2 * x + y; }));
+
+  std::vector<int> x(1000), y(1000);
+  for (int i = 0; i < 1000; ++i) {
+    x[i] = i;
+    y[i] = -3 * i;
+  }
+  nd::array a = x, b = y;
+  nd::array c = nd::empty(ndt::make_type<int[50][20]>());
+  for (int i = 0; i < 1000; ++i) {
+    c(i / 20, i % 20).vals() = i;
+  }
+
+  nd::array res, res2, res3;
+  {
+    eval_context_guard guard(4, 16);
+    res = f(a, b);
+    res2 = f(c, c);
+    res3 = f(c, 1);
+  }
+
+  ASSERT_EQ(ndt::make_type<int[1000]>(), res.get_type());
+  ASSERT_EQ(ndt::make_type<int[50][20]>(), res2.get_type());
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(-i, res(i).as<int>());
+    EXPECT_EQ(3 * i, res2(i / 20, i % 20).as<int>());
+    EXPECT_EQ(2 * i + 1, res3(i / 20, i % 20).as<int>());
+  }
+}
+
+TEST(Elwise, Coalesce) {
+  static int nstrided;
+  struct kernel : nd::base_strided_kernel<kernel, 2> {
+    void single(char *res, char *const *args) {
+      *reinterpret_cast<int *>(res) = 2 * *reinterpret_cast<int *>(args[0]) + *reinterpret_cast<int *>(args[1]);
+    }
+
+    void strided(char *res, intptr_t res_stride, char *const *args, const intptr_t *args_stride, size_t size) {
+      ++nstrided;
+      nd::base_strided_kernel<kernel, 2>::strided(res, res_stride, args, args_stride, size);
+    }
+  };
+
+  nd::callable f = nd::functional::elwise(nd::make_callable<kernel>(ndt::make_type<int(int, int)>()));
+
+  nd::array a = nd::empty(ndt::make_type<int[4][5][6]>());
+  nd::array b = nd::empty(ndt::make_type<int[6]>());
+  for (int i = 0; i < 120; ++i) {
+    a(i / 30, i / 6 % 5, i % 6).vals() = i;
+  }
+  for (int i = 0; i < 6; ++i) {
+    b(i).vals() = -i;
+  }
+
+  // Contiguous dimensions are run as one
+  nstrided = 0;
+  nd::array res = f(a, a);
+  EXPECT_EQ(1, nstrided);
+  for (int i = 0; i < 120; ++i) {
+    EXPECT_EQ(3 * i, res(i / 30, i / 6 % 5, i % 6).as<int>());
+  }
+
+  // A missing leading dimension still coalesces with the outer ones
+  nstrided = 0;
+  res = f(b, a);
+  EXPECT_EQ(20, nstrided);
+  for (int i = 0; i < 120; ++i) {
+    EXPECT_EQ(i - 2 * (i % 6), res(i / 30, i / 6 % 5, i % 6).as<int>());
+  }
+
+  // A transposed argument
+  nd::array t = a.rotate();
+  res = f(t, 1);
+  ASSERT_EQ(ndt::make_type<int[5][6][4]>(), res.get_type());
+  for (int i = 0; i < 120; ++i) {
+    EXPECT_EQ(2 * i + 1, res(i / 6 % 5, i % 6, i / 30).as<int>());
+  }
+
+  // A reversed argument
+  nd::array r = a(irange().by(-1), irange(), irange().by(-1));
+  res = f(r, a);
+  for (int i = 0; i < 120; ++i) {
+    EXPECT_EQ(2 * ((3 - i / 30) * 30 + i / 6 % 5 * 6 + 5 - i % 6) + i, res(i / 30, i / 6 % 5, i % 6).as<int>());
+  }
+}
+
 /*
 // TODO Reenable once there's a convenient way to make the binary callable
 TEST(LiftCallable, Expr_MultiDimVarToVarDim) {
@@ -0,0 +1,106 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+#include <dynd/arithmetic.hpp>
+#include <dynd/array.hpp>
+#include <dynd/gtest.hpp>
+#include <dynd/lazy.hpp>
+#include <dynd/math.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(Lazy, Arithmetic) {
+  std::vector<double> x(1000), y(1000), z(1000);
+  for (int i = 0; i < 1000; ++i) {
+    x[i] = i;
+    y[i] = 0.5 * i;
+    z[i] = -i - 1;
+  }
+  nd::array a = x, b = y, c = z;
+
+  nd::array res = (nd::lazy::expr(a) * b + c).eval();
+  EXPECT_ARRAY_EQ(a * b + c, res);
+
+  res = (nd::lazy::expr(a) - b / c * 3.0 + 1).eval();
+  EXPECT_ARRAY_EQ(a - b / c * 3.0 + 1, res);
+
+  nd::array d = {1, 12, -23, 34};
+  EXPECT_ARRAY_EQ(-d % 7 + d, (-nd::lazy::expr(d) % 7 + d).eval());
+}
+
+TEST(Lazy, Broadcast) {
+  nd::array a = {{1, 2, 3}, {4, 5, 6}};
+  nd::array b = {10, 20, 30};
+
+  nd::array res = (nd::lazy::expr(a) * b + 2).eval();
+  EXPECT_EQ(ndt::make_type<int[2][3]>(), res.get_type());
+  EXPECT_ARRAY_EQ(a * b + 2, res);
+
+  // Promotion happens within the fused kernel
+  res = (nd::lazy::expr(a) * 0.5 + b).eval();
+  EXPECT_ARRAY_EQ(a * 0.5 + b, res);
+}
+
+TEST(Lazy, Shared) {
+  nd::array a = {1.0, 2.0, 3.0, 4.0};
+  nd::array b = {0.5, 1.5, 2.5, 3.5};
+
+  nd::lazy::expr t = nd::lazy::expr(a) * b;
+  EXPECT_ARRAY_EQ(a * b + a * b * a, (t + t * a).eval());
+
+  // An array used twice is read as one source
+  nd::lazy::expr u = nd::lazy::expr(a) + a;
+  EXPECT_ARRAY_EQ(a + a - b, (u - b).eval());
+}
+
+TEST(Lazy, Comparison) {
+  nd::array a = {1, 5, 3, 7};
+  nd::array b = {2, 4, 3, 8};
+
+  nd::array res = (nd::lazy::expr(a) + 1 < b * 2).eval();
+  EXPECT_EQ(ndt::make_type<bool1[4]>(), res.get_type());
+  EXPECT_ARRAY_EQ(a + 1 < b * 2, res);
+
+  res = ((nd::lazy::expr(a) < b) && (nd::lazy::expr(b) > 2)).eval();
+  EXPECT_ARRAY_EQ((a < b) && (b > 2), res);
+}
+
+TEST(Lazy, Math) {
+  nd::array a = {0.25, 1.0, 4.0, 9.0};
+
+  nd::array res = (nd::lazy::sqrt(a) * 2.0 + nd::lazy::exp(nd::lazy::expr(a) - 1.0)).eval();
+  EXPECT_ARRAY_EQ(nd::sqrt(a) * 2.0 + nd::exp(a - 1.0), res);
+
+  res = nd::lazy::pow(nd::lazy::expr(a) + 1.0, 2.0).eval();
+  EXPECT_ARRAY_EQ(nd::pow(a + 1.0, 2.0), res);
+}
+
+TEST(Lazy, ManySources) {
+  nd::array a[9];
+  for (int i = 0; i < 9; ++i) {
+    a[i] = {i, i + 1, i + 2};
+  }
+
+  // More arrays than one kernel takes are evaluated one call at a time
+  nd::lazy::expr e = a[0];
+  nd::array expected = a[0];
+  for (int i = 1; i < 9; ++i) {
+    e = e + a[i];
+    expected = expected + a[i];
+  }
+  EXPECT_ARRAY_EQ(expected, e.eval());
+}
+
+TEST(Lazy, Leaf) {
+  nd::array a = {1, 2, 3};
+  EXPECT_ARRAY_EQ(a, nd::lazy::expr(a).eval());
+  EXPECT_ARRAY_EQ(a + 1, (nd::lazy::expr(a) + 1).eval());
+  EXPECT_THROW(nd::lazy::expr(nd::add, {a}), invalid_argument);
+}
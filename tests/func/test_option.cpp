@@ -57,3 +57,24 @@ TEST(Option, AssignNAArray) {
   nd::array expected = {true, false, false};
   EXPECT_ARRAY_EQ(nd::is_na(a), expected);
 }
+
+TEST(Option, ForwardNA) {
+  // Long enough to cover whole words which are all missing or all available
+  std::string json = "[";
+  for (int i = 0; i < 200; ++i) {
+    if (i != 0) {
+      json += ", ";
+    }
+    json += (i % 5 == 0 || (i >= 64 && i < 128)) ? "null" : to_string(i);
+  }
+  json += "]";
+
+  nd::array a = parse_json(ndt::type("200 * ?int32"), json.c_str());
+  nd::array b = a + 1;
+  EXPECT_ARRAY_EQ(nd::is_na(a), nd::is_na(b));
+  for (int i = 0; i < 200; ++i) {
+    if (!(i % 5 == 0 || (i >= 64 && i < 128))) {
+      EXPECT_EQ(i + 1, b(i).as<int>());
+    }
+  }
+}
@@ -8,8 +8,12 @@
 #include <iostream>
 #include <stdexcept>
 
+#include "../test_eval_context.hpp"
+
+#include <dynd/arithmetic.hpp>
 #include <dynd/functional.hpp>
 #include <dynd/gtest.hpp>
+#include <dynd/statistics.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -182,6 +186,60 @@ TEST(Reduction, BuiltinSum_Lift3D_StridedStridedStrided_ReduceBroadcastReduce) {
                                              {{"axes", {0, 2}}}));
 }
 
+TEST(Reduction, Parallel) {
+  nd::callable f = nd::functional::reduction([] { return 0; }, [](const return_wrapper<int> &res, int x) { res += x; });
+
+  nd::array a = nd::empty(ndt::make_type<int[1000]>());
+  nd::array b = nd::empty(ndt::make_type<int[100][10]>());
+  for (int i = 0; i < 1000; ++i) {
+    a(i).vals() = (i * 37) % 101 - 50;
+    b(i / 10, i % 10).vals() = (i * 37) % 101 - 50;
+  }
+
+  std::vector<nd::array> serial{f(a),
+                                f(b),
+                                f({b}, {{"keepdims", true}}),
+                                f({b}, {{"axes", {1}}}),
+                                f({b}, {{"axes", {0}}}),
+                                nd::max(a),
+                                nd::min(b)};
+
+  std::vector<nd::array> parallel;
+  {
+    eval_context_guard guard(4, 16);
+    parallel = {f(a), f(b), f({b}, {{"keepdims", true}}), f({b}, {{"axes", {1}}}), f({b}, {{"axes", {0}}}),
+                nd::max(a), nd::min(b)};
+  }
+
+  for (size_t i = 0; i < serial.size(); ++i) {
+    EXPECT_ARRAY_EQ(serial[i], parallel[i]);
+  }
+}
+
+TEST(Reduction, ParallelFloat) {
+  // Values of very different magnitudes, whose floating point sum depends
+  // on the order they are added in
+  nd::array a = nd::empty(ndt::make_type<double[5000]>());
+  nd::array b = nd::empty(ndt::make_type<double[500][10]>());
+  for (int i = 0; i < 5000; ++i) {
+    double value = ((i * 7919) % 13 - 6) * std::pow(10.0, (i * 31) % 17 - 8);
+    a(i).vals() = value;
+    b(i / 10, i % 10).vals() = value;
+  }
+
+  double serial_sum = nd::sum(a).as<double>();
+  eval_context_guard guard(4, 16);
+  double sum = nd::sum(a).as<double>();
+  double sum2 = nd::sum(b).as<double>();
+  EXPECT_NEAR(serial_sum, sum, 1e-6 * std::abs(serial_sum));
+  EXPECT_NEAR(serial_sum, sum2, 1e-6 * std::abs(serial_sum));
+  for (int i = 0; i < 20; ++i) {
+    // The partials are combined in the same order on every run
+    EXPECT_EQ(sum, nd::sum(a).as<double>());
+    EXPECT_EQ(sum2, nd::sum(b).as<double>());
+  }
+}
+
 TEST(Reduction, Except) {
   // Cannot have a null child
   EXPECT_THROW(nd::functional::reduction([] { return 0; }, nd::callable()), invalid_argument);
@@ -6,10 +6,14 @@
 #include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <limits>
 #include <stdexcept>
 
+#include "../test_eval_context.hpp"
+
 #include <dynd/gtest.hpp>
 #include <dynd/sort.hpp>
+#include <dynd/types/string_type.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -24,11 +28,252 @@ TEST(Sort, 1D) {
   EXPECT_ARRAY_EQ((nd::array{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19}), a);
 }
 
-/*
-TEST(Unique, 1D)
-{
-  nd::array a{0, 0, 1, 2, 2, 3};
-  nd::unique(a);
-  EXPECT_ARRAY_EQ((nd::array{0, 1, 2, 3}), a);
+TEST(Sort, Radix) {
+  std::vector<int64_t> x(5000);
+  for (size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<int64_t>((i * 2654435761u) % 10007) - 5000;
+  }
+  x[17] = std::numeric_limits<int64_t>::min();
+  x[42] = std::numeric_limits<int64_t>::max();
+
+  nd::array a = x;
+  nd::sort(a);
+  std::sort(x.begin(), x.end());
+  EXPECT_ARRAY_EQ(nd::array(x), a);
+
+  nd::array b{uint8_t(200), uint8_t(3), uint8_t(255), uint8_t(0), uint8_t(3)};
+  nd::sort(b);
+  EXPECT_ARRAY_EQ((nd::array{uint8_t(0), uint8_t(3), uint8_t(3), uint8_t(200), uint8_t(255)}), b);
+
+  nd::array c{true, false, true, false};
+  nd::sort(c);
+  EXPECT_ARRAY_EQ((nd::array{false, false, true, true}), c);
+}
+
+TEST(Sort, Float) {
+  double nan = std::numeric_limits<double>::quiet_NaN();
+  double inf = std::numeric_limits<double>::infinity();
+  nd::array a{2.5, nan, -inf, -0.5, inf, -nan, 0.0, -3.0};
+  nd::sort(a);
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_FALSE(std::isnan(a(i).as<double>()));
+  }
+  EXPECT_EQ(-inf, a(0).as<double>());
+  EXPECT_EQ(-3.0, a(1).as<double>());
+  EXPECT_EQ(-0.5, a(2).as<double>());
+  EXPECT_EQ(0.0, a(3).as<double>());
+  EXPECT_EQ(2.5, a(4).as<double>());
+  EXPECT_EQ(inf, a(5).as<double>());
+  // NaNs sort last
+  EXPECT_TRUE(std::isnan(a(6).as<double>()));
+  EXPECT_TRUE(std::isnan(a(7).as<double>()));
+
+  std::vector<float> x(1000);
+  for (size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<float>((i * 7919) % 1000) * 0.25f - 100.0f;
+  }
+  nd::array b = x;
+  nd::sort(b);
+  std::sort(x.begin(), x.end());
+  EXPECT_ARRAY_EQ(nd::array(x), b);
+}
+
+TEST(Sort, Strided) {
+  nd::array a{9, 0, 7, 1, 5, 2, 3, 3, 1, 4};
+  nd::array b = a(irange().by(2));
+  nd::sort(b);
+  EXPECT_ARRAY_EQ((nd::array{1, 0, 3, 1, 5, 2, 7, 3, 9, 4}), a);
+}
+
+TEST(Sort, Parallel) {
+  std::vector<int32_t> x(3001);
+  for (size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<int32_t>((i * 48271) % 2003) - 1000;
+  }
+  nd::array a = x;
+
+  {
+    eval_context_guard guard(3, 16);
+    nd::sort(a);
+  }
+
+  std::sort(x.begin(), x.end());
+  EXPECT_ARRAY_EQ(nd::array(x), a);
+}
+
+TEST(Sort, Comparison) {
+  // Types that are not primitive go through the comparison kernel
+  nd::array a{"delta", "alpha", "charlie", "bravo"};
+  nd::sort(a);
+  EXPECT_ARRAY_EQ((nd::array{"alpha", "bravo", "charlie", "delta"}), a);
+}
+
+TEST(StableSort, 1D) {
+  // NaNs with different payloads are equal keys and keep their order
+  double nan0 = std::numeric_limits<double>::quiet_NaN();
+  double nan1 = -nan0;
+  nd::array a{nan0, 2.0, nan1, 1.0};
+  nd::stable_sort(a);
+  EXPECT_EQ(1.0, a(0).as<double>());
+  EXPECT_EQ(2.0, a(1).as<double>());
+  EXPECT_FALSE(std::signbit(a(2).as<double>()));
+  EXPECT_TRUE(std::signbit(a(3).as<double>()));
+
+  // So are the two zeros
+  nd::array z{0.0, 1.0, -0.0, -1.0, 0.0, -0.0};
+  nd::stable_sort(z);
+  EXPECT_EQ(-1.0, z(0).as<double>());
+  EXPECT_FALSE(std::signbit(z(1).as<double>()));
+  EXPECT_TRUE(std::signbit(z(2).as<double>()));
+  EXPECT_FALSE(std::signbit(z(3).as<double>()));
+  EXPECT_TRUE(std::signbit(z(4).as<double>()));
+  EXPECT_EQ(1.0, z(5).as<double>());
+
+  nd::array b{"pear", "fig", "apple", "fig", "kiwi"};
+  nd::stable_sort(b);
+  EXPECT_ARRAY_EQ((nd::array{"apple", "fig", "fig", "kiwi", "pear"}), b);
+}
+
+TEST(Argsort, 1D) {
+  nd::array a{3, 1, 2, 1, 0};
+  EXPECT_ARRAY_EQ((nd::array{int64_t(4), int64_t(1), int64_t(3), int64_t(2), int64_t(0)}), nd::argsort(a));
+
+  nd::array b{"c", "a", "b", "a"};
+  EXPECT_ARRAY_EQ((nd::array{int64_t(1), int64_t(3), int64_t(2), int64_t(0)}), nd::argsort(b));
+}
+
+TEST(Argsort, Axis) {
+  nd::array a{{5, 2, 7}, {1, 9, 3}};
+
+  nd::array res = nd::argsort(a);
+  EXPECT_EQ(ndt::type("2 * 3 * int64"), res.get_type());
+  EXPECT_ARRAY_EQ((nd::array{{int64_t(1), int64_t(0), int64_t(2)}, {int64_t(0), int64_t(2), int64_t(1)}}), res);
+
+  res = nd::argsort({a}, {{"axis", 0}});
+  EXPECT_ARRAY_EQ((nd::array{{int64_t(1), int64_t(0), int64_t(1)}, {int64_t(0), int64_t(1), int64_t(0)}}), res);
+
+  res = nd::argsort({a}, {{"axis", -2}});
+  EXPECT_ARRAY_EQ((nd::array{{int64_t(1), int64_t(0), int64_t(1)}, {int64_t(0), int64_t(1), int64_t(0)}}), res);
+
+  EXPECT_THROW(nd::argsort({a}, {{"axis", 2}}), axis_out_of_bounds);
+}
+
+TEST(Partition, 1D) {
+  std::vector<int> x{9, 4, 7, 1, 8, 2, 6, 3, 5, 0};
+  nd::array a = x;
+  nd::partition({a}, {{"kth", 4}});
+  EXPECT_EQ(4, a(4).as<int>());
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_LT(a(i).as<int>(), 4);
+  }
+  for (int i = 5; i < 10; ++i) {
+    EXPECT_GT(a(i).as<int>(), 4);
+  }
+
+  nd::array b{"d", "b", "e", "a", "c"};
+  nd::partition({b}, {{"kth", -1}});
+  EXPECT_EQ("e", b(4).as<std::string>());
+
+  EXPECT_THROW(nd::partition({a}, {{"kth", 10}}), index_out_of_bounds);
+}
+
+TEST(TopK, 1D) {
+  std::vector<double> x(1000);
+  for (size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<double>((i * 7919) % 1000);
+  }
+  nd::array a = x;
+
+  nd::array res = nd::topk({a}, {{"k", 3}});
+  EXPECT_ARRAY_EQ((nd::array{0.0, 1.0, 2.0}), res);
+
+  res = nd::topk({a}, {{"k", 3}, {"largest", true}});
+  EXPECT_ARRAY_EQ((nd::array{999.0, 998.0, 997.0}), res);
+
+  // The input is left as it was
+  EXPECT_ARRAY_EQ(nd::array(x), a);
+
+  nd::array b{"kiwi", "apple", "pear", "fig"};
+  EXPECT_ARRAY_EQ((nd::array{"pear", "kiwi"}), nd::topk({b}, {{"k", 2}, {"largest", true}}));
+  EXPECT_EQ(ndt::type("0 * string"), nd::topk({b}, {{"k", 0}}).get_type());
+
+  EXPECT_THROW(nd::topk({b}, {{"k", 5}}), invalid_argument);
+}
+
+TEST(Unique, 1D) {
+  nd::array a{3, 1, 3, 2, 1, 0, 3};
+  nd::array res = nd::unique(a);
+  EXPECT_EQ(ndt::type("var * int32"), res.get_type());
+  ASSERT_EQ(4, res.get_dim_size());
+  EXPECT_EQ(3, res(0).as<int>());
+  EXPECT_EQ(1, res(1).as<int>());
+  EXPECT_EQ(2, res(2).as<int>());
+  EXPECT_EQ(0, res(3).as<int>());
+
+  // Zeros are equal, and so are NaNs
+  double nan = std::numeric_limits<double>::quiet_NaN();
+  res = nd::unique(nd::array{0.0, -0.0, nan, 1.5, -nan, 1.5});
+  ASSERT_EQ(3, res.get_dim_size());
+  EXPECT_EQ(0.0, res(0).as<double>());
+  EXPECT_TRUE(std::isnan(res(1).as<double>()));
+  EXPECT_EQ(1.5, res(2).as<double>());
+
+  EXPECT_THROW(nd::unique(nd::array{dynd::complex<double>(1.0, 2.0)}), type_error);
+}
+
+TEST(Unique, String) {
+  nd::array a{"pear", "fig", "pear", "kiwi", "fig", "a rather long string past the small buffer"};
+  nd::array res = nd::unique(a);
+  EXPECT_EQ(ndt::type("var * string"), res.get_type());
+  ASSERT_EQ(4, res.get_dim_size());
+  EXPECT_EQ("pear", res(0).as<std::string>());
+  EXPECT_EQ("fig", res(1).as<std::string>());
+  EXPECT_EQ("kiwi", res(2).as<std::string>());
+  EXPECT_EQ("a rather long string past the small buffer", res(3).as<std::string>());
+
+  nd::array b = nd::empty(ndt::type("5 * fixed_string[8]"));
+  b.vals() = a(irange() < 5);
+  res = nd::unique(b);
+  EXPECT_EQ(ndt::type("var * fixed_string[8]"), res.get_type());
+  ASSERT_EQ(3, res.get_dim_size());
+  EXPECT_EQ("pear", res(0).as<std::string>());
+  EXPECT_EQ("fig", res(1).as<std::string>());
+  EXPECT_EQ("kiwi", res(2).as<std::string>());
+}
+
+TEST(Unique, Parallel) {
+  std::vector<int64_t> x(5000);
+  for (size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<int64_t>((i * 7919) % 1013);
+  }
+  nd::array a = x;
+
+  nd::array res, counts;
+  {
+    eval_context_guard guard(3, 16);
+    res = nd::unique(a);
+    counts = nd::value_counts(a);
+  }
+
+  // The first 1013 elements are all distinct
+  ASSERT_EQ(1013, res.get_dim_size());
+  ASSERT_EQ(1013, counts.get_dim_size());
+  for (intptr_t i = 0; i < 1013; ++i) {
+    EXPECT_EQ(x[i], res(i).as<int64_t>());
+    EXPECT_EQ(x[i], counts(i, 0).as<int64_t>());
+    EXPECT_EQ(std::count(x.begin(), x.end(), x[i]), counts(i, 1).as<int64_t>());
+  }
+}
+
+TEST(ValueCounts, 1D) {
+  nd::array a{"b", "a", "b", "c", "b", "a"};
+  nd::array res = nd::value_counts(a);
+  EXPECT_EQ(ndt::type("var * {value: string, count: int64}"), res.get_type());
+  ASSERT_EQ(3, res.get_dim_size());
+  EXPECT_EQ("b", res(0, 0).as<std::string>());
+  EXPECT_EQ(3, res(0, 1).as<int64_t>());
+  EXPECT_EQ("a", res(1, 0).as<std::string>());
+  EXPECT_EQ(2, res(1, 1).as<int64_t>());
+  EXPECT_EQ("c", res(2, 0).as<std::string>());
+  EXPECT_EQ(1, res(2, 1).as<int64_t>());
 }
-*/
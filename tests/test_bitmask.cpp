@@ -0,0 +1,111 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+
+#include <dynd/bitmask.hpp>
+#include <dynd/comparison.hpp>
+#include <dynd/gtest.hpp>
+#include <dynd/random.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(Bitmask, Logical) {
+  nd::bitmask a(100), b(100);
+  for (size_t i = 0; i < 100; ++i) {
+    if (i % 2 == 0) {
+      a.set(i);
+    }
+    if (i % 3 == 0) {
+      b.set(i);
+    }
+  }
+
+  EXPECT_EQ(50u, a.count());
+  EXPECT_EQ(17u, (a & b).count());
+  EXPECT_EQ(67u, (a | b).count());
+  EXPECT_EQ(50u, (a ^ b).count());
+  EXPECT_EQ(50u, (~a).count());
+  EXPECT_TRUE((~a).test(1));
+  EXPECT_FALSE((~a).test(0));
+
+  EXPECT_TRUE(a.any());
+  EXPECT_FALSE(a.all());
+  EXPECT_TRUE((a | ~a).all());
+  EXPECT_TRUE((a & ~a).none());
+
+  EXPECT_THROW(a & nd::bitmask(99), invalid_argument);
+}
+
+TEST(Bitmask, Pack) {
+  nd::array a = {true, false, true, true, false};
+  nd::bitmask mask = nd::make_bitmask(a);
+  EXPECT_EQ(5u, mask.size());
+  EXPECT_EQ(3u, mask.count());
+  EXPECT_ARRAY_EQ(a, nd::unpack_bitmask(mask));
+}
+
+TEST(Bitmask, Compare) {
+  // Long enough for whole words and a tail
+  nd::array a = nd::random::uniform({}, {{"dst_tp", ndt::type("203 * int32")}, {"a", -50}, {"b", 50}});
+  nd::array b = nd::random::uniform({}, {{"dst_tp", ndt::type("203 * int32")}, {"a", -50}, {"b", 50}});
+
+  EXPECT_ARRAY_EQ(nd::less(a, b), nd::unpack_bitmask(nd::compare(comparison_type_less, a, b)));
+  EXPECT_ARRAY_EQ(nd::less_equal(a, b), nd::unpack_bitmask(nd::compare(comparison_type_less_equal, a, b)));
+  EXPECT_ARRAY_EQ(nd::equal(a, b), nd::unpack_bitmask(nd::compare(comparison_type_equal, a, b)));
+  EXPECT_ARRAY_EQ(nd::not_equal(a, b), nd::unpack_bitmask(nd::compare(comparison_type_not_equal, a, b)));
+  EXPECT_ARRAY_EQ(nd::greater_equal(a, b), nd::unpack_bitmask(nd::compare(comparison_type_greater_equal, a, b)));
+  EXPECT_ARRAY_EQ(nd::greater(a, b), nd::unpack_bitmask(nd::compare(comparison_type_greater, a, b)));
+
+  // With a scalar
+  EXPECT_ARRAY_EQ(nd::less(a, 10), nd::unpack_bitmask(nd::compare(comparison_type_less, a, 10)));
+
+  nd::array x = {1.0, 2.5, -3.0, 4.0, 0.5};
+  EXPECT_ARRAY_EQ((nd::array{false, true, false, true, false}),
+                  nd::unpack_bitmask(nd::compare(comparison_type_greater, x, 1.0)));
+
+  // Unsigned values with the high bit set compare as large
+  nd::array u = nd::empty(ndt::type("100 * uint64"));
+  for (int i = 0; i < 100; ++i) {
+    u(i).vals() = static_cast<uint64_t>(i % 16) << 60;
+  }
+  EXPECT_EQ(36u, nd::compare(comparison_type_greater_equal, u, static_cast<uint64_t>(10) << 60).count());
+}
+
+TEST(Bitmask, ComparePromotes) {
+  nd::array a = {1, 2, 3};
+  EXPECT_ARRAY_EQ((nd::array{true, true, false}), nd::unpack_bitmask(nd::compare(comparison_type_less, a, 2.5)));
+  EXPECT_ARRAY_EQ((nd::array{false, true, false}), nd::unpack_bitmask(nd::compare(comparison_type_equal, a, 2.0)));
+
+  nd::array x = nd::empty(ndt::type("3 * int8"));
+  x.assign(nd::array{-100, 0, 100});
+  EXPECT_EQ(3u, nd::compare(comparison_type_less, x, 300).count());
+  EXPECT_EQ(0u, nd::compare(comparison_type_greater, x, 300).count());
+  EXPECT_ARRAY_EQ(nd::less(x, a), nd::unpack_bitmask(nd::compare(comparison_type_less, x, a)));
+
+  nd::array y = {0.5, 2.0, 3.5};
+  EXPECT_ARRAY_EQ(nd::less(a, y), nd::unpack_bitmask(nd::compare(comparison_type_less, a, y)));
+}
+
+TEST(Bitmask, CompareElementSizes) {
+  // Each element size takes its own movemask
+  const char *types[] = {"203 * int8", "203 * int16", "203 * uint16", "203 * float32", "203 * int64"};
+  for (const char *tp : types) {
+    nd::array a = nd::empty(ndt::type(tp)), b = nd::empty(ndt::type(tp));
+    a.assign(nd::random::uniform({}, {{"dst_tp", ndt::type("203 * int32")}, {"a", 0}, {"b", 100}}));
+    b.assign(nd::random::uniform({}, {{"dst_tp", ndt::type("203 * int32")}, {"a", 0}, {"b", 100}}));
+    EXPECT_ARRAY_EQ(nd::less(a, b), nd::unpack_bitmask(nd::compare(comparison_type_less, a, b)));
+    EXPECT_ARRAY_EQ(nd::equal(a, a), nd::unpack_bitmask(nd::compare(comparison_type_equal, a, a)));
+    EXPECT_ARRAY_EQ(nd::greater(a, 50), nd::unpack_bitmask(nd::compare(comparison_type_greater, a, 50)));
+  }
+}
+
+TEST(Bitmask, MaskedTake) {
+  nd::array a = {1, 2, 3, 4, 5, 6, 7};
+  nd::bitmask mask = nd::compare(comparison_type_greater, a, 2) & nd::compare(comparison_type_not_equal, a, 5);
+  EXPECT_ARRAY_EQ((nd::array{3, 4, 6, 7}), nd::masked_take(a, mask));
+}
@@ -0,0 +1,28 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/eval/eval_context.hpp>
+
+/**
+ * Sets the thread settings of the default evaluation context for the
+ * lifetime of this object, and restores the previous context afterwards,
+ * even when an assertion ends the test early.
+ */
+class eval_context_guard {
+  dynd::eval::eval_context m_saved;
+
+public:
+  eval_context_guard(size_t nthreads, size_t grain_size) : m_saved(dynd::eval::default_eval_context) {
+    dynd::eval::default_eval_context.nthreads = nthreads;
+    dynd::eval::default_eval_context.grain_size = grain_size;
+  }
+
+  eval_context_guard(const eval_context_guard &) = delete;
+  eval_context_guard &operator=(const eval_context_guard &) = delete;
+
+  ~eval_context_guard() { dynd::eval::default_eval_context = m_saved; }
+};
@@ -0,0 +1,64 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <thread>
+
+#include <dynd/arithmetic.hpp>
+#include <dynd/array.hpp>
+#include <dynd/gtest.hpp>
+#include <dynd/kernels/kernel_builder.hpp>
+#include <dynd/storagebuf.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(Storagebuf, Reserve) {
+  storage_stats stats = get_storage_stats();
+
+  nd::kernel_builder kb;
+  EXPECT_EQ(128u, kb.capacity());
+  kb.emplace_back(100);
+  EXPECT_EQ(128u, kb.capacity());
+  EXPECT_EQ(stats.allocs, get_storage_stats().allocs);
+
+  // Capacities are rounded up to the size of a block
+  kb.emplace_back(100);
+  EXPECT_EQ(256u, kb.capacity());
+  kb.emplace_back(1000);
+  EXPECT_EQ(2048u, kb.capacity());
+  EXPECT_EQ(stats.allocs + 2, get_storage_stats().allocs);
+  for (size_t i = 0; i < kb.size(); ++i) {
+    EXPECT_EQ(0, *kb.get_at<char>(i));
+  }
+}
+
+TEST(Storagebuf, Cache) {
+  std::thread([] {
+    for (int i = 0; i < 3; ++i) {
+      nd::kernel_builder kb;
+      kb.emplace_back(1000);
+      kb.emplace_back(5000);
+    }
+
+    // Only the first builder needs the heap
+    storage_stats stats = get_storage_stats();
+    EXPECT_EQ(6u, stats.allocs);
+    EXPECT_EQ(2u, stats.heap_allocs);
+  }).join();
+}
+
+TEST(Storagebuf, SteadyState) {
+  nd::array a = nd::empty(ndt::make_type<int[3][4][5]>());
+  a.vals() = 1;
+
+  nd::sum(a);
+  nd::sum(a);
+
+  // Repeated calls reuse the blocks of the first one
+  storage_stats stats = get_storage_stats();
+  EXPECT_ARRAY_EQ(60, nd::sum(a));
+  EXPECT_LT(stats.allocs, get_storage_stats().allocs);
+  EXPECT_EQ(stats.heap_allocs, get_storage_stats().heap_allocs);
+}
@@ -0,0 +1,73 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include <dynd/gtest.hpp>
+#include <dynd/thread_pool.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(ThreadPool, ParallelFor) {
+  thread_pool pool(4);
+  EXPECT_EQ(4u, pool.get_nthreads());
+
+  vector<atomic<int>> counts(10007);
+  for (auto &count : counts) {
+    count = 0;
+  }
+
+  atomic<bool> bad_worker(false);
+  pool.parallel_for(counts.size(), 10, [&](size_t worker, size_t begin, size_t end) {
+    if (worker >= 4 || end - begin > 10) {
+      bad_worker = true;
+    }
+    for (size_t i = begin; i < end; ++i) {
+      ++counts[i];
+    }
+  });
+
+  EXPECT_FALSE(bad_worker);
+  for (auto &count : counts) {
+    EXPECT_EQ(1, count);
+  }
+}
+
+TEST(ThreadPool, Nested) {
+  thread_pool pool(3);
+
+  atomic<size_t> total(0);
+  pool.parallel_for(100, 1, [&](size_t, size_t begin, size_t end) {
+    EXPECT_TRUE(thread_pool::in_parallel_region());
+    // A nested loop runs serially on the same thread
+    pool.parallel_for(end - begin, 1, [&](size_t worker, size_t nested_begin, size_t nested_end) {
+      EXPECT_EQ(0u, worker);
+      total += nested_end - nested_begin;
+    });
+  });
+
+  EXPECT_EQ(100u, total);
+  EXPECT_FALSE(thread_pool::in_parallel_region());
+}
+
+TEST(ThreadPool, Exception) {
+  thread_pool pool(4);
+
+  EXPECT_THROW(pool.parallel_for(1000, 1,
+                                 [](size_t, size_t begin, size_t) {
+                                   if (begin == 500) {
+                                     throw runtime_error("failed");
+                                   }
+                                 }),
+               runtime_error);
+
+  // The pool is usable after a failure
+  atomic<size_t> total(0);
+  pool.parallel_for(1000, 7, [&](size_t, size_t begin, size_t end) { total += end - begin; });
+  EXPECT_EQ(1000u, total);
+}
@@ -6,15 +6,13 @@
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
-#include "inc_gtest.hpp"
 
 #include <dynd/array.hpp>
+#include <dynd/array_range.hpp>
 #include <dynd/types/categorical_type.hpp>
 #include <dynd/types/fixed_string_type.hpp>
 #include <dynd/types/string_type.hpp>
-#include <dynd/types/convert_type.hpp>
-#include <dynd/array_range.hpp>
-#include <dynd/func/comparison.hpp>
+#include <dynd/gtest.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -25,52 +23,51 @@ TEST(CategoricalType, Create)
   nd::array a = nd::empty(3, ndt::make_type<ndt::string_type>());
   a.vals() = a_vals;
 
-  ndt::type d;
-  d = ndt::categorical_type::make(a);
+  ndt::type d = ndt::make_type<ndt::categorical_type>(a);
   EXPECT_EQ(categorical_id, d.get_id());
-  EXPECT_EQ(scalar_kind_id, d.get_base_id());
+  EXPECT_EQ(categorical_kind_id, d.get_base_id());
   EXPECT_EQ(1u, d.get_data_alignment());
   EXPECT_EQ(1u, d.get_data_size());
   EXPECT_FALSE(d.is_expression());
-  EXPECT_EQ(ndt::make_type<uint8_t>(), d.p("storage_type").as<ndt::type>());
-  EXPECT_EQ(a.get_dtype(), d.p("category_type").as<ndt::type>());
+  const ndt::categorical_type *cd = d.extended<ndt::categorical_type>();
+  EXPECT_EQ(ndt::make_type<uint8_t>(), cd->get_storage_type());
+  EXPECT_EQ(a.get_dtype(), cd->get_category_type());
+  EXPECT_EQ(3u, cd->get_category_count());
 
   // With <= 256 categories, storage is a uint8
-  a = nd::range(256);
-  d = ndt::categorical_type::make(a);
+  a = nd::old_range(256);
+  d = ndt::make_type<ndt::categorical_type>(a);
   EXPECT_EQ(1u, d.get_data_alignment());
   EXPECT_EQ(1u, d.get_data_size());
-  EXPECT_EQ(ndt::make_type<uint8_t>(), d.p("storage_type").as<ndt::type>());
-  EXPECT_EQ(ndt::make_type<int32_t>(), d.p("category_type").as<ndt::type>());
+  EXPECT_EQ(ndt::make_type<uint8_t>(), d.extended<ndt::categorical_type>()->get_storage_type());
+  EXPECT_EQ(ndt::make_type<int32_t>(), d.extended<ndt::categorical_type>()->get_category_type());
 
   // With <= 65536 categories, storage is a uint16
-  a = nd::range(257);
-  d = ndt::categorical_type::make(a);
+  a = nd::old_range(257);
+  d = ndt::make_type<ndt::categorical_type>(a);
   EXPECT_EQ(2u, d.get_data_alignment());
   EXPECT_EQ(2u, d.get_data_size());
-  a = nd::range(65536);
-  d = ndt::categorical_type::make(a);
+  a = nd::old_range(65536);
+  d = ndt::make_type<ndt::categorical_type>(a);
   EXPECT_EQ(2u, d.get_data_alignment());
   EXPECT_EQ(2u, d.get_data_size());
-  EXPECT_EQ(ndt::make_type<uint16_t>(), d.p("storage_type").as<ndt::type>());
-  EXPECT_EQ(ndt::make_type<int32_t>(), d.p("category_type").as<ndt::type>());
+  EXPECT_EQ(ndt::make_type<uint16_t>(), d.extended<ndt::categorical_type>()->get_storage_type());
 
   // Otherwise, storage is a uint32
-  a = nd::range(65537);
-  d = ndt::categorical_type::make(a);
+  a = nd::old_range(65537);
+  d = ndt::make_type<ndt::categorical_type>(a);
   EXPECT_EQ(4u, d.get_data_alignment());
   EXPECT_EQ(4u, d.get_data_size());
-  EXPECT_EQ(ndt::make_type<uint32_t>(), d.p("storage_type").as<ndt::type>());
-  EXPECT_EQ(ndt::make_type<int32_t>(), d.p("category_type").as<ndt::type>());
+  EXPECT_EQ(ndt::make_type<uint32_t>(), d.extended<ndt::categorical_type>()->get_storage_type());
 }
 
 TEST(CategoricalType, Convert)
 {
   const char *a_vals[] = {"foo", "bar", "baz"};
-  nd::array a = nd::empty(3, ndt::fixed_string_type::make(3, string_encoding_ascii));
+  nd::array a = nd::empty(3, ndt::make_type<ndt::fixed_string_type>(3, string_encoding_ascii));
   a.vals() = a_vals;
 
-  ndt::type cd = ndt::categorical_type::make(a);
+  ndt::type cd = ndt::make_type<ndt::categorical_type>(a);
   ndt::type sd = ndt::make_type<ndt::string_type>();
 
   // String conversions report false, so that assignments encodings
@@ -78,10 +75,15 @@ TEST(CategoricalType, Convert)
   EXPECT_FALSE(is_lossless_assignment(sd, cd));
   EXPECT_FALSE(is_lossless_assignment(cd, sd));
 
-  // This operation was crashing, hence the test
-  ndt::type cvt = ndt::convert_type::make(sd, cd);
-  EXPECT_EQ(cd, cvt.operand_type());
-  EXPECT_EQ(sd, cvt.value_type());
+  // Assigning the category type encodes, another string type is rejected
+  nd::array c = nd::empty(ndt::make_fixed_dim(3, cd));
+  c.vals() = a;
+  const uint8_t expected[] = {0, 1, 2};
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(expected[i], reinterpret_cast<const uint8_t *>(c.cdata())[i]);
+  }
+  nd::array s = {"foo", "bar", "baz"};
+  EXPECT_THROW(c.vals() = s, type_error);
 }
 
 TEST(CategoricalType, Compare)
@@ -94,113 +96,171 @@ TEST(CategoricalType, Compare)
   nd::array b = nd::empty(2, ndt::make_type<ndt::string_type>());
   b.vals() = b_vals;
 
-  ndt::type da = ndt::categorical_type::make(a);
-  ndt::type da2 = ndt::categorical_type::make(a);
-  ndt::type db = ndt::categorical_type::make(b);
+  ndt::type da = ndt::make_type<ndt::categorical_type>(a);
+  ndt::type da2 = ndt::make_type<ndt::categorical_type>(a);
+  ndt::type db = ndt::make_type<ndt::categorical_type>(b);
 
   EXPECT_EQ(da, da);
   EXPECT_EQ(da, da2);
   EXPECT_NE(da, db);
 
-  nd::array i = nd::empty(3, ndt::make_type<int32_t>());
-  i(0).vals() = 0;
-  i(1).vals() = 10;
-  i(2).vals() = 100;
-
-  ndt::type di = ndt::categorical_type::make(i);
+  nd::array i = {0, 10, 100};
+  ndt::type di = ndt::make_type<ndt::categorical_type>(i);
   EXPECT_FALSE(da == di);
 }
 
 TEST(CategoricalType, Unique)
 {
   const char *a_vals[] = {"foo", "bar", "foo"};
-  nd::array a = nd::empty(3, ndt::fixed_string_type::make(3, string_encoding_ascii));
+  nd::array a = nd::empty(3, ndt::make_type<ndt::fixed_string_type>(3, string_encoding_ascii));
   a.vals() = a_vals;
 
-  EXPECT_THROW(ndt::categorical_type::make(a), std::runtime_error);
+  EXPECT_THROW(ndt::make_type<ndt::categorical_type>(a), std::runtime_error);
 
-  int i_vals[] = {0, 10, 10};
-  nd::array i = i_vals;
+  nd::array i = {0, 10, 10};
+  EXPECT_THROW(ndt::make_type<ndt::categorical_type>(i), std::runtime_error);
 
-  EXPECT_THROW(ndt::categorical_type::make(i), std::runtime_error);
+  nd::array f = {0.5, -0.0, 0.0};
+  EXPECT_THROW(ndt::make_type<ndt::categorical_type>(f), std::runtime_error);
 }
 
 TEST(CategoricalType, FactorFixedString)
 {
-  const char *string_cats_vals[] = {"bar", "foo"};
-  nd::array string_cats = nd::empty(2, ndt::make_type<ndt::string_type>());
-  string_cats.vals() = string_cats_vals;
+  const char *cats_vals[] = {"bar", "foo"};
+  nd::array cats = nd::empty(2, ndt::make_type<ndt::fixed_string_type>(3, string_encoding_ascii));
+  cats.vals() = cats_vals;
 
   const char *a_vals[] = {"foo", "bar", "foo"};
-  nd::array a = nd::empty(3, ndt::make_type<ndt::string_type>());
+  nd::array a = nd::empty(3, ndt::make_type<ndt::fixed_string_type>(3, string_encoding_ascii));
   a.vals() = a_vals;
 
   ndt::type da = ndt::factor_categorical(a);
-  EXPECT_EQ(ndt::categorical_type::make(string_cats), da);
+  const ndt::categorical_type *cd = da.extended<ndt::categorical_type>();
+  EXPECT_EQ(cats.get_dtype(), cd->get_category_type());
+  EXPECT_EQ(2u, cd->get_category_count());
+  nd::array categories = cd->get_categories();
+  EXPECT_EQ("bar", categories(0).as<std::string>());
+  EXPECT_EQ("foo", categories(1).as<std::string>());
 }
 
 TEST(CategoricalType, FactorString)
 {
-  const char *cats_vals[] = {"bar", "foo", "foot"};
-  const char *a_vals[] = {"foo", "bar", "foot", "foo", "bar"};
-  nd::array cats = cats_vals, a = a_vals;
+  nd::array cats = {"bar", "foo", "foot"};
+  nd::array a = {"foo", "bar", "foot", "foo", "bar"};
 
   ndt::type da = ndt::factor_categorical(a);
-  EXPECT_EQ(ndt::categorical_type::make(cats), da);
+  EXPECT_EQ(ndt::make_type<ndt::categorical_type>(cats), da);
 }
 
 TEST(CategoricalType, FactorStringLonger)
 {
-  const char *cats_vals[] = {"a", "abcdefghijklmnopqrstuvwxyz", "bar", "foo", "foot", "z"};
-  const char *a_vals[] = {"foo",
-                          "bar",
-                          "foot",
-                          "foo",
-                          "bar",
-                          "abcdefghijklmnopqrstuvwxyz",
-                          "foot",
-                          "foo",
-                          "z",
-                          "a",
-                          "abcdefghijklmnopqrstuvwxyz"};
-  ndt::type da = ndt::factor_categorical(a_vals);
-  EXPECT_EQ(ndt::categorical_type::make(cats_vals), da);
+  // Strings longer than fit inline in a dynd::string
+  nd::array cats = {"a", "abcdefghijklmnopqrstuvwxyz", "bar", "foo", "foot", "z"};
+  nd::array a = {"foo", "bar", "foot", "foo", "bar", "abcdefghijklmnopqrstuvwxyz", "foot", "foo", "z", "a",
+                 "abcdefghijklmnopqrstuvwxyz"};
+
+  ndt::type da = ndt::factor_categorical(a);
+  EXPECT_EQ(ndt::make_type<ndt::categorical_type>(cats), da);
+
+  nd::array codes = nd::empty(ndt::make_fixed_dim(11, da));
+  codes.vals() = a;
+  const uint8_t expected[] = {3, 2, 4, 3, 2, 1, 4, 3, 5, 0, 1};
+  for (int i = 0; i < 11; ++i) {
+    EXPECT_EQ(expected[i], reinterpret_cast<const uint8_t *>(codes.cdata())[i]);
+  }
+  EXPECT_EQ("abcdefghijklmnopqrstuvwxyz", da.extended<ndt::categorical_type>()->get_categories()(1).as<std::string>());
 }
 
 TEST(CategoricalType, FactorInt)
 {
-  int int_cats_vals[] = {0, 10};
-  nd::array int_cats = nd::empty(2, ndt::make_type<int32_t>());
-  int_cats.vals() = int_cats_vals;
-
-  int i_vals[] = {10, 10, 0};
-  nd::array i = nd::empty(3, ndt::make_type<int32_t>());
-  i.vals() = i_vals;
+  nd::array int_cats = {0, 10};
+  nd::array i = {10, 10, 0};
 
   ndt::type di = ndt::factor_categorical(i);
-  EXPECT_EQ(ndt::categorical_type::make(int_cats), di);
+  EXPECT_EQ(ndt::make_type<ndt::categorical_type>(int_cats), di);
 }
 
 TEST(CategoricalType, Values)
 {
   const char *a_vals[] = {"foo", "bar", "baz"};
-  nd::array a = nd::empty(3, ndt::fixed_string_type::make(3, string_encoding_ascii));
+  nd::array a = nd::empty(3, ndt::make_type<ndt::fixed_string_type>(3, string_encoding_ascii));
   a.vals() = a_vals;
 
-  ndt::type dt = ndt::categorical_type::make(a);
-
-  EXPECT_EQ(0u, static_cast<const ndt::categorical_type *>(dt.extended())->get_value_from_category(a(0)));
-  EXPECT_EQ(1u, static_cast<const ndt::categorical_type *>(dt.extended())->get_value_from_category(a(1)));
-  EXPECT_EQ(2u, static_cast<const ndt::categorical_type *>(dt.extended())->get_value_from_category(a(2)));
-  EXPECT_EQ(0u, static_cast<const ndt::categorical_type *>(dt.extended())->get_value_from_category("foo"));
-  EXPECT_EQ(1u, static_cast<const ndt::categorical_type *>(dt.extended())->get_value_from_category("bar"));
-  EXPECT_EQ(2u, static_cast<const ndt::categorical_type *>(dt.extended())->get_value_from_category("baz"));
-  EXPECT_THROW(static_cast<const ndt::categorical_type *>(dt.extended())->get_value_from_category("aaa"),
-               std::runtime_error);
-  EXPECT_THROW(static_cast<const ndt::categorical_type *>(dt.extended())->get_value_from_category("ddd"),
-               std::runtime_error);
-  EXPECT_THROW(static_cast<const ndt::categorical_type *>(dt.extended())->get_value_from_category("zzz"),
-               std::runtime_error);
+  ndt::type dt = ndt::make_type<ndt::categorical_type>(a);
+  const ndt::categorical_type *cd = dt.extended<ndt::categorical_type>();
+
+  EXPECT_EQ(0u, cd->get_value_from_category(a(0)));
+  EXPECT_EQ(1u, cd->get_value_from_category(a(1)));
+  EXPECT_EQ(2u, cd->get_value_from_category(a(2)));
+  EXPECT_EQ(0u, cd->get_value_from_category("foo"));
+  EXPECT_EQ(1u, cd->get_value_from_category("bar"));
+  EXPECT_EQ(2u, cd->get_value_from_category("baz"));
+  EXPECT_THROW(cd->get_value_from_category("aaa"), std::runtime_error);
+  EXPECT_THROW(cd->get_value_from_category("ddd"), std::runtime_error);
+  EXPECT_THROW(cd->get_value_from_category("zzz"), std::runtime_error);
+
+  EXPECT_EQ(1, cd->find_value(a(1).cdata()));
+  nd::array categories = cd->get_categories();
+  EXPECT_EQ("foo", categories(0).as<std::string>());
+  EXPECT_EQ("bar", categories(1).as<std::string>());
+  EXPECT_EQ("baz", categories(2).as<std::string>());
+}
+
+TEST(CategoricalType, Encode)
+{
+  nd::array cats = {"this", "is", "a", "test"};
+  ndt::type dt = ndt::make_type<ndt::categorical_type>(cats);
+
+  nd::array a = {"test", "a", "this", "is", "a", "test"};
+  nd::array codes = nd::empty(ndt::make_fixed_dim(6, dt));
+  codes.vals() = a;
+
+  const uint8_t expected[] = {3, 2, 0, 1, 2, 3};
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_EQ(expected[i], reinterpret_cast<const uint8_t *>(codes.cdata())[i]);
+  }
+
+  a(1).vals() = "b";
+  EXPECT_THROW(codes.vals() = a, std::runtime_error);
+}
+
+TEST(CategoricalType, EncodeFixedString)
+{
+  const char *cats_vals[] = {"foo", "bar", "baz"};
+  nd::array cats = nd::empty(3, ndt::make_type<ndt::fixed_string_type>(3, string_encoding_ascii));
+  cats.vals() = cats_vals;
+  ndt::type dt = ndt::make_type<ndt::categorical_type>(cats);
+
+  const char *a_vals[] = {"baz", "foo", "bar", "baz"};
+  nd::array a = nd::empty(4, cats.get_dtype());
+  a.vals() = a_vals;
+  nd::array codes = nd::empty(ndt::make_fixed_dim(4, dt));
+  codes.vals() = a;
+
+  const uint8_t expected[] = {2, 0, 1, 2};
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(expected[i], reinterpret_cast<const uint8_t *>(codes.cdata())[i]);
+  }
+}
+
+TEST(CategoricalType, EncodeMany)
+{
+  // Enough categories for uint32 codes
+  nd::array cats = nd::old_range(70000);
+  ndt::type dt = ndt::make_type<ndt::categorical_type>(cats);
+  const ndt::categorical_type *cd = dt.extended<ndt::categorical_type>();
+  EXPECT_EQ(ndt::make_type<uint32_t>(), cd->get_storage_type());
+
+  int32_t values[] = {69999, 0, 12345};
+  uint32_t codes[3];
+  cd->encode(reinterpret_cast<char *>(codes), sizeof(uint32_t), reinterpret_cast<const char *>(values),
+             sizeof(int32_t), 3);
+  EXPECT_EQ(69999u, codes[0]);
+  EXPECT_EQ(0u, codes[1]);
+  EXPECT_EQ(12345u, codes[2]);
+
+  int32_t missing = 70000;
+  EXPECT_EQ(-1, cd->find_value(reinterpret_cast<const char *>(&missing)));
 }
 
 /*
@@ -3,6 +3,7 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
@@ -122,3 +123,111 @@ TEST(FixedstringDType, Repr) {
     EXPECT_TYPE_REPR_EQ(s, ndt::type(s));
   }
 }
+
+TEST(FixedStringDType, Transcode) {
+  // Runs of ASCII longer than a vector, broken up by two, three and four
+  // byte UTF-8 characters
+  std::string s = "0123456789abcdefghijklmnopqrstuvwxyz0123456789\xc3\xa9"
+                  "abc\xe4\xb8\xad\xf0\x9f\x98\x80"
+                  "0123456789abcdefghijklmnopqrstuvwxyz0123456789";
+  nd::array a = s;
+
+  string_encoding_t encodings[] = {string_encoding_utf_8, string_encoding_utf_16, string_encoding_utf_32};
+  for (string_encoding_t encoding : encodings) {
+    nd::array b = nd::empty(ndt::make_type<ndt::fixed_string_type>(120, encoding));
+    b.assign(a);
+    EXPECT_EQ(s, b.as<std::string>());
+
+    for (string_encoding_t other_encoding : encodings) {
+      nd::array c = nd::empty(ndt::make_type<ndt::fixed_string_type>(120, other_encoding));
+      c.assign(b);
+      EXPECT_EQ(s, c.as<std::string>());
+    }
+  }
+
+  // The ASCII prefix goes to the encodings that only have ASCII or the BMP
+  a = s.substr(0, 46);
+  nd::array b = nd::empty(ndt::make_type<ndt::fixed_string_type>(50, string_encoding_ascii));
+  b.assign(a);
+  EXPECT_EQ(s.substr(0, 46), b.as<std::string>());
+  nd::array c = nd::empty(ndt::make_type<ndt::fixed_string_type>(50, string_encoding_ucs_2));
+  c.assign(b);
+  EXPECT_EQ(s.substr(0, 46), c.as<std::string>());
+
+  // A character that doesn't fit is an error, or left out with no checking
+  a = "abcd\xf0\x9f\x98\x80";
+  b = nd::empty(ndt::make_type<ndt::fixed_string_type>(6, string_encoding_utf_8));
+  EXPECT_THROW(b.assign(a), std::runtime_error);
+  b.assign(a, assign_error_nocheck);
+  EXPECT_EQ("abcd", b.as<std::string>());
+}
+
+TEST(FixedStringDType, TranscodeMultibyte) {
+  // Runs of non-ASCII characters, including the edges of each UTF-8 length
+  // and of the basic multilingual plane
+  std::string s = "\xc2\x80\xdf\xbf\xe0\xa0\x80\xef\xbf\xbf\xf0\x90\x80\x80\xf4\x8f\xbf\xbf"
+                  "\xc3\xa9\xe4\xb8\xad\xf0\x9f\x98\x80\xed\x9f\xbf\xee\x80\x80"
+                  "a\xc3\xa9\xe4\xb8\xad\xf0\x9f\x98\x80";
+  nd::array a = s;
+
+  string_encoding_t encodings[] = {string_encoding_utf_8, string_encoding_utf_16, string_encoding_utf_32};
+  for (string_encoding_t encoding : encodings) {
+    nd::array b = nd::empty(ndt::make_type<ndt::fixed_string_type>(80, encoding));
+    b.assign(a);
+    EXPECT_EQ(s, b.as<std::string>());
+    b.assign(a, assign_error_nocheck);
+    EXPECT_EQ(s, b.as<std::string>());
+
+    for (string_encoding_t other_encoding : encodings) {
+      nd::array c = nd::empty(ndt::make_type<ndt::fixed_string_type>(80, other_encoding));
+      c.assign(b);
+      EXPECT_EQ(s, c.as<std::string>());
+    }
+  }
+
+  // An invalid sequence in the middle of a run is still an error, or
+  // substituted with no checking
+  a = nd::empty(ndt::make_type<ndt::fixed_string_type>(10, string_encoding_utf_8));
+  memcpy(a.data(), "\xc3\xa9\xe4\xb8\xad\xed\xa0\x80\xc3\xa9", 10);
+  nd::array b = nd::empty(ndt::make_type<ndt::fixed_string_type>(10, string_encoding_utf_16));
+  EXPECT_THROW(b.assign(a), dynd::string_encode_error);
+  b.assign(a, assign_error_nocheck);
+  EXPECT_EQ("\xc3\xa9\xe4\xb8\xad???\xc3\xa9", b.as<std::string>());
+
+  // A lone surrogate in UTF-16 is an error too
+  b = nd::empty(ndt::make_type<ndt::fixed_string_type>(3, string_encoding_utf_16));
+  uint16_t units[3] = {0xe9, 0xdc00, 0x4e2d};
+  memcpy(b.data(), units, sizeof(units));
+  nd::array c = nd::empty(ndt::make_type<ndt::fixed_string_type>(12, string_encoding_utf_8));
+  EXPECT_THROW(c.assign(b), dynd::string_decode_error);
+
+  // A surrogate pair that doesn't fit is an error, or left out with no
+  // checking
+  a = "\xc3\xa9\xf0\x9f\x98\x80";
+  b = nd::empty(ndt::make_type<ndt::fixed_string_type>(2, string_encoding_utf_16));
+  EXPECT_THROW(b.assign(a), std::runtime_error);
+  b.assign(a, assign_error_nocheck);
+  EXPECT_EQ("\xc3\xa9", b.as<std::string>());
+}
+
+TEST(FixedStringDType, ValidateUTF8) {
+  std::string s = "0123456789abcdefghijklmnopqrstuvwxyz0123456789\xc3\xa9\xe4\xb8\xad\xf0\x9f\x98\x80";
+  EXPECT_EQ(s.data() + s.size(), validate_utf8(s.data(), s.data() + s.size()));
+
+  // A stray continuation byte after the ASCII run
+  std::string t = s.substr(0, 40) + "\x80" + s.substr(40);
+  EXPECT_EQ(t.data() + 40, validate_utf8(t.data(), t.data() + t.size()));
+
+  // A truncated sequence at the end
+  std::string u = s.substr(0, s.size() - 1);
+  EXPECT_EQ(u.data() + u.size() - 3, validate_utf8(u.data(), u.data() + u.size()));
+
+  // Overlong sequences, surrogates and code points past U+10FFFF after a run
+  // of multi-byte characters
+  const char *invalid[] = {"\xc0\x80", "\xc1\xbf", "\xe0\x9f\xbf", "\xed\xa0\x80", "\xf0\x8f\xbf\xbf",
+                           "\xf4\x90\x80\x80", "\xf5\x80\x80\x80", "\xe4\xb8\x41"};
+  for (const char *seq : invalid) {
+    std::string v = "\xc3\xa9\xe4\xb8\xad" + std::string(seq) + "abc";
+    EXPECT_EQ(v.data() + 5, validate_utf8(v.data(), v.data() + v.size()));
+  }
+}
@@ -3,12 +3,15 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <cmath>
 #include <iostream>
+#include <random>
 #include <sstream>
 #include <stdexcept>
 
 #include <dynd/array.hpp>
 #include <dynd/json_parser.hpp>
+#include <dynd/memblock/pod_memory_block.hpp>
 #include <dynd/string.hpp>
 #include <dynd/types/bytes_type.hpp>
 #include <dynd/types/fixed_string_type.hpp>
@@ -296,6 +299,26 @@ TEST(StringType, StringToInteger) {
   */
 }
 
+TEST(StringType, StringToFloat) {
+  nd::array f64 = nd::empty(ndt::make_type<double>());
+  EXPECT_EQ(0.1, f64.assign(nd::array("0.1")).as<double>());
+  EXPECT_EQ(-2.5e-300, f64.assign(nd::array("  -2.5e-300 ")).as<double>());
+  EXPECT_EQ(9007199254740992.0, f64.assign(nd::array("9007199254740993")).as<double>());
+  EXPECT_THROW(f64.assign(nd::array("0.1.2")), invalid_argument);
+
+  // Parsing to float directly rounds once, where going through double would
+  // round this up to the next float
+  nd::array f32 = nd::empty(ndt::make_type<float>());
+  EXPECT_EQ(1.00000012f, f32.assign(nd::array("1.000000178813934325")).as<float>());
+  EXPECT_EQ(0.1f, f32.assign(nd::array(" 0.1")).as<float>());
+
+  nd::array a = nd::empty("3 * float64");
+  a.assign(nd::array({"1.5", "-0", "1e308"}));
+  EXPECT_EQ(1.5, a(0).as<double>());
+  EXPECT_TRUE(signbit(a(1).as<double>()));
+  EXPECT_EQ(1e308, a(2).as<double>());
+}
+
 TEST(StringType, Comparisons) {
   nd::array a, b;
 
@@ -544,6 +567,121 @@ TEST(StringType, Contains) {
   EXPECT_ARRAY_EQ(c, nd::string_contains(a, b));
 }
 
+TEST(StringType, SearchLong) {
+  // Haystacks of a small alphabet, long enough to cover the vectorized
+  // search and its tail, with needles of every code path
+  std::default_random_engine random;
+  std::uniform_int_distribution<int> letter(0, 2);
+  std::uniform_int_distribution<size_t> length(0, 200);
+
+  std::vector<std::string> haystacks;
+  for (int i = 0; i < 100; ++i) {
+    std::string s(length(random), ' ');
+    for (char &c : s) {
+      c = static_cast<char>('a' + letter(random));
+    }
+    haystacks.push_back(s);
+  }
+  nd::array a = haystacks;
+
+  const char *needles[] = {"a", "ab", "aa", "aba", "abca", "aaaa", "cbacbac"};
+  for (const char *needle : needles) {
+    nd::array find = nd::string_find(a, needle);
+    nd::array count = nd::string_count(a, needle);
+    nd::array contains = nd::string_contains(a, needle);
+    nd::array replace = nd::string_replace(a, needle, "XY");
+    for (size_t i = 0; i < haystacks.size(); ++i) {
+      const std::string &s = haystacks[i];
+      size_t m = strlen(needle);
+
+      std::string::size_type pos = s.find(needle);
+      intptr_t expected_count = 0;
+      std::string expected_replace;
+      std::string::size_type last = 0;
+      for (std::string::size_type j = pos; j != std::string::npos; j = s.find(needle, j + m)) {
+        ++expected_count;
+        expected_replace += s.substr(last, j - last) + "XY";
+        last = j + m;
+      }
+      expected_replace += s.substr(last);
+
+      EXPECT_EQ(pos == std::string::npos ? -1 : static_cast<intptr_t>(pos), find(i).as<intptr_t>());
+      EXPECT_EQ(expected_count, count(i).as<intptr_t>());
+      EXPECT_EQ(pos != std::string::npos, contains(i).as<bool>());
+      EXPECT_EQ(expected_replace, replace(i).as<std::string>());
+    }
+  }
+}
+
+TEST(StringType, RFind2) {
+  /* This tests the "fast path" where the needle is a single
+     character */
+  nd::array a, b;
+
+  a = {"a", "bbbb", "abbba", "0123456789bb", "0123456789a"};
+  b = "a";
+  intptr_t c[] = {0, -1, 4, -1, 10};
+
+  EXPECT_ARRAY_EQ(c, nd::string_rfind(a, b));
+}
+
+TEST(StringType, Arena) {
+  std::vector<std::string> values;
+  for (int i = 0; i < 1000; ++i) {
+    values.push_back(i % 2 == 0 ? std::to_string(i) : "a string too long for SSO, number " + std::to_string(i));
+  }
+
+  dynd::string copied;
+  {
+    // Strings too long for SSO are built in the arena of the array
+    nd::array a = values;
+    for (int i = 0; i < 1000; ++i) {
+      EXPECT_EQ(values[i], a(i).as<std::string>());
+    }
+    const nd::memory_block &arena =
+        reinterpret_cast<const ndt::string_type::metadata_type *>(a.get()->metadata() + sizeof(size_stride_t))
+            ->blockref;
+    ASSERT_TRUE(static_cast<bool>(arena));
+    intptr_t capacity = reinterpret_cast<const nd::pod_memory_block *>(arena.get())->m_total_allocated_capacity;
+
+    // Copies out of the array own their memory, moves keep pointing into the arena
+    copied = *reinterpret_cast<const dynd::string *>(a(501).cdata());
+    std::swap(*reinterpret_cast<dynd::string *>(a(503).data()), *reinterpret_cast<dynd::string *>(a(505).data()));
+    EXPECT_EQ(values[505], a(503).as<std::string>());
+    EXPECT_EQ(values[503], a(505).as<std::string>());
+
+    // An element can be assigned a longer string than it was built with, which it builds on the heap
+    std::string longer = values[1];
+    for (int i = 0; i < 100; ++i) {
+      longer += " and more";
+      a(1).assign(longer);
+      EXPECT_EQ(longer, a(1).as<std::string>());
+    }
+    a(3).assign("short");
+    EXPECT_EQ("short", a(3).as<std::string>());
+    EXPECT_EQ(capacity, reinterpret_cast<const nd::pod_memory_block *>(arena.get())->m_total_allocated_capacity);
+
+    nd::array b =
+        parse_json("3 * string", "[\"a string too long for SSO\", \"short\", \"an escaped \\u00e9 too long for SSO\"]");
+    EXPECT_EQ("a string too long for SSO", b(0).as<std::string>());
+    EXPECT_EQ("short", b(1).as<std::string>());
+    EXPECT_EQ("an escaped \xc3\xa9 too long for SSO", b(2).as<std::string>());
+    nd::array c = b(0);
+    b = nd::array();
+    EXPECT_EQ("a string too long for SSO", c.as<std::string>());
+  }
+  EXPECT_EQ(dynd::string(values[501]), copied);
+
+  // Arrays whose strings all fit in SSO make no arena
+  typedef ndt::string_type::metadata_type metadata_type;
+  nd::array a = {"a", "bb", "ccc"};
+  EXPECT_FALSE(static_cast<bool>(
+      reinterpret_cast<const metadata_type *>(a.get()->metadata() + sizeof(size_stride_t))->blockref));
+  nd::array s = "a scalar string too long for SSO";
+  EXPECT_TRUE(static_cast<bool>(reinterpret_cast<const metadata_type *>(s.get()->metadata())->blockref));
+  EXPECT_EQ("a scalar string too long for SSO", s.as<std::string>());
+}
+
 template <class T>
 static bool ascii_T_compare(const char *x, const T *y, intptr_t count) {
   for (intptr_t i = 0; i < count; ++i) {
@@ -70,7 +70,8 @@ TEST(TupleType, Properties) {
   ndt::type tp =
       ndt::make_type<ndt::tuple_type>({ndt::make_type<int>(), ndt::make_type<dynd::string>(), ndt::make_type<float>()});
 
-  EXPECT_ARRAY_EQ((nd::array{3 * sizeof(size_t), 3 * sizeof(size_t), 3 * sizeof(size_t)}),
+  EXPECT_ARRAY_EQ((nd::array{3 * sizeof(size_t), 3 * sizeof(size_t),
+                              3 * sizeof(size_t) + sizeof(ndt::string_type::metadata_type)}),
                   tp.p<std::vector<uintptr_t>>("metadata_offsets"));
 }
 